@@ -0,0 +1,52 @@
+#include <vector>
+
+#include <Fever/PagedPersistentHandleDataStore.h>
+
+// The array create entry points reserve handle slots for the whole batch
+// before creating any objects. These benchmarks measure that part on its own,
+// with a store laid out like the Metal backend's object stores.
+namespace {
+typedef fv::PagedPersistentHandleDataStore<uint64_t, fv::Handle64>
+    BatchObjectStore;
+}
+
+// Create and destroy 'count' objects one at a time
+static void BM_BatchCreateSingle(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    std::vector<const fv::Handle64 *> handles(count);
+
+    for (auto _ : state) {
+        BatchObjectStore dataStore;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            handles[i] = dataStore.add(i);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            dataStore.remove(*handles[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchCreateSingle)->Arg(10000);
+
+// Create and destroy 'count' objects after reserving room for all of them
+static void BM_BatchCreateReserved(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    std::vector<const fv::Handle64 *> handles(count);
+
+    for (auto _ : state) {
+        BatchObjectStore dataStore;
+        dataStore.reserve(count);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            handles[i] = dataStore.add(i);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            dataStore.remove(*handles[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchCreateReserved)->Arg(10000);
@@ -0,0 +1,138 @@
+#include <vector>
+
+#include <Fever/BindingTable.h>
+#include <Fever/PagedPersistentHandleDataStore.h>
+
+// Binding a frame's worth of descriptor sets: 1024 binds spread over 256
+// descriptor sets, each with the given number of bindings, half of them
+// buffers and half images. The "encoder" only sums what it is given.
+
+namespace {
+typedef fv::PagedPersistentHandleDataStore<uintptr_t, fv::Handle64> ObjectStore;
+
+const uint32_t NUM_SETS  = 256;
+const uint32_t NUM_BINDS = 1024;
+
+// A descriptor set as it was kept before resolving, holding handles
+struct HandleSlot {
+    const fv::Handle64 *object;
+    const fv::Handle64 *sampler;
+    uint32_t binding;
+};
+
+struct HandleDescriptorSet {
+    std::vector<HandleSlot> buffers;
+    std::vector<HandleSlot> images;
+};
+
+typedef fv::BindingTable<uintptr_t, uintptr_t, uintptr_t> BenchBindingTable;
+
+// Objects the descriptor sets refer to, and the sets both ways
+struct DescriptorSets {
+    explicit DescriptorSets(uint32_t numBindings) {
+        for (uint32_t i = 0; i < NUM_SETS * numBindings; ++i) {
+            objectHandles.push_back(objects.add(i + 1));
+        }
+
+        tables.resize(NUM_SETS);
+
+        for (uint32_t set = 0; set < NUM_SETS; ++set) {
+            HandleDescriptorSet handleSet;
+
+            for (uint32_t binding = 0; binding < numBindings; ++binding) {
+                const size_t object =
+                    (set * 7919 + binding) % objectHandles.size();
+                const fv::Handle64 *handle = objectHandles[object];
+                const HandleSlot slot = {handle, handle, binding};
+
+                if (binding % 2 == 0) {
+                    handleSet.buffers.push_back(slot);
+                    tables[set].addBufferSlot(binding, FV_SHADER_STAGE_VERTEX);
+                    tables[set].setBuffer(binding, *objects.get(*handle), 0);
+                } else {
+                    handleSet.images.push_back(slot);
+                    tables[set].addImageSlot(binding, FV_SHADER_STAGE_FRAGMENT);
+                    tables[set].setImage(binding, *objects.get(*handle),
+                                         *objects.get(*handle));
+                }
+            }
+
+            setHandles.push_back(handleSets.add(handleSet));
+        }
+    }
+
+    ObjectStore objects;
+    std::vector<const fv::Handle64 *> objectHandles;
+
+    fv::PagedPersistentHandleDataStore<HandleDescriptorSet, fv::Handle64>
+        handleSets;
+    std::vector<const fv::Handle64 *> setHandles;
+
+    std::vector<BenchBindingTable> tables;
+};
+}
+
+// Look up the descriptor set and every object it binds at submit
+static void BM_BindDescriptorSetLookup(benchmark::State &state) {
+    const uint32_t numBindings = state.range(0);
+    DescriptorSets sets(numBindings);
+
+    for (auto _ : state) {
+        uintptr_t encoded = 0;
+
+        for (uint32_t i = 0; i < NUM_BINDS; ++i) {
+            const HandleDescriptorSet *set =
+                sets.handleSets.get(*sets.setHandles[(i * 31) % NUM_SETS]);
+
+            for (const HandleSlot &slot : set->buffers) {
+                const uintptr_t *buffer = sets.objects.get(*slot.object);
+                if (buffer != nullptr) {
+                    encoded += *buffer + slot.binding;
+                }
+            }
+            for (const HandleSlot &slot : set->images) {
+                const uintptr_t *texture = sets.objects.get(*slot.object);
+                const uintptr_t *sampler = sets.objects.get(*slot.sampler);
+                if (texture != nullptr && sampler != nullptr) {
+                    encoded += *texture + *sampler + slot.binding;
+                }
+            }
+        }
+
+        benchmark::DoNotOptimize(encoded);
+    }
+
+    state.SetItemsProcessed(state.iterations() * NUM_BINDS);
+}
+BENCHMARK(BM_BindDescriptorSetLookup)->RangeMultiplier(4)->Range(1, 64);
+
+// Walk binding tables resolved when the descriptor sets were updated
+static void BM_BindDescriptorSetResolved(benchmark::State &state) {
+    const uint32_t numBindings = state.range(0);
+    DescriptorSets sets(numBindings);
+
+    for (auto _ : state) {
+        uintptr_t encoded = 0;
+
+        for (uint32_t i = 0; i < NUM_BINDS; ++i) {
+            const BenchBindingTable &table = sets.tables[(i * 31) % NUM_SETS];
+
+            for (const BenchBindingTable::BufferSlot &slot :
+                 table.getBuffers()) {
+                if (slot.buffer != 0) {
+                    encoded += slot.buffer + slot.binding;
+                }
+            }
+            for (const BenchBindingTable::ImageSlot &slot : table.getImages()) {
+                if (slot.texture != 0) {
+                    encoded += slot.texture + slot.sampler + slot.binding;
+                }
+            }
+        }
+
+        benchmark::DoNotOptimize(encoded);
+    }
+
+    state.SetItemsProcessed(state.iterations() * NUM_BINDS);
+}
+BENCHMARK(BM_BindDescriptorSetResolved)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,188 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Fever/BindingCache.h>
+#include <Fever/CommandStream.h>
+
+// Cost per draw of recording and replaying a command stream the way a frame
+// would: each draw binds a vertex buffer and a descriptor set first.
+
+namespace {
+// Handle recorded for every object, the stream never looks it up.
+fv::CommandHandle benchHandle() {
+    fv::CommandHandle handle;
+    handle.id = 1;
+    return handle;
+}
+
+void recordFrame(fv::CommandStream &stream, uint32_t numDraws) {
+    fv::BindGraphicsPipelineCommand *bindPipeline =
+        stream.record<fv::BindGraphicsPipelineCommand>();
+    bindPipeline->graphicsPipeline = benchHandle();
+
+    for (uint32_t i = 0; i < numDraws; ++i) {
+        fv::BindVertexBufferCommand *bindVertexBuffer =
+            stream.record<fv::BindVertexBufferCommand>();
+        bindVertexBuffer->binding = 0;
+        bindVertexBuffer->buffer  = benchHandle();
+        bindVertexBuffer->offset  = i;
+
+        fv::BindDescriptorSetCommand *bindDescriptorSet =
+            stream.record<fv::BindDescriptorSetCommand>();
+        bindDescriptorSet->set           = 0;
+        bindDescriptorSet->descriptorSet = benchHandle();
+
+        fv::DrawIndexedCommand *draw = stream.record<fv::DrawIndexedCommand>();
+        draw->indexCount             = 36;
+        draw->instanceCount          = 1;
+        draw->firstIndex             = 0;
+        draw->vertexOffset           = 0;
+        draw->firstInstance          = 0;
+    }
+}
+}
+
+static void BM_CommandStreamRecord(benchmark::State &state) {
+    const uint32_t numDraws = state.range(0);
+    fv::CommandStream stream;
+
+    for (auto _ : state) {
+        stream.reset();
+        recordFrame(stream, numDraws);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numDraws);
+}
+BENCHMARK(BM_CommandStreamRecord)->Arg(1000)->Arg(100000);
+
+// The same frame recorded through a BindingCache, as command buffers do. Every
+// draw uses the same pipeline and descriptor set, so only the vertex buffer
+// binds and draws are recorded.
+static void BM_CommandStreamRecordFiltered(benchmark::State &state) {
+    const uint32_t numDraws = state.range(0);
+    fv::CommandStream stream;
+    fv::BindingCache bindings;
+
+    FvGraphicsPipeline pipeline   = (FvGraphicsPipeline)1;
+    FvDescriptorSet descriptorSet = (FvDescriptorSet)1;
+
+    for (auto _ : state) {
+        stream.reset();
+        bindings.reset();
+
+        for (uint32_t i = 0; i < numDraws; ++i) {
+            if (bindings.bindGraphicsPipeline(pipeline)) {
+                fv::BindGraphicsPipelineCommand *bindPipeline =
+                    stream.record<fv::BindGraphicsPipelineCommand>();
+                bindPipeline->graphicsPipeline = benchHandle();
+            }
+
+            if (bindings.bindVertexBuffer(0, nullptr, i)) {
+                fv::BindVertexBufferCommand *bindVertexBuffer =
+                    stream.record<fv::BindVertexBufferCommand>();
+                bindVertexBuffer->binding = 0;
+                bindVertexBuffer->buffer  = benchHandle();
+                bindVertexBuffer->offset  = i;
+            }
+
+            if (bindings.bindDescriptorSet(0, descriptorSet)) {
+                fv::BindDescriptorSetCommand *bindDescriptorSet =
+                    stream.record<fv::BindDescriptorSetCommand>();
+                bindDescriptorSet->set           = 0;
+                bindDescriptorSet->descriptorSet = benchHandle();
+            }
+
+            fv::DrawIndexedCommand *draw =
+                stream.record<fv::DrawIndexedCommand>();
+            draw->indexCount    = 36;
+            draw->instanceCount = 1;
+            draw->firstIndex    = 0;
+            draw->vertexOffset  = 0;
+            draw->firstInstance = 0;
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numDraws);
+    state.counters["commands"]     = stream.size();
+    state.counters["elided_binds"] = bindings.getNumElidedBinds();
+}
+BENCHMARK(BM_CommandStreamRecordFiltered)->Arg(1000)->Arg(100000);
+
+static void BM_CommandStreamReplay(benchmark::State &state) {
+    const uint32_t numDraws = state.range(0);
+    fv::CommandStream stream;
+    recordFrame(stream, numDraws);
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+
+        for (fv::CommandStream::const_iterator it = stream.begin();
+             it != stream.end(); ++it) {
+            switch (it->type) {
+            case fv::COMMAND_TYPE_BIND_VERTEX_BUFFER:
+                sum += it->as<fv::BindVertexBufferCommand>().offset;
+                break;
+            case fv::COMMAND_TYPE_DRAW_INDEXED:
+                sum += it->as<fv::DrawIndexedCommand>().indexCount;
+                break;
+            default:
+                break;
+            }
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numDraws);
+}
+BENCHMARK(BM_CommandStreamReplay)->Arg(1000)->Arg(100000);
+
+// A 100k draw frame split evenly between threads, each recording a secondary
+// stream with its own pool, stitched together by a primary stream. Threads
+// are started every frame, as a frame's recording jobs would be.
+static void BM_CommandStreamRecordParallel(benchmark::State &state) {
+    const uint32_t numThreads = state.range(0);
+    const uint32_t numDraws   = 100000;
+
+    std::vector<std::unique_ptr<fv::CommandBlockPool>> pools;
+    std::vector<fv::CommandStream> secondaries;
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        pools.push_back(std::unique_ptr<fv::CommandBlockPool>(
+            new fv::CommandBlockPool(fv::CommandStream::DEFAULT_BLOCK_SIZE)));
+        secondaries.push_back(fv::CommandStream(pools[t].get()));
+    }
+    fv::CommandStream primary;
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread([&secondaries, t, numThreads]() {
+                secondaries[t].reset();
+                recordFrame(secondaries[t], numDraws / numThreads);
+            }));
+        }
+
+        primary.reset();
+        for (uint32_t t = 0; t < numThreads; ++t) {
+            fv::ExecuteCommandsCommand *execute =
+                primary.record<fv::ExecuteCommandsCommand>();
+            execute->commandBuffer = benchHandle();
+        }
+
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numDraws);
+}
+BENCHMARK(BM_CommandStreamRecordParallel)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
@@ -0,0 +1,126 @@
+#include <mutex>
+#include <vector>
+
+#include <Fever/ConcurrentHandleDataStore.h>
+#include <Fever/HandleDataStore.h>
+
+namespace {
+const uint32_t CONCURRENT_BENCH_CAPACITY = 1 << 16;
+const uint32_t CONCURRENT_BENCH_LIVE     = 1024;
+
+// Single-threaded store guarded by a mutex, the simplest way to share the
+// existing HandleDataStore between loader threads.
+struct LockedHandleDataStore {
+    std::mutex mutex;
+    fv::HandleDataStore<uint32_t> dataStore;
+};
+
+LockedHandleDataStore &lockedStore() {
+    static LockedHandleDataStore store;
+    return store;
+}
+
+fv::ConcurrentHandleDataStore<uint32_t> &concurrentStore() {
+    static fv::ConcurrentHandleDataStore<uint32_t> store(
+        CONCURRENT_BENCH_CAPACITY);
+    return store;
+}
+}
+
+// Baseline: unsynchronized store, one thread only
+static void BM_HandleDataStoreAddRemove(benchmark::State &state) {
+    fv::HandleDataStore<uint32_t> dataStore;
+
+    for (auto _ : state) {
+        fv::Handle handle = dataStore.add(1);
+        dataStore.remove(handle);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandleDataStoreAddRemove);
+
+static void BM_LockedHandleDataStoreAddRemove(benchmark::State &state) {
+    LockedHandleDataStore &store = lockedStore();
+
+    for (auto _ : state) {
+        fv::Handle handle;
+        {
+            std::lock_guard<std::mutex> lock(store.mutex);
+            handle = store.dataStore.add(1);
+        }
+        {
+            std::lock_guard<std::mutex> lock(store.mutex);
+            store.dataStore.remove(handle);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedHandleDataStoreAddRemove)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentHandleDataStoreAddRemove(benchmark::State &state) {
+    fv::ConcurrentHandleDataStore<uint32_t> &dataStore = concurrentStore();
+
+    for (auto _ : state) {
+        fv::Handle handle;
+        dataStore.add(1, &handle);
+        dataStore.remove(handle);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentHandleDataStoreAddRemove)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+static void BM_LockedHandleDataStoreGet(benchmark::State &state) {
+    LockedHandleDataStore &store = lockedStore();
+    std::vector<fv::Handle> handles(CONCURRENT_BENCH_LIVE);
+
+    {
+        std::lock_guard<std::mutex> lock(store.mutex);
+        for (uint32_t i = 0; i < CONCURRENT_BENCH_LIVE; ++i) {
+            handles[i] = store.dataStore.add(i);
+        }
+    }
+
+    uint32_t next = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(store.mutex);
+        benchmark::DoNotOptimize(
+            store.dataStore.get(handles[next++ % CONCURRENT_BENCH_LIVE]));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(store.mutex);
+        for (uint32_t i = 0; i < CONCURRENT_BENCH_LIVE; ++i) {
+            store.dataStore.remove(handles[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedHandleDataStoreGet)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentHandleDataStoreGet(benchmark::State &state) {
+    fv::ConcurrentHandleDataStore<uint32_t> &dataStore = concurrentStore();
+    std::vector<fv::Handle> handles(CONCURRENT_BENCH_LIVE);
+
+    for (uint32_t i = 0; i < CONCURRENT_BENCH_LIVE; ++i) {
+        dataStore.add(i, &handles[i]);
+    }
+
+    uint32_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            dataStore.get(handles[next++ % CONCURRENT_BENCH_LIVE]));
+    }
+
+    for (uint32_t i = 0; i < CONCURRENT_BENCH_LIVE; ++i) {
+        dataStore.remove(handles[i]);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentHandleDataStoreGet)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,140 @@
+#include <vector>
+
+#include <Fever/HandleDataStore.h>
+#include <Fever/PagedPersistentHandleDataStore.h>
+#include <Fever/PersistentHandleDataStore.h>
+
+// Throughput of filling, emptying and churning the single-threaded stores at
+// several sizes.
+
+namespace {
+// Cheap deterministic random numbers, so every run churns the same way.
+uint32_t nextRandom(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Construct a store big enough for 'count' objects.
+template <typename Store> struct StoreFactory {
+    static Store *create(uint32_t /*count*/) { return new Store(); }
+};
+template <typename T> struct StoreFactory<fv::PersistentHandleDataStore<T>> {
+    static fv::PersistentHandleDataStore<T> *create(uint32_t count) {
+        return new fv::PersistentHandleDataStore<T>(count);
+    }
+};
+
+// The persistent stores hand out pointers to their handles.
+template <typename HandleType> HandleType toHandle(HandleType handle) {
+    return handle;
+}
+template <typename HandleType> HandleType toHandle(const HandleType *handle) {
+    return *handle;
+}
+}
+
+// Add 'count' objects to an empty store
+template <typename Store>
+static void BM_StoreAdd(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Store *dataStore = StoreFactory<Store>::create(count);
+        state.ResumeTiming();
+
+        for (uint32_t i = 0; i < count; ++i) {
+            benchmark::DoNotOptimize(dataStore->add(i));
+        }
+
+        state.PauseTiming();
+        delete dataStore;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_StoreAdd, fv::HandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreAdd, fv::PersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreAdd, fv::PagedPersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+
+// Remove 'count' objects, in the order they were added, from a full store
+template <typename Store>
+static void BM_StoreRemove(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    std::vector<fv::Handle> handles(count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Store *dataStore = StoreFactory<Store>::create(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            handles[i] = toHandle(dataStore->add(i));
+        }
+        state.ResumeTiming();
+
+        for (uint32_t i = 0; i < count; ++i) {
+            dataStore->remove(handles[i]);
+        }
+
+        state.PauseTiming();
+        delete dataStore;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_StoreRemove, fv::HandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreRemove, fv::PersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreRemove, fv::PagedPersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+
+// Keep 'count' objects live while replacing randomly chosen ones, the way
+// streamed resources come and go. Each iteration removes one object, adds one
+// and looks one up.
+template <typename Store>
+static void BM_StoreChurn(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    Store *dataStore     = StoreFactory<Store>::create(count + 1);
+    std::vector<fv::Handle> handles(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = toHandle(dataStore->add(i));
+    }
+
+    uint32_t random = 0x9E3779B9;
+    for (auto _ : state) {
+        const uint32_t victim = nextRandom(random) % count;
+
+        dataStore->remove(handles[victim]);
+        handles[victim] = toHandle(dataStore->add(victim));
+
+        benchmark::DoNotOptimize(
+            dataStore->get(handles[nextRandom(random) % count]));
+    }
+
+    delete dataStore;
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_StoreChurn, fv::HandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreChurn, fv::PersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(BM_StoreChurn, fv::PagedPersistentHandleDataStore<uint32_t>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
@@ -0,0 +1,83 @@
+#include <vector>
+
+#include <Fever/Handle.h>
+#include <Fever/HandleDataStore.h>
+#include <Fever/PagedPersistentHandleDataStore.h>
+
+// Compare lookups through the compact 32-bit Handle and the 64-bit Handle64.
+
+template <typename HandleType>
+static void BM_HandleDataStoreIsValid(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::HandleDataStore<uint32_t, HandleType> dataStore;
+    std::vector<HandleType> handles(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.isValid(handles[i]));
+        i = (i + 7919) % count;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_HandleDataStoreIsValid, fv::Handle)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HandleDataStoreIsValid, fv::Handle64)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+
+template <typename HandleType>
+static void BM_HandleDataStoreGet(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::HandleDataStore<uint32_t, HandleType> dataStore;
+    std::vector<HandleType> handles(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.get(handles[i]));
+        i = (i + 7919) % count;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_HandleDataStoreGet, fv::Handle)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HandleDataStoreGet, fv::Handle64)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+
+// Lookups the way the backend does them: through a pointer to a paged handle
+template <typename HandleType>
+static void BM_PagedPersistentHandleDataStoreGet(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PagedPersistentHandleDataStore<uint32_t, HandleType> dataStore;
+    std::vector<const HandleType *> handles(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.get(*handles[i]));
+        i = (i + 7919) % count;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PagedPersistentHandleDataStoreGet, fv::Handle)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PagedPersistentHandleDataStoreGet, fv::Handle64)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
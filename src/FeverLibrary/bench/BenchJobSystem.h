@@ -0,0 +1,67 @@
+#include <cmath>
+#include <vector>
+
+#include <Fever/JobSystem.h>
+
+// How parallel fors scale with the number of workers, and what running a job
+// costs. Run on a machine with at least as many cores as the largest worker
+// count plus one for the scaling to show, e.g.
+//   FeverBench --benchmark_filter=JobSystem
+
+namespace {
+// Work for one index, standing in for transforming a vertex or decoding a
+// block of a texture
+float work(uint32_t index) {
+    float value = (float)index;
+    for (int i = 0; i < 64; ++i) {
+        value = std::sqrt(value + 1.0f) * 1.5f;
+    }
+
+    return value;
+}
+}
+
+// The same parallel for over 2^16 indices, with 0 (the caller alone) to 8
+// workers helping the caller
+static void BM_JobSystemParallelForScaling(benchmark::State &state) {
+    const uint32_t COUNT = 1 << 16;
+
+    fv::JobSystem jobs((uint32_t)state.range(0));
+    std::vector<float> results(COUNT);
+
+    for (auto _ : state) {
+        jobs.parallelFor(COUNT, 256, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                results[i] = work(i);
+            }
+        });
+        benchmark::DoNotOptimize(results.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_JobSystemParallelForScaling)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+// Running and waiting for 1024 empty jobs, from the application's thread
+static void BM_JobSystemRunOverhead(benchmark::State &state) {
+    const int NUM_JOBS = 1024;
+
+    fv::JobSystem jobs((uint32_t)state.range(0));
+    fv::JobCounter counter;
+
+    for (auto _ : state) {
+        for (int i = 0; i < NUM_JOBS; ++i) {
+            jobs.run([]() {}, &counter);
+        }
+        jobs.wait(counter);
+    }
+
+    state.SetItemsProcessed(state.iterations() * NUM_JOBS);
+}
+BENCHMARK(BM_JobSystemRunOverhead)->Arg(0)->Arg(2)->UseRealTime();
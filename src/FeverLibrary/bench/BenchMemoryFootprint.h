@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <Fever/HandleDataStore.h>
+#include <Fever/PackedHandleDataStore.h>
+#include <Fever/PagedPersistentHandleDataStore.h>
+#include <Fever/PersistentHandleDataStore.h>
+
+// Heap bytes each store uses per live object, reported in the
+// 'bytes_per_object' counter. Half of the objects are removed again before
+// measuring, so stores that keep the memory of removed objects show it.
+//
+// Measured through glibc's allocator statistics, elsewhere these benchmarks
+// report an error instead.
+
+#if defined(__GLIBC__) &&                                                      \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define FV_BENCH_HAS_HEAP_USAGE 1
+#endif
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace {
+// Roughly the size of a backend wrapper object.
+struct FootprintBenchObject {
+    float data[16];
+};
+
+// Get the number of heap bytes currently allocated, including large blocks
+// the allocator maps separately.
+size_t heapBytesInUse() {
+#ifdef FV_BENCH_HAS_HEAP_USAGE
+    const struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// Get the peak resident set size of the process so far, in KiB.
+long peakRssKilobytes() {
+#ifdef __linux__
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+}
+
+template <typename Store>
+static void BM_StoreMemoryFootprint(benchmark::State &state) {
+#ifndef FV_BENCH_HAS_HEAP_USAGE
+    state.SkipWithError("Heap usage is only available with glibc.");
+    return;
+#endif
+
+    const uint32_t count = state.range(0);
+    std::vector<fv::Handle> handles(count);
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        const size_t before = heapBytesInUse();
+        Store *dataStore    = StoreFactory<Store>::create(count);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            handles[i] = toHandle(dataStore->add(FootprintBenchObject()));
+        }
+        for (uint32_t i = 0; i < count; i += 2) {
+            dataStore->remove(handles[i]);
+        }
+
+        bytes = heapBytesInUse() - before;
+        delete dataStore;
+    }
+
+    state.counters["bytes_per_object"] = (double)bytes / (count / 2);
+}
+BENCHMARK_TEMPLATE(BM_StoreMemoryFootprint,
+                   fv::HandleDataStore<FootprintBenchObject>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20)
+    ->Iterations(1);
+BENCHMARK_TEMPLATE(BM_StoreMemoryFootprint,
+                   fv::PersistentHandleDataStore<FootprintBenchObject>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20)
+    ->Iterations(1);
+BENCHMARK_TEMPLATE(BM_StoreMemoryFootprint,
+                   fv::PagedPersistentHandleDataStore<FootprintBenchObject>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20)
+    ->Iterations(1);
+BENCHMARK_TEMPLATE(BM_StoreMemoryFootprint,
+                   fv::PackedHandleDataStore<FootprintBenchObject>)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20)
+    ->Iterations(1);
+
+// Peak memory while creating and destroying 1 MiB objects in two stores one
+// after the other, the way a scene swaps out its textures for new buffers.
+// 'peak_heap_mib' should stay near one set, 64 MiB, as removed objects are
+// destroyed right away. 'peak_rss_rise_mib' is the rise of the process' peak
+// RSS, which earlier benchmarks may already have raised, so run this one on
+// its own with --benchmark_filter for it to mean anything.
+static void BM_HandleDataStoreChurnPeakMemory(benchmark::State &state) {
+#ifndef FV_BENCH_HAS_HEAP_USAGE
+    state.SkipWithError("Heap usage is only available with glibc.");
+    return;
+#endif
+
+    const uint32_t numObjects = 64;
+    const size_t objectBytes  = 1024 * 1024;
+    std::vector<fv::Handle> handles;
+    size_t peakBytes = 0;
+    long peakRssRise = 0;
+
+    for (auto _ : state) {
+        const size_t before      = heapBytesInUse();
+        const long peakRssBefore = peakRssKilobytes();
+
+        fv::HandleDataStore<std::vector<char>> textures;
+        fv::HandleDataStore<std::vector<char>> buffers;
+
+        for (uint32_t round = 0; round < 4; ++round) {
+            fv::HandleDataStore<std::vector<char>> &dataStore =
+                (round % 2 == 0) ? textures : buffers;
+
+            handles.clear();
+            for (uint32_t i = 0; i < numObjects; ++i) {
+                handles.push_back(dataStore.emplace(objectBytes, (char)round));
+            }
+            peakBytes = std::max(peakBytes, heapBytesInUse() - before);
+
+            for (uint32_t i = 0; i < numObjects; ++i) {
+                dataStore.remove(handles[i]);
+            }
+        }
+
+        peakRssRise = peakRssKilobytes() - peakRssBefore;
+    }
+
+    state.counters["peak_heap_mib"]     = (double)peakBytes / (1024 * 1024);
+    state.counters["peak_rss_rise_mib"] = (double)peakRssRise / 1024;
+}
+BENCHMARK(BM_HandleDataStoreChurnPeakMemory)->Iterations(1);
@@ -0,0 +1,122 @@
+#include <vector>
+
+#include <Fever/HandleDataStore.h>
+#include <Fever/PackedHandleDataStore.h>
+
+// Compare the HandleDataStore, which leaves holes at removed objects, with the
+// PackedHandleDataStore. Each store is filled with 'count' objects of which
+// every other one is then removed.
+
+namespace {
+// Roughly the size of a backend wrapper object.
+struct PackedBenchObject {
+    float data[16];
+};
+
+template <typename Store, typename HandleType>
+void fillHalfLive(Store &dataStore, uint32_t count,
+                  std::vector<HandleType> &liveHandles) {
+    std::vector<HandleType> handles(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(PackedBenchObject());
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            dataStore.remove(handles[i]);
+        } else {
+            liveHandles.push_back(handles[i]);
+        }
+    }
+}
+}
+
+// Visiting every live object of a HandleDataStore means walking every slot.
+static void BM_HandleDataStoreIterate(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::HandleDataStore<PackedBenchObject> dataStore;
+    std::vector<fv::Handle> liveHandles;
+    fillHalfLive(dataStore, count, liveHandles);
+
+    // Handles to every slot, as a walk over the whole store would produce
+    std::vector<fv::Handle> slotHandles(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        slotHandles[i].id = i;
+    }
+    for (size_t i = 0; i < liveHandles.size(); ++i) {
+        slotHandles[liveHandles[i].getIndex()] = liveHandles[i];
+    }
+
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < count; ++i) {
+            const PackedBenchObject *object = dataStore.get(slotHandles[i]);
+            if (object != nullptr) {
+                sum += object->data[0];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * liveHandles.size());
+}
+BENCHMARK(BM_HandleDataStoreIterate)->RangeMultiplier(16)->Range(256, 1 << 20);
+
+static void BM_PackedHandleDataStoreIterate(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PackedHandleDataStore<PackedBenchObject> dataStore;
+    std::vector<fv::Handle> liveHandles;
+    fillHalfLive(dataStore, count, liveHandles);
+
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (const PackedBenchObject &object : dataStore) {
+            sum += object.data[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * liveHandles.size());
+}
+BENCHMARK(BM_PackedHandleDataStoreIterate)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+
+static void BM_HandleDataStoreRandomGet(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::HandleDataStore<PackedBenchObject> dataStore;
+    std::vector<fv::Handle> liveHandles;
+    fillHalfLive(dataStore, count, liveHandles);
+
+    const uint32_t numLive = liveHandles.size();
+    uint32_t i             = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.get(liveHandles[i]));
+        i = (i + 7919) % numLive;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandleDataStoreRandomGet)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+
+static void BM_PackedHandleDataStoreRandomGet(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PackedHandleDataStore<PackedBenchObject> dataStore;
+    std::vector<fv::Handle> liveHandles;
+    fillHalfLive(dataStore, count, liveHandles);
+
+    const uint32_t numLive = liveHandles.size();
+    uint32_t i             = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.get(liveHandles[i]));
+        i = (i + 7919) % numLive;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PackedHandleDataStoreRandomGet)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
@@ -0,0 +1,77 @@
+#include <vector>
+
+#include <Fever/PersistentHandleDataStore.h>
+
+namespace {
+// Fill a persistent data store with 'count' live handles.
+void fillPersistentStore(fv::PersistentHandleDataStore<uint32_t> &dataStore,
+                         uint32_t count,
+                         std::vector<const fv::Handle *> &handles) {
+    handles.resize(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+}
+
+// Visit live handles in a scattered but deterministic order.
+uint32_t nextScatteredIndex(uint32_t previous, uint32_t count) {
+    return (previous + 7919) % count;
+}
+}
+
+static void BM_PersistentHandleDataStoreIsValid(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PersistentHandleDataStore<uint32_t> dataStore(count);
+    std::vector<const fv::Handle *> handles;
+    fillPersistentStore(dataStore, count, handles);
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.isValid(*handles[i]));
+        i = nextScatteredIndex(i, count);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PersistentHandleDataStoreIsValid)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+
+static void BM_PersistentHandleDataStoreGet(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PersistentHandleDataStore<uint32_t> dataStore(count);
+    std::vector<const fv::Handle *> handles;
+    fillPersistentStore(dataStore, count, handles);
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dataStore.get(*handles[i]));
+        i = nextScatteredIndex(i, count);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PersistentHandleDataStoreGet)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
+
+// Destroy and re-create one object while 'count' others stay live
+static void BM_PersistentHandleDataStoreRemoveAdd(benchmark::State &state) {
+    const uint32_t count = state.range(0);
+    fv::PersistentHandleDataStore<uint32_t> dataStore(count);
+    std::vector<const fv::Handle *> handles;
+    fillPersistentStore(dataStore, count, handles);
+
+    uint32_t i = 0;
+    for (auto _ : state) {
+        dataStore.remove(*handles[i]);
+        handles[i] = dataStore.add(i);
+        i          = nextScatteredIndex(i, count);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PersistentHandleDataStoreRemoveAdd)
+    ->RangeMultiplier(16)
+    ->Range(16, 1 << 20);
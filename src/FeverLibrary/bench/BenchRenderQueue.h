@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <Fever/RenderQueue.h>
+
+// Sorting a frame's worth of draws: 64 pipelines, 1024 descriptor sets and
+// vertex buffers, draws added in random order at random depths.
+
+namespace {
+std::vector<uint64_t> makeFrameKeys(uint32_t numItems) {
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+    std::vector<uint64_t> keys;
+    keys.reserve(numItems);
+
+    for (uint32_t i = 0; i < numItems; ++i) {
+        keys.push_back(fv::RenderQueue::makeSortKey(
+            random() % 64, random() % 1024, random() % 1024, depth(random)));
+    }
+
+    return keys;
+}
+}
+
+// Add a frame of draws and radix sort them
+static void BM_RenderQueueSort(benchmark::State &state) {
+    const uint32_t numItems          = state.range(0);
+    const std::vector<uint64_t> keys = makeFrameKeys(numItems);
+
+    fv::RenderQueue queue;
+    queue.reserve(numItems);
+
+    fv::DrawItem item = {};
+
+    for (auto _ : state) {
+        queue.clear();
+        for (uint32_t i = 0; i < numItems; ++i) {
+            queue.add(keys[i], item);
+        }
+        queue.sort();
+
+        benchmark::DoNotOptimize(queue.getSortedKey(0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * numItems);
+}
+BENCHMARK(BM_RenderQueueSort)->Arg(1000)->Arg(100000);
+
+// Baseline: the same key and index pairs sorted with std::sort
+static void BM_RenderQueueStdSort(benchmark::State &state) {
+    const uint32_t numItems          = state.range(0);
+    const std::vector<uint64_t> keys = makeFrameKeys(numItems);
+
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(numItems);
+
+    for (auto _ : state) {
+        entries.clear();
+        for (uint32_t i = 0; i < numItems; ++i) {
+            entries.push_back(std::make_pair(keys[i], i));
+        }
+        std::sort(entries.begin(), entries.end());
+
+        benchmark::DoNotOptimize(entries[0]);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numItems);
+}
+BENCHMARK(BM_RenderQueueStdSort)->Arg(1000)->Arg(100000);
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <vector>
+
+#include <Fever/SubmitThread.h>
+
+// Time the caller spends in a queue submit, made on the calling thread or
+// handed to a submit thread. Making a submission is simulated by spinning for
+// the given number of microseconds, standing in for waiting on semaphores,
+// encoding and committing.
+
+namespace {
+// Keep the ring from filling up, so pushes measure the copy alone
+const uint32_t PUSHES_PER_FLUSH = fv::SubmitThread::DEFAULT_CAPACITY / 2;
+
+// Spin for the time making a submission takes
+void makeSubmission(int64_t microseconds) {
+    const auto end = std::chrono::steady_clock::now() +
+                     std::chrono::microseconds(microseconds);
+
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// A frame's submission: four command buffers, waiting for the image and
+// signaling render finished
+struct FrameSubmission {
+    FrameSubmission() {
+        for (uintptr_t i = 0; i < 4; ++i) {
+            commandBuffers.push_back((FvCommandBuffer)(i + 1));
+        }
+        imageAvailable = (FvSemaphore)5;
+        renderFinished = (FvSemaphore)6;
+
+        info                      = {};
+        info.waitSemaphoreCount   = 1;
+        info.waitSemaphores       = &imageAvailable;
+        info.commandBufferCount   = (uint32_t)commandBuffers.size();
+        info.commandBuffers       = commandBuffers.data();
+        info.signalSemaphoreCount = 1;
+        info.signalSemaphores     = &renderFinished;
+    }
+
+    std::vector<FvCommandBuffer> commandBuffers;
+    FvSemaphore imageAvailable;
+    FvSemaphore renderFinished;
+    FvSubmitInfo info;
+};
+}
+
+// Make the submission before returning
+static void BM_QueueSubmitSynchronous(benchmark::State &state) {
+    const int64_t submitMicroseconds = state.range(0);
+    FrameSubmission submission;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(submission.info.commandBuffers);
+        makeSubmission(submitMicroseconds);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueueSubmitSynchronous)->Arg(10)->Arg(100);
+
+// Copy the submission into the ring and return
+static void BM_QueueSubmitAsynchronous(benchmark::State &state) {
+    const int64_t submitMicroseconds = state.range(0);
+    FrameSubmission submission;
+
+    fv::SubmitThread thread([submitMicroseconds](const fv::SubmitBatch &) {
+        makeSubmission(submitMicroseconds);
+    });
+
+    uint64_t serial = 0;
+
+    for (auto _ : state) {
+        thread.push(1, &submission.info, nullptr, ++serial);
+
+        if (serial % PUSHES_PER_FLUSH == 0) {
+            state.PauseTiming();
+            thread.flush();
+            state.ResumeTiming();
+        }
+    }
+
+    thread.flush();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueueSubmitAsynchronous)->Arg(10)->Arg(100);
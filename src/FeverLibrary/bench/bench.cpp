@@ -0,0 +1,26 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchBatchCreate.h"
+#include "BenchBindingTable.h"
+#include "BenchCommandStream.h"
+#include "BenchConcurrentHandleDataStore.h"
+#include "BenchHandleDataStore.h"
+#include "BenchHandleLayout.h"
+#include "BenchJobSystem.h"
+#include "BenchMemoryFootprint.h"
+#include "BenchPackedHandleDataStore.h"
+#include "BenchPersistentHandleDataStore.h"
+#include "BenchRenderQueue.h"
+#include "BenchSubmitThread.h"
+
+int main(int argc, char **argv) {
+    ::benchmark::Initialize(&argc, argv);
+
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    ::benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
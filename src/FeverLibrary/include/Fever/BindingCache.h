@@ -0,0 +1,111 @@
+/*===-- Fever/BindingCache.h - Redundant bind filter --------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Tracks the state bound by a command buffer so that binds which
+ * wouldn't change anything can be dropped while recording.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstdint>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * The bindings made by the commands recorded into a command buffer so far.
+ *
+ * Each 'bind' function updates the cache and returns whether the bind
+ * changes anything. Binds returning false don't need to be recorded and are
+ * counted as elided.
+ *
+ * Vertex buffer bindings and descriptor sets past the tracked maximum, and
+ * descriptor sets bound with dynamic offsets, are never elided.
+ */
+class BindingCache {
+  public:
+    /** Number of vertex buffer bindings tracked. */
+    static const uint32_t MAX_VERTEX_BUFFERS = 32;
+
+    /** Number of descriptor sets tracked. */
+    static const uint32_t MAX_DESCRIPTOR_SETS = 8;
+
+    BindingCache();
+
+    /**
+     * \return False if the graphics pipeline is already bound.
+     */
+    bool bindGraphicsPipeline(FvGraphicsPipeline graphicsPipeline);
+
+    /**
+     * \return False if the buffer is already bound to the binding at the
+     *         same offset.
+     */
+    bool bindVertexBuffer(uint32_t binding, FvBuffer buffer, FvSize offset);
+
+    /**
+     * \return False if the buffer is already bound as the index buffer at the
+     *         same offset and with the same index type.
+     */
+    bool bindIndexBuffer(FvBuffer buffer, FvSize offset, FvIndexType indexType);
+
+    /**
+     * \param hasDynamicOffsets Whether the bind gives dynamic offsets, which
+     *                          may differ from those last given, so the bind
+     *                          is never elided.
+     * \return False if the descriptor set is already bound to the set.
+     */
+    bool bindDescriptorSet(uint32_t set, FvDescriptorSet descriptorSet,
+                           bool hasDynamicOffsets = false);
+
+    /**
+     * Forget what is bound, keeping the counts. Needed after any command that
+     * binds state behind the cache's back, e.g. executing secondary command
+     * buffers.
+     */
+    void invalidate();
+
+    /**
+     * Forget what is bound and reset the counts, e.g. when the command buffer
+     * is reset.
+     */
+    void reset();
+
+    /**
+     * Get the number of binds asked for since the last reset.
+     */
+    uint32_t getNumBinds() const { return numBinds; }
+
+    /**
+     * Get the number of binds elided since the last reset.
+     */
+    uint32_t getNumElidedBinds() const { return numElidedBinds; }
+
+  private:
+    /**
+     * Count a bind.
+     *
+     * \return \p changed
+     */
+    bool count(bool changed);
+
+    FvGraphicsPipeline graphicsPipeline;
+
+    FvBuffer vertexBuffers[MAX_VERTEX_BUFFERS];
+    FvSize vertexBufferOffsets[MAX_VERTEX_BUFFERS];
+
+    FvBuffer indexBuffer;
+    FvSize indexBufferOffset;
+    FvIndexType indexType;
+
+    FvDescriptorSet descriptorSets[MAX_DESCRIPTOR_SETS];
+
+    uint32_t numBinds;
+    uint32_t numElidedBinds;
+};
+}
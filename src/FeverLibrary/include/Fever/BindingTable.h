@@ -0,0 +1,107 @@
+/*===-- Fever/BindingTable.h - Resolved descriptor bindings -------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Descriptor set bindings resolved to backend objects, so binding a
+ * descriptor set doesn't look up any handles.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * The buffers and images of a descriptor set, as the backend objects they
+ * were resolved to when the descriptor set was updated.
+ *
+ * Slots are added when the descriptor set is created and start out unbound,
+ * holding value-initialized objects. Updates look up their handles once and
+ * store the result, so setting the descriptor set on an encoder only walks
+ * the flat slot arrays.
+ *
+ * \tparam Buffer  Backend buffer, e.g. id<MTLBuffer>.
+ * \tparam Texture Backend texture, e.g. id<MTLTexture>.
+ * \tparam Sampler Backend sampler, e.g. id<MTLSamplerState>.
+ */
+template <typename Buffer, typename Texture, typename Sampler>
+class BindingTable {
+  public:
+    struct BufferSlot {
+        Buffer buffer;
+        FvSize offset;
+        /** Binding point in the shader. */
+        uint32_t binding;
+        /** Bitmask of FvShaderStage the buffer is bound to. */
+        int stageFlags;
+        /** Whether the offset given when binding is added to 'offset'. */
+        bool dynamic;
+        /** Which of the offsets given when binding is added, the slot's rank
+         * by binding point among the dynamic slots. */
+        uint32_t dynamicIndex;
+    };
+
+    struct ImageSlot {
+        Texture texture;
+        Sampler sampler;
+        /** Binding point in the shader. */
+        uint32_t binding;
+        /** Bitmask of FvShaderStage the image is bound to. */
+        int stageFlags;
+    };
+
+    BindingTable() : numDynamicBuffers(0) {}
+
+    /**
+     * Add an unbound buffer slot.
+     *
+     * \param dynamic Whether an offset is given for the slot each time the
+     *                descriptor set is bound, as for
+     *                FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC.
+     */
+    void addBufferSlot(uint32_t binding, int stageFlags, bool dynamic = false);
+
+    /**
+     * Add an unbound image slot.
+     */
+    void addImageSlot(uint32_t binding, int stageFlags);
+
+    /**
+     * Bind a buffer to the buffer slot at the given binding point.
+     *
+     * \return False if there is no buffer slot at \p binding.
+     */
+    bool setBuffer(uint32_t binding, Buffer buffer, FvSize offset);
+
+    /**
+     * Bind a texture and sampler to the image slot at the given binding point.
+     *
+     * \return False if there is no image slot at \p binding.
+     */
+    bool setImage(uint32_t binding, Texture texture, Sampler sampler);
+
+    const std::vector<BufferSlot> &getBuffers() const { return buffers; }
+
+    const std::vector<ImageSlot> &getImages() const { return images; }
+
+    /**
+     * Get the number of offsets to give when binding the descriptor set, one
+     * per dynamic buffer slot, ordered by binding point.
+     */
+    uint32_t getNumDynamicBuffers() const { return numDynamicBuffers; }
+
+  private:
+    std::vector<BufferSlot> buffers;
+    std::vector<ImageSlot> images;
+    uint32_t numDynamicBuffers;
+};
+}
+
+#include <Fever/BindingTable.hpp>
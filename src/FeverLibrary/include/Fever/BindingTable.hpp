@@ -0,0 +1,79 @@
+#include <Fever/BindingTable.h>
+
+namespace fv {
+template <typename Buffer, typename Texture, typename Sampler>
+void BindingTable<Buffer, Texture, Sampler>::addBufferSlot(uint32_t binding,
+                                                           int stageFlags,
+                                                           bool dynamic) {
+    BufferSlot slot;
+    slot.buffer       = Buffer();
+    slot.offset       = 0;
+    slot.binding      = binding;
+    slot.stageFlags   = stageFlags;
+    slot.dynamic      = dynamic;
+    slot.dynamicIndex = 0;
+
+    if (dynamic) {
+        // Offsets are given in binding order, whatever order the slots were
+        // added in, so rank the new slot among the other dynamic slots
+        for (BufferSlot &other : buffers) {
+            if (!other.dynamic) {
+                continue;
+            }
+
+            if (other.binding < binding) {
+                ++slot.dynamicIndex;
+            } else {
+                ++other.dynamicIndex;
+            }
+        }
+
+        ++numDynamicBuffers;
+    }
+
+    buffers.push_back(slot);
+}
+
+template <typename Buffer, typename Texture, typename Sampler>
+void BindingTable<Buffer, Texture, Sampler>::addImageSlot(uint32_t binding,
+                                                          int stageFlags) {
+    ImageSlot slot;
+    slot.texture    = Texture();
+    slot.sampler    = Sampler();
+    slot.binding    = binding;
+    slot.stageFlags = stageFlags;
+
+    images.push_back(slot);
+}
+
+template <typename Buffer, typename Texture, typename Sampler>
+bool BindingTable<Buffer, Texture, Sampler>::setBuffer(uint32_t binding,
+                                                       Buffer buffer,
+                                                       FvSize offset) {
+    // Descriptor sets hold a handful of slots, a linear search is fastest
+    for (BufferSlot &slot : buffers) {
+        if (slot.binding == binding) {
+            slot.buffer = buffer;
+            slot.offset = offset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Buffer, typename Texture, typename Sampler>
+bool BindingTable<Buffer, Texture, Sampler>::setImage(uint32_t binding,
+                                                      Texture texture,
+                                                      Sampler sampler) {
+    for (ImageSlot &slot : images) {
+        if (slot.binding == binding) {
+            slot.texture = texture;
+            slot.sampler = sampler;
+            return true;
+        }
+    }
+
+    return false;
+}
+}
@@ -0,0 +1,420 @@
+/*===-- Fever/CommandStream.h - Recorded commands -----------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Backend independent list of commands recorded into a command buffer.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <Fever/Fever.h>
+#include <Fever/Handle.h>
+
+namespace fv {
+typedef enum CommandType {
+    COMMAND_TYPE_BIND_GRAPHICS_PIPELINE,
+    COMMAND_TYPE_BIND_VERTEX_BUFFER,
+    COMMAND_TYPE_BIND_INDEX_BUFFER,
+    COMMAND_TYPE_BIND_DESCRIPTOR_SET,
+    COMMAND_TYPE_DRAW,
+    COMMAND_TYPE_DRAW_INDEXED,
+    COMMAND_TYPE_DRAW_INDIRECT,
+    COMMAND_TYPE_DRAW_INDEXED_INDIRECT,
+    COMMAND_TYPE_PUSH_CONSTANTS,
+    COMMAND_TYPE_EXECUTE_COMMANDS,
+    COMMAND_TYPE_COPY_BUFFER,
+    COMMAND_TYPE_COPY_BUFFER_TO_IMAGE,
+} CommandType;
+
+/**
+ * Handle of an object used by a command, copied out of the backend's store
+ * when recording.
+ *
+ * Fv handles point into the backend's stores, which may free that memory
+ * once the object is destroyed. Commands keep the handle itself, which
+ * replaying looks up, so objects destroyed since recording are skipped.
+ */
+typedef Handle64 CommandHandle;
+
+/**
+ * Start of every command in a CommandStream.
+ */
+struct CommandHeader {
+    /** CommandType of the command. */
+    uint16_t type;
+    /** Size of the whole command in bytes, including this header. */
+    uint16_t size;
+
+    /**
+     * Get the command this header starts.
+     *
+     * \pre \p Command is the type of command given by 'type'.
+     */
+    template <typename Command> const Command &as() const {
+        return *reinterpret_cast<const Command *>(this);
+    }
+};
+
+/**
+ * Get the bytes recorded right after a command, see
+ * 'CommandStream::record(size_t)'.
+ */
+template <typename Command> void *getPayload(Command *command) {
+    return reinterpret_cast<uint8_t *>(command) + sizeof(Command);
+}
+
+template <typename Command> const void *getPayload(const Command &command) {
+    return reinterpret_cast<const uint8_t *>(&command) + sizeof(Command);
+}
+
+// Each command starts with its header and names its CommandType in 'TYPE'.
+
+struct BindGraphicsPipelineCommand {
+    static const CommandType TYPE = COMMAND_TYPE_BIND_GRAPHICS_PIPELINE;
+
+    CommandHeader header;
+    CommandHandle graphicsPipeline;
+};
+
+struct BindVertexBufferCommand {
+    static const CommandType TYPE = COMMAND_TYPE_BIND_VERTEX_BUFFER;
+
+    CommandHeader header;
+    uint32_t binding;
+    CommandHandle buffer;
+    FvSize offset;
+};
+
+struct BindIndexBufferCommand {
+    static const CommandType TYPE = COMMAND_TYPE_BIND_INDEX_BUFFER;
+
+    CommandHeader header;
+    FvIndexType indexType;
+    CommandHandle buffer;
+    FvSize offset;
+};
+
+/**
+ * Followed by 'dynamicOffsetCount' uint32_t dynamic offsets, see
+ * 'getPayload'.
+ */
+struct BindDescriptorSetCommand {
+    static const CommandType TYPE = COMMAND_TYPE_BIND_DESCRIPTOR_SET;
+
+    CommandHeader header;
+    uint32_t set;
+    CommandHandle descriptorSet;
+    /** What the backend resolved the descriptor set to when recording, so
+     * replaying only checks 'descriptorSet' is still valid. Must not move
+     * while the descriptor set lives. */
+    const void *resolvedSet;
+    uint32_t dynamicOffsetCount;
+};
+
+struct DrawCommand {
+    static const CommandType TYPE = COMMAND_TYPE_DRAW;
+
+    CommandHeader header;
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+
+struct DrawIndexedCommand {
+    static const CommandType TYPE = COMMAND_TYPE_DRAW_INDEXED;
+
+    CommandHeader header;
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+struct DrawIndirectCommand {
+    static const CommandType TYPE = COMMAND_TYPE_DRAW_INDIRECT;
+
+    CommandHeader header;
+    CommandHandle buffer;
+    FvSize offset;
+    uint32_t drawCount;
+    uint32_t stride;
+};
+
+struct DrawIndexedIndirectCommand {
+    static const CommandType TYPE = COMMAND_TYPE_DRAW_INDEXED_INDIRECT;
+
+    CommandHeader header;
+    CommandHandle buffer;
+    FvSize offset;
+    uint32_t drawCount;
+    uint32_t stride;
+};
+
+/**
+ * Followed by 'size' bytes of push constant data, see 'getPayload'.
+ */
+struct PushConstantsCommand {
+    static const CommandType TYPE = COMMAND_TYPE_PUSH_CONSTANTS;
+
+    CommandHeader header;
+    CommandHandle layout;
+    int stageFlags;
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct ExecuteCommandsCommand {
+    static const CommandType TYPE = COMMAND_TYPE_EXECUTE_COMMANDS;
+
+    CommandHeader header;
+    /** Secondary command buffer replayed in place of this command. */
+    CommandHandle commandBuffer;
+};
+
+/** One region of an fvCmdCopyBuffer. */
+struct CopyBufferCommand {
+    static const CommandType TYPE = COMMAND_TYPE_COPY_BUFFER;
+
+    CommandHeader header;
+    CommandHandle srcBuffer;
+    CommandHandle dstBuffer;
+    FvBufferCopy region;
+};
+
+/** One region of an fvCmdCopyBufferToImage. */
+struct CopyBufferToImageCommand {
+    static const CommandType TYPE = COMMAND_TYPE_COPY_BUFFER_TO_IMAGE;
+
+    CommandHeader header;
+    CommandHandle srcBuffer;
+    CommandHandle dstImage;
+    FvBufferImageCopy region;
+};
+
+/**
+ * Memory block commands are allocated from.
+ */
+struct CommandBlock {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity;
+    size_t used;
+};
+
+/**
+ * Memory blocks shared by several CommandStreams, e.g. all command buffers of
+ * a command pool.
+ *
+ * Streams take blocks from the pool as they grow and give all of them back
+ * when reset or destroyed, so the memory goes wherever it is needed next.
+ * Blocks are only freed when the pool is destroyed, which must happen after
+ * all of its streams have been destroyed.
+ *
+ * A pool is not thread-safe. Streams recorded on different threads at the
+ * same time must use different pools.
+ */
+class CommandBlockPool {
+  public:
+    /**
+     * \param blockSize Size of the memory blocks handed out.
+     */
+    explicit CommandBlockPool(size_t blockSize);
+
+    CommandBlockPool(const CommandBlockPool &) = delete;
+    CommandBlockPool &operator=(const CommandBlockPool &) = delete;
+
+    /**
+     * Get the number of blocks the pool has allocated.
+     */
+    size_t getNumBlocks() const { return numBlocks; }
+
+    /**
+     * Get the number of blocks not in use by any stream.
+     */
+    size_t getNumFreeBlocks() const { return freeBlocks.size(); }
+
+  private:
+    friend class CommandStream;
+
+    /**
+     * Get an empty block with room for at least \p size bytes.
+     */
+    CommandBlock acquire(size_t size);
+
+    /**
+     * Take back a block that is no longer in use.
+     */
+    void release(CommandBlock &&block);
+
+    size_t blockSize;
+    size_t numBlocks;
+    std::vector<CommandBlock> freeBlocks;
+};
+
+/**
+ * Records any number of commands in order, for a backend to replay later.
+ *
+ * - Commands are fixed-size packets, bump allocated from large memory blocks,
+ *   so recording a command is a few stores and never copies earlier commands.
+ * - 'reset' forgets the recorded commands but keeps the blocks, so a stream
+ *   recorded every frame stops allocating once it has reached its largest
+ *   size. A stream recording into a CommandBlockPool gives its blocks back
+ *   to the pool instead.
+ * - Iterating visits each command's CommandHeader in recording order. Switch
+ *   on 'type' and use 'as' to get at the command.
+ */
+class CommandStream {
+  public:
+    /** Size of the memory blocks commands are allocated from. */
+    static const size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    /** Every command is padded to a multiple of this. */
+    static const size_t COMMAND_ALIGNMENT = 8;
+
+    /** Largest command, including its payload, the header can describe. */
+    static const size_t MAX_COMMAND_SIZE = 0xFFFF - COMMAND_ALIGNMENT;
+
+    class const_iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef const CommandHeader value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const CommandHeader *pointer;
+        typedef const CommandHeader &reference;
+
+        const_iterator() : blocks(nullptr), block(0), offset(0), endBlock(0) {}
+
+        const CommandHeader &operator*() const {
+            return *reinterpret_cast<const CommandHeader *>(
+                (*blocks)[block].data.get() + offset);
+        }
+        const CommandHeader *operator->() const { return &**this; }
+
+        const_iterator &operator++();
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return block == other.block && offset == other.offset;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return !(*this == other);
+        }
+
+      private:
+        friend class CommandStream;
+
+        const_iterator(const std::vector<CommandBlock> *blocks, size_t block,
+                       size_t endBlock);
+
+        /** Step over blocks with no commands left in them. */
+        void skipFinishedBlocks();
+
+        const std::vector<CommandBlock> *blocks;
+        size_t block;
+        size_t offset;
+        size_t endBlock;
+    };
+
+    /**
+     * \param blockSize Size of the memory blocks commands are allocated from.
+     */
+    explicit CommandStream(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * \param pool Pool to take memory blocks from, must outlive the stream.
+     */
+    explicit CommandStream(CommandBlockPool *pool);
+
+    /**
+     * Gives the memory blocks back to the pool, if there is one.
+     */
+    ~CommandStream();
+
+    CommandStream(CommandStream &&) = default;
+    CommandStream &operator=(CommandStream &&other);
+
+    CommandStream(const CommandStream &) = delete;
+    CommandStream &operator=(const CommandStream &) = delete;
+
+    /**
+     * Append a command to the stream.
+     *
+     * \return Command with its header filled in, the caller fills in the
+     *         rest. Valid until the stream is reset or destroyed.
+     */
+    template <typename Command> Command *record();
+
+    /**
+     * Append a command followed by a payload of variable size, e.g. data
+     * stored inline instead of in a buffer.
+     *
+     * \param payloadSize Size of the payload in bytes, the command and its
+     *                    payload must fit in MAX_COMMAND_SIZE.
+     * 
+eturn            Command with its header filled in, the caller fills
+     *                    in the rest and the payload, see 'getPayload'.
+     */
+    template <typename Command> Command *record(size_t payloadSize);
+
+    /**
+     * Forget every recorded command, keeping the memory for new ones or
+     * giving it back to the pool.
+     */
+    void reset();
+
+    /**
+     * Get the number of recorded commands.
+     */
+    size_t size() const { return numCommands; }
+
+    bool empty() const { return numCommands == 0; }
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+  private:
+    /**
+     * Get memory for a command of the given size, which is a multiple of
+     * COMMAND_ALIGNMENT.
+     */
+    void *allocate(size_t size);
+
+    /**
+     * Move on to a block with room for a command of the given size, reusing
+     * a block kept from before the last reset if it is large enough.
+     */
+    void nextBlock(size_t size);
+
+    /**
+     * Give every block back to the pool.
+     *
+     * \pre The stream records into a pool.
+     */
+    void releaseBlocks();
+
+    size_t blockSize;
+    /** Pool blocks come from, or nullptr if the stream owns its blocks. */
+    CommandBlockPool *pool;
+    std::vector<CommandBlock> blocks;
+    /** Block commands are currently recorded into. */
+    size_t currentBlock;
+    size_t numCommands;
+};
+}
+
+#include <Fever/CommandStream.hpp>
@@ -0,0 +1,40 @@
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include <Fever/CommandStream.h>
+
+namespace fv {
+template <typename Command> Command *CommandStream::record() {
+    return record<Command>(0);
+}
+
+template <typename Command>
+Command *CommandStream::record(size_t payloadSize) {
+    static_assert(std::is_trivially_destructible<Command>::value,
+                  "Commands are never destroyed, they must not need to be.");
+    static_assert(std::is_standard_layout<Command>::value &&
+                      offsetof(Command, header) == 0,
+                  "Commands must start with their CommandHeader.");
+    static_assert(alignof(Command) <= COMMAND_ALIGNMENT,
+                  "Command needs more alignment than the stream gives.");
+
+    static_assert(sizeof(Command) <= MAX_COMMAND_SIZE,
+                  "Command is too large for its header.");
+    assert(payloadSize <= MAX_COMMAND_SIZE - sizeof(Command) &&
+           "Command payload is too large for its header.");
+
+    // Round up so the next command is aligned too
+    const size_t size =
+        (sizeof(Command) + payloadSize + COMMAND_ALIGNMENT - 1) &
+        ~(COMMAND_ALIGNMENT - 1);
+
+    Command *command     = new (allocate(size)) Command;
+    command->header.type = Command::TYPE;
+    command->header.size = (uint16_t)size;
+    ++numCommands;
+
+    return command;
+}
+}
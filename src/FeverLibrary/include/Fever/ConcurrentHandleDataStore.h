@@ -0,0 +1,144 @@
+/*===-- Fever/ConcurrentHandleDataStore.h - Concurrent store ------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Container for data referred to by handle that may be safely accessed
+ * from multiple threads at once.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <Fever/Handle.h>
+
+namespace fv {
+/**
+ * Thread-safe variant of the HandleDataStore.
+ *
+ * - Index allocation and release are lock-free: free indices are kept on an
+ *   intrusive Treiber stack whose head is tagged to avoid the ABA problem.
+ * - isValid and get are wait-free: each slot carries a single atomic state
+ *   word holding the slot's generation and whether it is currently live.
+ *
+ * Unlike the HandleDataStore, storage is allocated once, up front, so that
+ * objects never move while other threads hold pointers to them.
+ *
+ * The store only synchronizes the handle bookkeeping. As with any handle
+ * system, removing an object while another thread is still using a pointer
+ * returned by 'get' is the caller's responsibility to prevent.
+ *
+ * \tparam HandleType BasicHandle layout of the handles given out, see Handle
+ *                    and Handle64.
+ */
+template <typename T, typename HandleType = Handle>
+class ConcurrentHandleDataStore {
+  public:
+    static_assert(HandleType::HANDLE_INDEX_BITS <= 32,
+                  "ConcurrentHandleDataStore indices are limited to 32 bits.");
+
+    /**
+     * \pre maxNumHandles is not larger than the maximum number of indices
+     * representable by a HandleType.
+     *
+     * \param maxNumHandles Maximum number of live objects in the store.
+     */
+    explicit ConcurrentHandleDataStore(uint32_t maxNumHandles);
+
+    /**
+     * \copydoc HandleDataStore::isValid
+     */
+    bool isValid(HandleType handle) const;
+
+    /**
+     * Add a new object to the data store.
+     *
+     * \param  object      Reference to object to add.
+     * \param  [out]handle Handle referring to the added object.
+     * \return             True if the object was added, false if the store is
+     *                     full.
+     */
+    bool add(const T &object, HandleType *handle);
+
+    /**
+     * \copydoc HandleDataStore::remove
+     *
+     * If several threads race to remove the same handle, exactly one of them
+     * releases it.
+     */
+    void remove(HandleType handle);
+
+    /**
+     * \copydoc HandleDataStore::get(Handle handle) const
+     */
+    const T *get(HandleType handle) const;
+
+    /**
+     * \copydoc HandleDataStore::get(Handle handle)
+     */
+    T *get(HandleType handle);
+
+    /**
+     * Get the maximum number of live objects the store can hold.
+     */
+    uint32_t capacity() const { return maxNumHandles; }
+
+  private:
+    /**
+     * A slot's state, (generation << 1) | SLOT_LIVE_BIT. The id type always
+     * has room for the generation and the live bit.
+     */
+    typedef typename HandleType::IdType SlotState;
+
+    /** Marks the end of the free index list. */
+    static const uint32_t FREE_LIST_END = 0xFFFFFFFF;
+
+    /** Bit set in a slot's state while the slot holds a live object. */
+    static const SlotState SLOT_LIVE_BIT = 1;
+
+    /**
+     * Pop an index off the free list.
+     *
+     * \return Free index or FREE_LIST_END if the free list is empty.
+     */
+    uint32_t popFreeIndex();
+
+    /**
+     * Push an index onto the free list.
+     */
+    void pushFreeIndex(uint32_t index);
+
+    /**
+     * Reserve an index that has never been used before.
+     *
+     * \return Fresh index or FREE_LIST_END if the store is full.
+     */
+    uint32_t reserveFreshIndex();
+
+    /**
+     * \copydoc HandleDataStore::makeHandle
+     */
+    HandleType makeHandle(uint32_t index, SlotState generation) const;
+
+    const uint32_t maxNumHandles;
+
+    /** Number of indices that have been handed out at least once. */
+    std::atomic<uint32_t> numUsedIndices;
+    /** Head of the free list: ABA tag in the upper, index in lower 32 bits. */
+    std::atomic<uint64_t> freeListHead;
+
+    /** Per-slot (generation << 1) | SLOT_LIVE_BIT. */
+    std::unique_ptr<std::atomic<SlotState>[]> slotStates;
+    /** Per-slot link to the next free index (only meaningful while free). */
+    std::unique_ptr<std::atomic<uint32_t>[]> nextFreeIndices;
+    std::vector<T> objects;
+};
+}
+
+#include <Fever/ConcurrentHandleDataStore.hpp>
@@ -0,0 +1,177 @@
+#include <cassert>
+
+#include <Fever/ConcurrentHandleDataStore.h>
+
+namespace fv {
+template <typename T, typename HandleType>
+ConcurrentHandleDataStore<T, HandleType>::ConcurrentHandleDataStore(
+    uint32_t maxNumHandles)
+    : maxNumHandles(maxNumHandles), numUsedIndices(0),
+      freeListHead(FREE_LIST_END),
+      slotStates(new std::atomic<SlotState>[maxNumHandles]),
+      nextFreeIndices(new std::atomic<uint32_t>[maxNumHandles]),
+      objects(maxNumHandles) {
+    assert((uint64_t)maxNumHandles <=
+               (uint64_t)HandleType::HANDLE_INDEX_MASK + 1 &&
+           "Tried to create a store with more slots than a Handle can index.");
+
+    for (uint32_t i = 0; i < maxNumHandles; ++i) {
+        slotStates[i].store(0, std::memory_order_relaxed);
+        nextFreeIndices[i].store(FREE_LIST_END, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename HandleType>
+bool ConcurrentHandleDataStore<T, HandleType>::isValid(
+    HandleType handle) const {
+    const uint32_t index = handle.getIndex();
+
+    if (index >= maxNumHandles) {
+        return false;
+    }
+
+    // A single load decides validity: the slot must be live and hold the
+    // generation recorded in the handle.
+    const SlotState expected = (handle.getGeneration() << 1) | SLOT_LIVE_BIT;
+
+    return slotStates[index].load(std::memory_order_acquire) == expected;
+}
+
+template <typename T, typename HandleType>
+bool ConcurrentHandleDataStore<T, HandleType>::add(const T &object,
+                                                   HandleType *handle) {
+    assert(handle != nullptr);
+
+    uint32_t index = popFreeIndex();
+
+    if (index == FREE_LIST_END) {
+        index = reserveFreshIndex();
+
+        if (index == FREE_LIST_END) {
+            return false;
+        }
+    }
+
+    // This thread now exclusively owns the slot, so the object can be written
+    // without synchronization. The release store below publishes it.
+    objects[index] = object;
+
+    const SlotState generation =
+        slotStates[index].load(std::memory_order_relaxed) >> 1;
+
+    slotStates[index].store((generation << 1) | SLOT_LIVE_BIT,
+                            std::memory_order_release);
+
+    *handle = makeHandle(index, generation);
+
+    return true;
+}
+
+template <typename T, typename HandleType>
+void ConcurrentHandleDataStore<T, HandleType>::remove(HandleType handle) {
+    const uint32_t index = handle.getIndex();
+
+    if (index >= maxNumHandles) {
+        return;
+    }
+
+    // Wrap the generation within its bits
+    const SlotState generation = handle.getGeneration();
+    const SlotState nextGeneration =
+        (generation + 1) & HandleType::HANDLE_MAX_GENERATION;
+
+    SlotState expected = (generation << 1) | SLOT_LIVE_BIT;
+
+    // Only the thread that flips the slot from live to dead may free it.
+    if (slotStates[index].compare_exchange_strong(
+            expected, nextGeneration << 1, std::memory_order_acq_rel,
+            std::memory_order_relaxed)) {
+        pushFreeIndex(index);
+    }
+}
+
+template <typename T, typename HandleType>
+const T *ConcurrentHandleDataStore<T, HandleType>::get(
+    HandleType handle) const {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return &objects[handle.getIndex()];
+    }
+}
+
+template <typename T, typename HandleType>
+T *ConcurrentHandleDataStore<T, HandleType>::get(HandleType handle) {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return &objects[handle.getIndex()];
+    }
+}
+
+template <typename T, typename HandleType>
+uint32_t ConcurrentHandleDataStore<T, HandleType>::popFreeIndex() {
+    uint64_t head = freeListHead.load(std::memory_order_acquire);
+
+    while (true) {
+        const uint32_t index = (uint32_t)head;
+
+        if (index == FREE_LIST_END) {
+            return FREE_LIST_END;
+        }
+
+        // The link may be stale if another thread pops 'index' first, in
+        // which case the tag has changed and the exchange below fails.
+        const uint32_t next =
+            nextFreeIndices[index].load(std::memory_order_relaxed);
+        const uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+
+        if (freeListHead.compare_exchange_weak(head, newHead,
+                                               std::memory_order_acquire,
+                                               std::memory_order_acquire)) {
+            return index;
+        }
+    }
+}
+
+template <typename T, typename HandleType>
+void ConcurrentHandleDataStore<T, HandleType>::pushFreeIndex(uint32_t index) {
+    uint64_t head = freeListHead.load(std::memory_order_relaxed);
+    uint64_t newHead;
+
+    do {
+        nextFreeIndices[index].store((uint32_t)head,
+                                     std::memory_order_relaxed);
+        newHead = (((head >> 32) + 1) << 32) | index;
+    } while (!freeListHead.compare_exchange_weak(head, newHead,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+}
+
+template <typename T, typename HandleType>
+uint32_t ConcurrentHandleDataStore<T, HandleType>::reserveFreshIndex() {
+    uint32_t used = numUsedIndices.load(std::memory_order_relaxed);
+
+    do {
+        if (used >= maxNumHandles) {
+            return FREE_LIST_END;
+        }
+    } while (!numUsedIndices.compare_exchange_weak(
+        used, used + 1, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    return used;
+}
+
+template <typename T, typename HandleType>
+HandleType ConcurrentHandleDataStore<T, HandleType>::makeHandle(
+    uint32_t index, SlotState generation) const {
+    // Ensure index is not above maximum amount of Entities.
+    assert(index <= HandleType::HANDLE_INDEX_MASK &&
+           "Tried to create an Handle with too high an index.");
+
+    HandleType handle;
+    handle.id = (generation << HandleType::HANDLE_INDEX_BITS) + index;
+
+    return handle;
+}
+}
@@ -0,0 +1,92 @@
+/*===-- Fever/DeferredDestructionQueue.h - Deferred deletion ------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Queue of object destructions waiting for the GPU to finish with the
+ * objects.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace fv {
+/**
+ * Holds back the destruction of objects until the submissions that may still
+ * use them have completed.
+ *
+ * Every submission to a queue is numbered with a serial, starting at 1 and
+ * increasing by one per submission. An object destroyed after submission N has
+ * been made may be in use by any submission up to and including N, so its
+ * destruction is enqueued with serial N. Once the completed serial reaches N,
+ * 'collect' runs the destruction. Submissions that complete out of order only
+ * count once every earlier one has completed too, see SerialTracker.
+ *
+ * Serials must be enqueued in non-decreasing order, which keeps the queue
+ * sorted and lets 'collect' stop at the first entry still in flight.
+ *
+ * Not thread-safe, enqueue and collect from the thread that owns the objects.
+ */
+class DeferredDestructionQueue {
+  public:
+    /** Destroys one object. */
+    typedef std::function<void()> Destroyer;
+
+    DeferredDestructionQueue() = default;
+
+    /**
+     * Runs any destructions still pending, see 'flush'.
+     */
+    ~DeferredDestructionQueue();
+
+    DeferredDestructionQueue(const DeferredDestructionQueue &) = delete;
+    DeferredDestructionQueue &
+    operator=(const DeferredDestructionQueue &) = delete;
+
+    /**
+     * Destroy an object once the given serial has completed.
+     *
+     * \param serial  Last submission serial that may use the object.
+     * \param destroy Function destroying the object.
+     */
+    void enqueue(uint64_t serial, Destroyer destroy);
+
+    /**
+     * Run the destructions of every object whose serial has completed.
+     *
+     * \param  completedSerial Serial of the last completed submission.
+     * \return                 Number of objects destroyed.
+     */
+    size_t collect(uint64_t completedSerial);
+
+    /**
+     * Run every pending destruction, regardless of serial.
+     *
+     * Only call this once the device is idle, e.g. at shutdown.
+     *
+     * \return Number of objects destroyed.
+     */
+    size_t flush();
+
+    /**
+     * Get the number of destructions still pending.
+     */
+    size_t size() const { return entries.size(); }
+
+  private:
+    struct Entry {
+        uint64_t serial;
+        Destroyer destroy;
+    };
+
+    /** Pending destructions, sorted by serial. */
+    std::deque<Entry> entries;
+};
+}
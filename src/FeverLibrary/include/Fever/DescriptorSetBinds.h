@@ -0,0 +1,50 @@
+/*===-- Fever/DescriptorSetBinds.h - Descriptor set binds ---------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Records the binds of fvCmdBindDescriptorSets into a command stream,
+ * shared by the backends.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstdint>
+
+#include <Fever/BindingCache.h>
+#include <Fever/CommandStream.h>
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * Record one BindDescriptorSetCommand per descriptor set that isn't bound
+ * already, each carrying its slice of the dynamic offsets.
+ *
+ * Descriptor sets are resolved once to count the dynamic offsets and again to
+ * record them, so nothing is allocated once the stream has its blocks.
+ *
+ * \tparam Resolve Function taking an FvDescriptorSet and a CommandHandle to
+ *                 set to its handle, and returning a pointer to its binding
+ *                 table, see BindingTable, or nullptr if the handle is
+ *                 invalid. The table must stay at that address while the
+ *                 descriptor set lives.
+ * \param firstSet       Index of the first descriptor set to bind.
+ * \param dynamicOffsets One offset per dynamic buffer slot of the descriptor
+ *                       sets, in order.
+ * \return               False if the dynamic offsets don't match the dynamic
+ *                       buffer slots or aren't multiples of
+ *                       FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT, in which case
+ *                       nothing is recorded.
+ */
+template <typename Resolve>
+bool recordDescriptorSetBinds(CommandStream &commands, BindingCache &bindings,
+                              uint32_t firstSet, uint32_t descriptorSetCount,
+                              const FvDescriptorSet *descriptorSets,
+                              uint32_t dynamicOffsetCount,
+                              const uint32_t *dynamicOffsets, Resolve resolve);
+}
+
+#include <Fever/DescriptorSetBinds.hpp>
@@ -0,0 +1,69 @@
+#include <cstring>
+
+#include <Fever/DescriptorSetBinds.h>
+
+namespace fv {
+template <typename Resolve>
+bool recordDescriptorSetBinds(CommandStream &commands, BindingCache &bindings,
+                              uint32_t firstSet, uint32_t descriptorSetCount,
+                              const FvDescriptorSet *descriptorSets,
+                              uint32_t dynamicOffsetCount,
+                              const uint32_t *dynamicOffsets, Resolve resolve) {
+    if (descriptorSets == nullptr && descriptorSetCount != 0) {
+        return false;
+    }
+
+    uint32_t numDynamicOffsets = 0;
+    CommandHandle handle;
+
+    for (uint32_t i = 0; i < descriptorSetCount; ++i) {
+        const auto *resolvedSet = resolve(descriptorSets[i], &handle);
+
+        if (resolvedSet != nullptr) {
+            numDynamicOffsets += resolvedSet->getNumDynamicBuffers();
+        }
+    }
+
+    // Encoding reads an offset for every dynamic slot, so a bind short of
+    // offsets is dropped rather than recorded
+    if (dynamicOffsetCount != numDynamicOffsets ||
+        (dynamicOffsetCount > 0 && dynamicOffsets == nullptr)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < dynamicOffsetCount; ++i) {
+        if (dynamicOffsets[i] % FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT != 0) {
+            return false;
+        }
+    }
+
+    const uint32_t *setDynamicOffsets = dynamicOffsets;
+
+    for (uint32_t i = 0; i < descriptorSetCount; ++i) {
+        const auto *resolvedSet = resolve(descriptorSets[i], &handle);
+
+        const uint32_t setDynamicOffsetCount =
+            resolvedSet != nullptr ? resolvedSet->getNumDynamicBuffers() : 0;
+        const uint32_t *offsets = setDynamicOffsets;
+        setDynamicOffsets += setDynamicOffsetCount;
+
+        if (!bindings.bindDescriptorSet(firstSet + i, descriptorSets[i],
+                                        setDynamicOffsetCount > 0)) {
+            continue;
+        }
+
+        BindDescriptorSetCommand *command =
+            commands.record<BindDescriptorSetCommand>(setDynamicOffsetCount *
+                                                      sizeof(uint32_t));
+        command->set                = firstSet + i;
+        command->descriptorSet      = handle;
+        command->resolvedSet        = resolvedSet;
+        command->dynamicOffsetCount = setDynamicOffsetCount;
+        if (setDynamicOffsetCount > 0) {
+            memcpy(getPayload(command), offsets,
+                   setDynamicOffsetCount * sizeof(uint32_t));
+        }
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,70 @@
+/*===-- Fever/Fence.h - CPU-visible completion --------------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Signal the GPU raises when a submission completes, for the CPU to
+ * wait on.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace fv {
+/**
+ * A flag that is signaled once, from any thread, and stays signaled until it
+ * is reset.
+ *
+ * Backends signal the fence given to a submission from the submission's
+ * completion handler. Waiting blocks until the fence is signaled or the
+ * timeout runs out, so the CPU only stalls for the work it depends on.
+ */
+class Fence {
+  public:
+    /** Timeout that waits for as long as it takes. */
+    static const uint64_t WAIT_FOREVER = UINT64_MAX;
+
+    /**
+     * \param signaled Whether the fence starts out signaled.
+     */
+    explicit Fence(bool signaled = false) : signaled(signaled) {}
+
+    Fence(const Fence &) = delete;
+    Fence &operator=(const Fence &) = delete;
+
+    /**
+     * Signal the fence, waking every thread waiting on it.
+     */
+    void signal();
+
+    /**
+     * Unsignal the fence, before handing it to another submission.
+     */
+    void reset();
+
+    /**
+     * Get whether the fence is signaled, without blocking.
+     */
+    bool isSignaled() const;
+
+    /**
+     * Block until the fence is signaled.
+     *
+     * \param  timeout Nanoseconds to wait for at most, 0 only checks the
+     *                 fence and WAIT_FOREVER never gives up.
+     * \return         Whether the fence was signaled before the timeout.
+     */
+    bool wait(uint64_t timeout = WAIT_FOREVER) const;
+
+  private:
+    mutable std::mutex mutex;
+    mutable std::condition_variable condition;
+    bool signaled;
+};
+}
@@ -21,6 +21,12 @@
 #include <Fever/FeverPlatform.h>
 
 #define FV_NULL_HANDLE 0
+/**
+ * Handles point at memory of the backend's, which may be freed once their
+ * object is destroyed. The handle of a destroyed object must never be passed
+ * to Fever again, not even to destroy it again. Command buffers recorded with
+ * it may still be submitted, commands using the destroyed object are skipped.
+ */
 #define FV_DEFINE_HANDLE(object) typedef struct object##_t *object;
 
 #define FV_FALSE 0
@@ -93,14 +99,97 @@ FV_DEFINE_HANDLE(FvBuffer);
 extern FvResult fvBufferCreate(FvBuffer *buffer,
                                const FvBufferCreateInfo *createInfo);
 
+/**
+ * Destroy a buffer.
+ *
+ * The buffer may still be in use by submitted work, so its memory is only freed
+ * once every submission made before this call has completed. There is no need
+ * to wait for the device to be idle first.
+ */
 extern void fvBufferDestroy(FvBuffer buffer);
 
+/**
+ * Create several buffers at once.
+ *
+ * Cheaper per buffer than calling 'fvBufferCreate' for each one. Either all
+ * buffers are created or, on failure, none are.
+ *
+ * \param count       Number of buffers to create.
+ * \param createInfos Array of \p count creation parameters.
+ * \param buffers     Array of \p count handles receiving the new buffers.
+ */
+extern FvResult fvBuffersCreate(uint32_t count,
+                                const FvBufferCreateInfo *createInfos,
+                                FvBuffer *buffers);
+
+/**
+ * Destroy several buffers at once.
+ *
+ * \param count   Number of buffers to destroy.
+ * \param buffers Array of \p count buffers to destroy.
+ */
+extern void fvBuffersDestroy(uint32_t count, const FvBuffer *buffers);
+
 /** Replace the contents of a buffer with new data.
  *
  * \pre \p dataSize is less than the size of the buffer.
  */
 extern void fvBufferReplaceData(FvBuffer buffer, void *data, size_t dataSize);
 
+/**
+ * Copy data into part of a buffer, leaving the rest as it is.
+ *
+ * Like fvBufferReplaceData, the copy is made on the calling thread, so the
+ * range must not be in use by submitted work.
+ *
+ * \param buffer Buffer to update.
+ * \param offset Offset in bytes of the range to update.
+ * \param data Data to copy.
+ * \param size Size in bytes of the range.
+ * \return FV_RESULT_FAILURE if the range doesn't fit in the buffer.
+ */
+extern FvResult fvBufferUpdateRange(FvBuffer buffer, FvSize offset,
+                                    const void *data, FvSize size);
+
+/** Range of a mapped buffer written by the CPU. */
+typedef struct FvBufferRange {
+    /** Offset in bytes of the range */
+    FvSize offset;
+    /** Size in bytes of the range */
+    FvSize size;
+} FvBufferRange;
+
+/**
+ * Map a buffer, so its memory can be written in place without an extra copy.
+ *
+ * The mapping is persistent: the pointer stays valid, and the same, until the
+ * buffer is unmapped as many times as it was mapped, so it can be kept across
+ * frames. Ranges written must be flushed with fvBufferFlushRanges before
+ * work reading them is submitted, and must not be in use by submitted work
+ * while written.
+ *
+ * \param buffer Buffer to map.
+ * \param data Returns a pointer to the start of the buffer's memory.
+ */
+extern FvResult fvBufferMap(FvBuffer buffer, void **data);
+
+/**
+ * Make ranges of a mapped buffer written by the CPU visible to the GPU.
+ *
+ * \param buffer Mapped buffer.
+ * \param rangeCount Number of ranges.
+ * \param ranges Array of ranges written.
+ * \return FV_RESULT_FAILURE if the buffer isn't mapped or a range doesn't fit
+ * in it.
+ */
+extern FvResult fvBufferFlushRanges(FvBuffer buffer, uint32_t rangeCount,
+                                    const FvBufferRange *ranges);
+
+/**
+ * Undo a fvBufferMap. Ranges written must have been flushed first.
+ */
+extern void fvBufferUnmap(FvBuffer buffer);
+
 /** Opaque handle to shader object. */
 FV_DEFINE_HANDLE(FvShaderModule);
 FV_DEFINE_HANDLE(FvGraphicsPipeline);
@@ -188,8 +277,37 @@ extern void fvImageReplaceRegion(FvImage image, FvRect3D region,
                                  uint32_t mipLevel, uint32_t layer, void *data,
                                  size_t bytesPerRow, size_t bytesPerImage);
 
+/**
+ * Destroy a image.
+ *
+ * The image may still be in use by submitted work, so its memory is only freed
+ * once every submission made before this call has completed. There is no need
+ * to wait for the device to be idle first.
+ */
 extern void fvImageDestroy(FvImage image);
 
+/**
+ * Create several images at once.
+ *
+ * Cheaper per image than calling 'fvImageCreate' for each one. Either all
+ * images are created or, on failure, none are.
+ *
+ * \param count       Number of images to create.
+ * \param createInfos Array of \p count creation parameters.
+ * \param images      Array of \p count handles receiving the new images.
+ */
+extern FvResult fvImagesCreate(uint32_t count,
+                               const FvImageCreateInfo *createInfos,
+                               FvImage *images);
+
+/**
+ * Destroy several images at once.
+ *
+ * \param count  Number of images to destroy.
+ * \param images Array of \p count images to destroy.
+ */
+extern void fvImagesDestroy(uint32_t count, const FvImage *images);
+
 FV_DEFINE_HANDLE(FvSampler);
 
 typedef struct FvSamplerCreateInfo {
@@ -235,8 +353,37 @@ typedef struct FvSamplerCreateInfo {
 extern FvResult fvSamplerCreate(FvSampler *sampler,
                                 const FvSamplerCreateInfo *createInfo);
 
+/**
+ * Destroy a sampler.
+ *
+ * The sampler may still be in use by submitted work, so its memory is only
+ * freed once every submission made before this call has completed. There is no
+ * need to wait for the device to be idle first.
+ */
 extern void fvSamplerDestroy(FvSampler sampler);
 
+/**
+ * Create several samplers at once.
+ *
+ * Cheaper per sampler than calling 'fvSamplerCreate' for each one. Either all
+ * samplers are created or, on failure, none are.
+ *
+ * \param count       Number of samplers to create.
+ * \param createInfos Array of \p count creation parameters.
+ * \param samplers    Array of \p count handles receiving the new samplers.
+ */
+extern FvResult fvSamplersCreate(uint32_t count,
+                                 const FvSamplerCreateInfo *createInfos,
+                                 FvSampler *samplers);
+
+/**
+ * Destroy several samplers at once.
+ *
+ * \param count    Number of samplers to destroy.
+ * \param samplers Array of \p count samplers to destroy.
+ */
+extern void fvSamplersDestroy(uint32_t count, const FvSampler *samplers);
+
 typedef struct FvStencilOperationState {
     /** Operation performed to update the values in the stencil attachment when
      * the stencil test fails */
@@ -431,6 +578,13 @@ extern FvResult
 fvDescriptorSetCreate(FvDescriptorSet *descriptorSet,
                       const FvDescriptorSetCreateInfo *createInfo);
 
+/**
+ * Destroy a descriptor set.
+ *
+ * Submitted work may still bind the descriptor set, so it is only freed once
+ * every submission made before this call has completed. Command buffers
+ * recorded with it skip its binds when submitted again.
+ */
 extern void fvDescriptorSetDestroy(FvDescriptorSet descriptorSet);
 
 /* FV_DEFINE_HANDLE(FvDescriptorPool); */
@@ -486,6 +640,10 @@ extern void fvDescriptorSetDestroy(FvDescriptorSet descriptorSet);
 /* fvAllocateDescriptorSets(FvDescriptorSet *descriptorSets, */
 /*                          const FvDescriptorSetAllocateInfo *allocateInfo); */
 
+/** Alignment in bytes of the offsets at which uniform buffers may be bound,
+    including the dynamic offsets given to fvCmdBindDescriptorSets. */
+#define FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT 256
+
 /** Information about the buffer tied to a descriptor set. */
 typedef struct FvDescriptorBufferInfo {
     /** Buffer to attach to descriptor set. */
@@ -520,7 +678,9 @@ typedef struct FvWriteDescriptorSet {
     uint32_t descriptorCount;
     /** An array of FvDescriptorBufferInfo structures that will be used as the
      * data source in the write(if descriptor type is
-     * FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER). */
+     * FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER or
+     * FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, for which the offset is the
+     * base the dynamic offset is added to). */
     const FvDescriptorBufferInfo *bufferInfo;
     /** An array of FvDescriptorImageInfo structures that will be used as the
      * data source in the write (if descriptor type is
@@ -539,12 +699,20 @@ fvUpdateDescriptorSets(uint32_t descriptorWriteCount,
 
 FV_DEFINE_HANDLE(FvPipelineLayout);
 
+/** Bytes of push constants every push constant range must lie within. */
+#define FV_MAX_PUSH_CONSTANTS_SIZE 128
+
+/** Vertex and fragment buffer index push constants are bound to by the Metal
+    backend, shader buffers must not use it. */
+#define FV_METAL_PUSH_CONSTANTS_BUFFER_INDEX 30
+
 typedef struct FvPushConstantRange {
     /** Bitmask of shader stages that access this range of push constants */
     int stageFlags;
     /** Start offset of range (must be multiple of 4) */
     uint32_t offset;
-    /** Size of range (must be multiple of 4) */
+    /** Size of range (must be multiple of 4, and offset + size must not
+        exceed FV_MAX_PUSH_CONSTANTS_SIZE) */
     uint32_t size;
 } FvPushConstantRange;
 
@@ -561,6 +729,13 @@ typedef struct FvPipelineLayoutCreateInfo {
     const FvPushConstantRange *pushConstantRanges;
 } FvPipelineLayoutCreateInfo;
 
+/**
+ * Create a pipeline layout.
+ *
+ * 
+eturn FV_RESULT_FAILURE if a push constant range is not a non-empty
+ * multiple of 4 bytes lying within FV_MAX_PUSH_CONSTANTS_SIZE.
+ */
 extern FvResult
 fvPipelineLayoutCreate(FvPipelineLayout *layout,
                        const FvPipelineLayoutCreateInfo *createInfo);
@@ -677,6 +852,21 @@ extern FvResult
 fvGraphicsPipelineCreate(FvGraphicsPipeline *graphicsPipeline,
                          const FvGraphicsPipelineCreateInfo *createInfo);
 
+/**
+ * Create several graphics pipelines at once, compiling them in parallel on
+ * the job system's workers, see fvParallelFor.
+ *
+ * Either every pipeline is created or, on failure, none is.
+ *
+ * \param createInfoCount Number of pipelines to create.
+ * \param createInfos Array of pipeline descriptions.
+ * \param graphicsPipelines Returns a pipeline per description.
+ */
+extern FvResult
+fvGraphicsPipelinesCreate(uint32_t createInfoCount,
+                          const FvGraphicsPipelineCreateInfo *createInfos,
+                          FvGraphicsPipeline *graphicsPipelines);
+
 extern void fvGraphicsPipelineDestroy(FvGraphicsPipeline graphicsPipeline);
 
 FV_DEFINE_HANDLE(FvFramebuffer);
@@ -701,9 +891,47 @@ extern FvResult fvFramebufferCreate(FvFramebuffer *framebuffer,
 
 extern void fvFramebufferDestroy(FvFramebuffer framebuffer);
 
+/**
+ * Command pools own the memory their command buffers record into.
+ *
+ * Command buffers from different command pools may be recorded on different
+ * threads at the same time, e.g. one command pool per thread. A command pool
+ * and its command buffers must only be used by one thread at a time.
+ *
+ * Recording looks up the objects it is given without locking, so while
+ * command buffers are recorded on other threads no object of any kind may be
+ * created or destroyed. Neither may work be submitted or waited for with
+ * fvDeviceWaitIdle, which free objects destroyed earlier. Record in parallel,
+ * e.g. in a parallel for, and create, destroy and submit once it is done.
+ */
 FV_DEFINE_HANDLE(FvCommandPool);
 
+/**
+ * Queues run the command buffers submitted to them in order, while different
+ * queues run at the same time. There is one queue of each FvQueueType, created
+ * by fvInit.
+ *
+ * Uploads recorded with fvCmdCopyBuffer and fvCmdCopyBufferToImage into
+ * command buffers of the transfer queue run alongside the frames rendered on
+ * the graphics queue. Hand the uploaded data over by having the graphics
+ * submission wait on a semaphore the transfer submission signals, a timeline
+ * semaphore does so without blocking the thread submitting.
+ */
+FV_DEFINE_HANDLE(FvQueue);
+
+/**
+ * Get the queue of a type.
+ *
+ * \param type Type of the queue.
+ * \param queue Returns the queue, which lives until fvShutdown.
+ */
+extern FvResult fvGetQueue(FvQueueType type, FvQueue *queue);
+
 typedef struct FvCommandPoolCreateInfo {
+    /** Queue the command buffers of the pool are submitted to, FV_NULL_HANDLE
+     * for the graphics queue. Command buffers of the transfer queue may only
+     * record copies. */
+    FvQueue queue;
 } FvCommandPoolCreateInfo;
 
 extern FvResult fvCommandPoolCreate(FvCommandPool *commandPool,
@@ -711,6 +939,11 @@ extern FvResult fvCommandPoolCreate(FvCommandPool *commandPool,
 
 extern void fvCommandPoolDestroy(FvCommandPool commandPool);
 
+/** Reset every command buffer created from the command pool. The memory they
+ * recorded into is kept by the pool and reused by the next recordings, so
+ * resetting the pool once per frame keeps recording free of allocations. */
+extern void fvCommandPoolReset(FvCommandPool commandPool);
+
 FV_DEFINE_HANDLE(FvCommandBuffer);
 
 /** Create a command buffer from a command pool, command buffers are
@@ -718,13 +951,48 @@ FV_DEFINE_HANDLE(FvCommandBuffer);
 extern FvResult fvCommandBufferCreate(FvCommandBuffer *commandBuffer,
                                       FvCommandPool commandPool);
 
+/** Create a secondary command buffer from a command pool. Secondary command
+ * buffers are not submitted, they record binds and draws executed by primary
+ * command buffers with fvCmdExecuteCommands. */
+extern FvResult fvCommandBufferCreateSecondary(FvCommandBuffer *commandBuffer,
+                                               FvCommandPool commandPool);
+
 extern void fvCommandBufferDestroy(FvCommandBuffer commandBuffer,
                                    FvCommandPool commandPool);
 
+/** Begin recording a command buffer, anything previously recorded into it is
+ * reset. */
 extern void fvCommandBufferBegin(FvCommandBuffer commandBuffer);
 
+/** Discard the commands recorded into a command buffer, returning their memory
+ * to the command pool. */
+extern void fvCommandBufferReset(FvCommandBuffer commandBuffer);
+
 extern FvResult fvCommandBufferEnd(FvCommandBuffer commandBuffer);
 
+typedef struct FvCommandBufferStatistics {
+    /** Number of pipeline, vertex buffer, index buffer and descriptor set binds
+     * made */
+    uint32_t bindCount;
+    /** Number of those binds that were not recorded because the same state was
+     * already bound */
+    uint32_t elidedBindCount;
+    /** Number of fixed-function and pipeline state changes (cull mode, depth
+     * stencil, winding, pipeline, scissor, viewport) skipped when submitting
+     * because they were already set, summed over every submit */
+    uint32_t elidedStateChangeCount;
+} FvCommandBufferStatistics;
+
+/**
+ * Get how much redundant state has been dropped from a command buffer since
+ * it was last begun or reset.
+ *
+ * \param commandBuffer    Command buffer to get statistics of.
+ * \param [out]statistics Statistics of the command buffer.
+ */
+extern void fvCommandBufferGetStatistics(FvCommandBuffer commandBuffer,
+                                         FvCommandBufferStatistics *statistics);
+
 typedef struct FvRenderPassBeginInfo {
     /** Render pass to begin recording commands for */
     FvRenderPass renderPass;
@@ -742,6 +1010,24 @@ extern void fvCmdBeginRenderPass(FvCommandBuffer commandBuffer,
 
 extern void fvCmdEndRenderPass(FvCommandBuffer commandBuffer);
 
+/**
+ * Execute secondary command buffers from a primary command buffer.
+ *
+ * The commands of the secondary command buffers are replayed in place when the
+ * primary command buffer is submitted, so they may be recorded on other
+ * threads, after this call, as long as they have ended before the submit.
+ *
+ * \pre \p commandBuffer is a primary command buffer inside a render pass.
+ * \pre \p commandBuffers were created with fvCommandBufferCreateSecondary.
+ *
+ * \param commandBuffer      Primary command buffer to record the command in.
+ * \param commandBufferCount Number of secondary command buffers.
+ * \param commandBuffers     Secondary command buffers, executed in order.
+ */
+extern void fvCmdExecuteCommands(FvCommandBuffer commandBuffer,
+                                 uint32_t commandBufferCount,
+                                 const FvCommandBuffer *commandBuffers);
+
 extern void fvCmdBindGraphicsPipeline(FvCommandBuffer commandBuffer,
                                       FvGraphicsPipeline graphicsPipeline);
 
@@ -771,6 +1057,24 @@ extern void fvCmdBindVertexBuffers(FvCommandBuffer commandBuffer,
 /**
  * Bind a series of descriptor sets to a command buffer.
  *
+ * Descriptor sets are looked up when the command is recorded, so they must
+ * not be destroyed until the command buffer has been submitted, reset or
+ * destroyed. Updates made to them before submitting are still seen.
+ *
+ * \param commandBuffer The command buffer in which to record the command.
+ * \param layout Pipeline layout object.
+ * \param firstSet Index of the first descriptor set to be bound in \p
+ * descriptorSets array.
+ * \param descriptorSetCount Number of descriptor sets in \p descriptorSets
+ * array.
+ * Each FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor is bound at the
+ * offset it was written with plus a dynamic offset, so one descriptor set can
+ * point at a different part of a buffer for each draw, e.g. at the uniforms
+ * of the current frame, without being updated. The dynamic offsets are taken
+ * in order of descriptor set, then of binding point within the set. Nothing
+ * is recorded if their number doesn't match the dynamic descriptors of the
+ * sets, or if any isn't a multiple of FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+ *
  * \param commandBuffer The command buffer in which to record the command.
  * \param layout Pipeline layout object.
  * \param firstSet Index of the first descriptor set to be bound in \p
@@ -778,11 +1082,40 @@ extern void fvCmdBindVertexBuffers(FvCommandBuffer commandBuffer,
  * \param descriptorSetCount Number of descriptor sets in \p descriptorSets
  * array.
  * \param descriptorSets Array of descriptor sets to bind to command buffer.
+ * \param dynamicOffsetCount Number of offsets in \p dynamicOffsets array.
+ * \param dynamicOffsets Array of offsets in bytes, one per dynamic descriptor
+ * of the descriptor sets, copied into the command buffer.
  */
 extern void fvCmdBindDescriptorSets(FvCommandBuffer commandBuffer,
                                     FvPipelineLayout layout, uint32_t firstSet,
                                     uint32_t descriptorSetCount,
-                                    const FvDescriptorSet *descriptorSets);
+                                    const FvDescriptorSet *descriptorSets,
+                                    uint32_t dynamicOffsetCount,
+                                    const uint32_t *dynamicOffsets);
+
+/**
+ * Update push constants, small values read by the draws recorded after this
+ * command without going through a buffer.
+ *
+ * The values are copied into the command buffer, so \p values may be reused
+ * as soon as this function returns. Backends pass them to shaders inline,
+ * e.g. the Metal backend binds them to vertex and fragment buffer index
+ * FV_METAL_PUSH_CONSTANTS_BUFFER_INDEX, laid out from offset 0.
+ *
+ * The update is ignored unless it lies within a push constant range of \p
+ * layout that includes all of \p stageFlags.
+ *
+ * \param commandBuffer The command buffer in which to record the command.
+ * \param layout Pipeline layout declaring the push constant ranges.
+ * \param stageFlags Bitmask of FvShaderStage that read the updated values.
+ * \param offset Start of the updated values in bytes, a multiple of 4.
+ * \param size Size of the updated values in bytes, a multiple of 4.
+ * \param values The new values.
+ */
+extern void fvCmdPushConstants(FvCommandBuffer commandBuffer,
+                               FvPipelineLayout layout, int stageFlags,
+                               uint32_t offset, uint32_t size,
+                               const void *values);
 
 /**
  * Bind an index buffer to a command buffer.
@@ -828,12 +1161,205 @@ extern void fvCmdDrawIndexed(FvCommandBuffer commandBuffer, uint32_t indexCount,
                              uint32_t instanceCount, uint32_t firstIndex,
                              int32_t vertexOffset, uint32_t firstInstance);
 
+/** Arguments of one draw of fvCmdDrawIndirect, as stored in the buffer. */
+typedef struct FvDrawIndirectCommand {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+} FvDrawIndirectCommand;
+
+/** Arguments of one draw of fvCmdDrawIndexedIndirect, as stored in the
+ * buffer. */
+typedef struct FvDrawIndexedIndirectCommand {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+} FvDrawIndexedIndirectCommand;
+
+/**
+ * Record non-indexed draws whose arguments are read from a buffer.
+ *
+ * The arguments are read when the command buffer is executed, so they may be
+ * written after recording, e.g. by a culling pass. Backends without native
+ * indirect draws read them when the command buffer is submitted instead.
+ * Records that don't lie entirely inside the buffer are not drawn.
+ *
+ * \pre \p buffer was created with the FV_BUFFER_USAGE_INDIRECT_BUFFER flag.
+ *
+ * \param commandBuffer CommandBuffer to record draw calls into.
+ * \param buffer        Buffer holding FvDrawIndirectCommand records.
+ * \param offset        Offset of the first record in bytes, a multiple of 4.
+ * \param drawCount     Number of draws.
+ * \param stride        Bytes between the start of consecutive records, 0 for
+ *                      tightly packed records.
+ */
+extern void fvCmdDrawIndirect(FvCommandBuffer commandBuffer, FvBuffer buffer,
+                              FvSize offset, uint32_t drawCount,
+                              uint32_t stride);
+
+/**
+ * Record indexed draws whose arguments are read from a buffer, using the
+ * bound index buffer. Otherwise the same as fvCmdDrawIndirect.
+ *
+ * \param buffer Buffer holding FvDrawIndexedIndirectCommand records.
+ */
+extern void fvCmdDrawIndexedIndirect(FvCommandBuffer commandBuffer,
+                                     FvBuffer buffer, FvSize offset,
+                                     uint32_t drawCount, uint32_t stride);
+
+/** Region of a buffer to buffer copy. */
+typedef struct FvBufferCopy {
+    FvSize srcOffset;
+    FvSize dstOffset;
+    FvSize size;
+} FvBufferCopy;
+
+/** Region of a buffer to image copy, laid out as for fvImageReplaceRegion. */
+typedef struct FvBufferImageCopy {
+    /** Offset of the data in the source buffer. */
+    FvSize bufferOffset;
+    /** Stride in bytes between rows of the data, see fvImageReplaceRegion. */
+    FvSize bytesPerRow;
+    /** Stride in bytes between images of the data, see fvImageReplaceRegion.
+     */
+    FvSize bytesPerImage;
+    uint32_t mipLevel;
+    uint32_t layer;
+    /** Region of the image to copy to. */
+    FvRect3D imageRegion;
+} FvBufferImageCopy;
+
+/**
+ * Record copies between buffers, run by the GPU when the command buffer is
+ * submitted instead of on the calling thread like fvBufferReplaceData.
+ *
+ * Copies run in the order they were recorded in: those recorded before
+ * fvCmdBeginRenderPass run before the render pass, those recorded after
+ * fvCmdEndRenderPass run after it. Copies can't be recorded inside a render
+ * pass or into secondary command buffers, and are ignored there. Regions not
+ * lying entirely inside both buffers are ignored.
+ *
+ * \param commandBuffer The command buffer in which to record the command.
+ * \param srcBuffer Buffer to copy from.
+ * \param dstBuffer Buffer to copy to.
+ * \param regionCount Number of regions to copy.
+ * \param regions Regions to copy, copied into the command buffer.
+ */
+extern void fvCmdCopyBuffer(FvCommandBuffer commandBuffer, FvBuffer srcBuffer,
+                            FvBuffer dstBuffer, uint32_t regionCount,
+                            const FvBufferCopy *regions);
+
+/**
+ * Record copies from a buffer to an image, run by the GPU when the command
+ * buffer is submitted instead of on the calling thread like
+ * fvImageReplaceRegion. Otherwise the same as fvCmdCopyBuffer.
+ */
+extern void fvCmdCopyBufferToImage(FvCommandBuffer commandBuffer,
+                                   FvBuffer srcBuffer, FvImage dstImage,
+                                   uint32_t regionCount,
+                                   const FvBufferImageCopy *regions);
+
 FV_DEFINE_HANDLE(FvSemaphore);
 
 FvResult fvSemaphoreCreate(FvSemaphore *semaphore);
 
 void fvSemaphoreDestroy(FvSemaphore semaphore);
 
+/**
+ * Create a timeline semaphore, whose state is a 64-bit value that only
+ * increases.
+ *
+ * Submissions wait for and signal values given in FvSubmitInfo, the host with
+ * fvSemaphoreWait and fvSemaphoreSignal. Waits need not be paired with
+ * signals: any number of submissions may wait for the same value, so one
+ * semaphore can order every frame of a queue. A submission waiting for a
+ * value that hasn't been reached is held back without blocking the thread
+ * submitting it.
+ *
+ * Timeline semaphores can't be used to acquire or present swapchain images.
+ *
+ * \param semaphore Returns the semaphore.
+ * \param initialValue Value the semaphore starts at.
+ */
+extern FvResult fvSemaphoreCreateTimeline(FvSemaphore *semaphore,
+                                          uint64_t initialValue);
+
+/**
+ * Raise the value of a timeline semaphore from the host.
+ *
+ * \return FV_RESULT_FAILURE if \p semaphore isn't a timeline semaphore or
+ * \p value isn't greater than its current value.
+ */
+extern FvResult fvSemaphoreSignal(FvSemaphore semaphore, uint64_t value);
+
+/**
+ * Block until a timeline semaphore has reached a value.
+ *
+ * \param semaphore Timeline semaphore to wait on.
+ * \param value Value to wait for.
+ * \param timeout Nanoseconds to wait for at most, see fvFenceWait.
+ * \return FV_RESULT_SUCCESS once the value is reached, FV_RESULT_TIMEOUT if
+ * the timeout ran out first, FV_RESULT_FAILURE if \p semaphore isn't a
+ * timeline semaphore.
+ */
+extern FvResult fvSemaphoreWait(FvSemaphore semaphore, uint64_t value,
+                                uint64_t timeout);
+
+/**
+ * Get the current value of a timeline semaphore.
+ */
+extern FvResult fvSemaphoreGetCounterValue(FvSemaphore semaphore,
+                                           uint64_t *value);
+
+/**
+ * Lets the CPU find out when a submission has completed, e.g. before
+ * overwriting the resources it reads.
+ */
+FV_DEFINE_HANDLE(FvFence);
+
+/** Timeout of fvFenceWait that waits for as long as it takes. */
+#define FV_WAIT_FOREVER UINT64_MAX
+
+typedef struct FvFenceCreateInfo {
+    /** Create the fence signaled, so the first wait on it returns at once */
+    FvBool signaled;
+} FvFenceCreateInfo;
+
+extern FvResult fvFenceCreate(FvFence *fence,
+                              const FvFenceCreateInfo *createInfo);
+
+/**
+ * Destroy a fence, once the submission signaling it has completed.
+ */
+extern void fvFenceDestroy(FvFence fence);
+
+/**
+ * Unsignal a fence so it can be given to another submission.
+ */
+extern void fvFenceReset(FvFence fence);
+
+/**
+ * Block until a fence is signaled.
+ *
+ * \param fence Fence to wait on.
+ * \param timeout Nanoseconds to wait for at most, 0 only checks the fence and
+ * FV_WAIT_FOREVER never gives up.
+ * \return FV_RESULT_SUCCESS once the fence is signaled, FV_RESULT_TIMEOUT if
+ * the timeout ran out first, FV_RESULT_FAILURE if the fence is invalid.
+ */
+extern FvResult fvFenceWait(FvFence fence, uint64_t timeout);
+
+/**
+ * Get whether a fence is signaled, without blocking.
+ *
+ * \return FV_RESULT_SUCCESS if the fence is signaled, FV_RESULT_NOT_READY if
+ * not, FV_RESULT_FAILURE if the fence is invalid.
+ */
+extern FvResult fvFenceGetStatus(FvFence fence);
+
 FV_DEFINE_HANDLE(FvSwapchain);
 
 typedef struct FvSwapchainCreateInfo {
@@ -875,6 +1401,9 @@ typedef struct FvSubmitInfo {
     /** Array of semaphores to wait on before executing command buffers in
      * submission */
     const FvSemaphore *waitSemaphores;
+    /** Value to wait for per wait semaphore, only read for timeline
+     * semaphores. May be NULL if there are none. */
+    const uint64_t *waitSemaphoreValues;
     /** Number of command buffers */
     uint32_t commandBufferCount;
     /** Command buffers to submit */
@@ -885,6 +1414,9 @@ typedef struct FvSubmitInfo {
     /** Array of semaphores to be signaled once commands have completed
      * execution */
     const FvSemaphore *signalSemaphores;
+    /** Value to signal per signal semaphore, only read for timeline
+     * semaphores. May be NULL if there are none. */
+    const uint64_t *signalSemaphoreValues;
 
     /* /\** Array of bitmasked pipeline stages. Each entry corresponds to a wait
      */
@@ -896,9 +1428,21 @@ typedef struct FvSubmitInfo {
 
 /**
  * Make a collection of submissions.
+ *
+ * With asynchronous submission, see FvInitInfo, returns once the submissions
+ * have been copied, the arrays they point to may be reused at once.
+ *
+ * Nothing is submitted if a submission refers to an invalid or secondary
+ * command buffer. A command buffer that fails to encode later is left out,
+ * its submission still signals its semaphores and the fence.
+ *
+ * \param submissionsCount Number of submissions.
+ * \param submissions Submissions to make, in order.
+ * \param fence Unsignaled fence to signal once every submission has completed,
+ * or FV_NULL_HANDLE.
  */
 extern FvResult fvQueueSubmit(uint32_t submissionsCount,
-                              const FvSubmitInfo *submissions);
+                              const FvSubmitInfo *submissions, FvFence fence);
 
 typedef struct FvPresentInfo {
     /** Number of semaphores to wait on before presentation */
@@ -914,13 +1458,111 @@ typedef struct FvPresentInfo {
  */
 extern void fvQueuePresent(const FvPresentInfo *presentInfo);
 
+/**
+ * Block until every submission made so far has completed.
+ *
+ * With asynchronous submission, also waits for the backend thread to make
+ * every submission.
+ */
 extern void fvDeviceWaitIdle();
 
+/**
+ * Fever runs work on a pool of worker threads, created by fvInit, which the
+ * application can share. Each worker owns a deque of jobs and idle workers
+ * steal from the others, so jobs spread over the cores without contending on
+ * one queue.
+ *
+ * Jobs may run more jobs and wait on them, a thread waiting runs jobs itself
+ * until the wait is over. Command buffers from different command pools may be
+ * recorded in parallel jobs, e.g. secondary command buffers, as long as no
+ * objects are created, destroyed or submitted until the jobs are done, see
+ * FvCommandPool.
+ */
+FV_DEFINE_HANDLE(FvJobCounter);
+
+/** Work of a job. */
+typedef void (*FvJobFunction)(void *userData);
+
+/** Work on the indices [begin, end) of a parallel for. */
+typedef void (*FvParallelForFunction)(void *userData, uint32_t begin,
+                                      uint32_t end);
+
+/**
+ * Create a counter of jobs that have yet to finish.
+ *
+ * Counters are created and destroyed outside of jobs, like other objects,
+ * while running jobs against them and waiting on them is safe from any thread.
+ */
+extern FvResult fvJobCounterCreate(FvJobCounter *counter);
+
+/**
+ * Destroy a counter, once every job run against it or waiting for it has
+ * finished.
+ */
+extern void fvJobCounterDestroy(FvJobCounter counter);
+
+/**
+ * Run a job on the job system.
+ *
+ * \param function Work of the job.
+ * \param userData Passed to \p function.
+ * \param counter Counter raised until the job has finished, or
+ * FV_NULL_HANDLE.
+ * \param dependency Counter the job waits for before starting, or
+ * FV_NULL_HANDLE to start at once.
+ */
+extern FvResult fvJobRun(FvJobFunction function, void *userData,
+                         FvJobCounter counter, FvJobCounter dependency);
+
+/**
+ * Block until every job run against a counter has finished, running jobs in
+ * the meantime.
+ */
+extern void fvJobCounterWait(FvJobCounter counter);
+
+/**
+ * Call a function over chunks of the indices [0, count) on the job system,
+ * and wait for every chunk to finish.
+ *
+ * \param count Number of indices.
+ * \param grainSize Largest number of indices in a chunk, as few indices as
+ * still outweigh the cost of a job, roughly a microsecond of work.
+ * \param function Work on a chunk, called from several threads at once.
+ * \param userData Passed to \p function.
+ */
+extern FvResult fvParallelFor(uint32_t count, uint32_t grainSize,
+                              FvParallelForFunction function, void *userData);
+
 FV_DEFINE_HANDLE(FvSurface);
 
 extern void fvDestroySurface(FvSurface surface);
 
-typedef struct FvInitInfo { FvSurface surface; } FvInitInfo;
+typedef struct FvInitInfo {
+    FvSurface surface;
+    /**
+     * Make submissions on a thread of the backend's.
+     *
+     * fvQueueSubmit then copies the submissions and returns, and the backend
+     * thread waits on semaphores, encodes and commits them in the order they
+     * were made. A submission that fails on the backend thread makes the next
+     * fvQueueSubmit fail.
+     *
+     * Objects may be created and destroyed from the application thread while
+     * submissions are queued, the backend thread locks out changes to the
+     * objects it reads while encoding. Until their submissions complete,
+     * submitted command buffers must not be recorded into or reset and the
+     * descriptor sets they bind must not be updated, as always. The image
+     * acquired by fvAcquireNextImage is the one the queued submissions draw
+     * to, so present before acquiring the next one. fvQueuePresent and
+     * fvDeviceWaitIdle wait for the queued submissions to be made.
+     */
+    FvBool asyncSubmission;
+    /**
+     * Number of worker threads of the job system, see FvJobCounter. 0 starts
+     * one per hardware thread but the application's.
+     */
+    uint32_t jobWorkerCount;
+} FvInitInfo;
 
 extern FvResult fvInit(const FvInitInfo *initInfo);
 
@@ -16,10 +16,19 @@
 #pragma once
 
 typedef enum FvBufferUsage {
-    FV_BUFFER_USAGE_VERTEX_BUFFER = 1 << 0,
-    FV_BUFFER_USAGE_INDEX_BUFFER  = 1 << 1,
+    FV_BUFFER_USAGE_VERTEX_BUFFER   = 1 << 0,
+    FV_BUFFER_USAGE_INDEX_BUFFER    = 1 << 1,
+    FV_BUFFER_USAGE_INDIRECT_BUFFER = 1 << 2,
 } FvBufferUsage;
 
+/** Kind of work a queue runs. */
+typedef enum FvQueueType {
+    /** Runs draws and copies, and presents. */
+    FV_QUEUE_TYPE_GRAPHICS,
+    /** Runs copies, alongside the graphics queue. */
+    FV_QUEUE_TYPE_TRANSFER,
+} FvQueueType;
+
 typedef enum FvPrimitiveType {
     FV_PRIMITIVE_TYPE_POINT_LIST,
     FV_PRIMITIVE_TYPE_LINE_LIST,
@@ -212,8 +221,12 @@ typedef enum FvAccessFlags {
 } FvAccessFlags;
 
 typedef enum FvResult {
-    FV_RESULT_SUCCESS = 1 << 0,
-    FV_RESULT_FAILURE = 1 << 1
+    FV_RESULT_SUCCESS   = 1 << 0,
+    FV_RESULT_FAILURE   = 1 << 1,
+    /** A wait ran out of time before what it waited on happened */
+    FV_RESULT_TIMEOUT   = 1 << 2,
+    /** What was asked about hasn't happened yet */
+    FV_RESULT_NOT_READY = 1 << 3
 } FvResult;
 
 typedef enum FvVertexFormat {
@@ -254,6 +267,9 @@ typedef enum FvIndexType {
 typedef enum FvDescriptorType {
     FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
     FV_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+    /** Uniform buffer whose offset is added to when binding the descriptor
+        set, see fvCmdBindDescriptorSets. */
+    FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 } FvDescriptorType;
 
 /** Filter to use for image lookups. */
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #import <Foundation/Foundation.h>
@@ -8,8 +11,19 @@
 #import <MetalKit/MetalKit.h>
 #import <QuartzCore/CAMetalLayer.h>
 
+#include <Fever/BindingCache.h>
+#include <Fever/BindingTable.h>
+#include <Fever/CommandStream.h>
+#include <Fever/IndirectDrawRecords.h>
+#include <Fever/DeferredDestructionQueue.h>
+#include <Fever/DescriptorSetBinds.h>
+#include <Fever/Fence.h>
 #include <Fever/Fever.h>
-#include <Fever/PersistentHandleDataStore.h>
+#include <Fever/JobSystem.h>
+#include <Fever/PagedPersistentHandleDataStore.h>
+#include <Fever/SerialTracker.h>
+#include <Fever/SubmitThread.h>
+#include <Fever/TimelineSemaphore.h>
 
 namespace fv {
 // clang-format off
@@ -70,69 +84,100 @@ struct GraphicsPipelineWrapper {
     std::vector<FvAttachmentReference> stencilAttachment;
 };
 
-struct FramebufferWrapper {
-    std::vector<ImageWrapper> attachments;
-};
-
-typedef enum DrawCallType {
-    DRAW_CALL_TYPE_NON_INDEXED,
-    DRAW_CALL_TYPE_INDEXED,
-} DrawCallType;
-
-struct DrawCallNonIndexed {
-    DrawCallType type;
-    uint32_t vertexCount;
-    uint32_t instanceCount;
-    uint32_t firstVertex;
-    uint32_t firstInstance;
+// A graphics pipeline built by 'buildGraphicsPipeline', yet to be added
+struct BuiltGraphicsPipeline {
+    GraphicsPipelineWrapper pipeline;
+    // Reflection handed to the pipeline's shader modules once it is added
+    std::vector<ShaderArgument> vertexArguments;
+    std::vector<ShaderArgument> fragmentArguments;
 };
 
-struct DrawCallIndexed {
-    DrawCallType type;
-    uint32_t indexCount;
-    uint32_t instanceCount;
-    uint32_t firstIndex;
-    int32_t vertexOffset;
-    uint32_t firstInstance;
+struct PipelineLayoutWrapper {
+    // Where push constants may be updated, checked when recording
+    std::vector<FvPushConstantRange> pushConstantRanges;
 };
 
-union DrawCall {
-    DrawCallType type;
-    DrawCallNonIndexed nonIndexed;
-    DrawCallIndexed indexed;
+struct FramebufferWrapper {
+    std::vector<ImageWrapper> attachments;
 };
 
 struct BufferWrapper {
-    id<MTLBuffer> mtlBuffer;
-
-    // Relevant to vertex buffers
-    FvSize bindingPoint;
+    BufferWrapper() : mtlBuffer(nil), mapCount(0) {}
 
-    // Relevant to index buffers
-    MTLIndexType mtlIndexType;
+    id<MTLBuffer> mtlBuffer;
+    // Number of fvBufferMap calls yet to be undone
+    uint32_t mapCount;
+};
 
-    // Relevant to either
-    FvSize offset;
+struct QueueWrapper {
+    id<MTLCommandQueue> commandQueue;
+    FvQueueType type;
 };
 
 struct CommandBufferWrapper {
-    CommandBufferWrapper()
-        : commandQueue(nil), readyForSubmit(false),
-          graphicsPipeline(FV_NULL_HANDLE), indexBuffer(FV_NULL_HANDLE) {}
+    // 'renderPassBegin' of a command buffer without a render pass
+    static const size_t NO_RENDER_PASS = SIZE_MAX;
+
+    CommandBufferWrapper(CommandBlockPool *blockPool, bool secondary)
+        : commandQueue(nil), queueType(FV_QUEUE_TYPE_GRAPHICS),
+          commandPool(FV_NULL_HANDLE), secondary(secondary),
+          readyForSubmit(false), inRenderPass(false),
+          renderPassBegin(NO_RENDER_PASS), commands(blockPool),
+          numElidedStateChanges(0) {}
+
+    // Forget everything recorded, the memory goes back to the command pool
+    void reset() {
+        commands.reset();
+        bindings.reset();
+        numElidedStateChanges = 0;
+        clearValues.clear();
+        attachments.clear();
+        readyForSubmit  = false;
+        inRenderPass    = false;
+        renderPassBegin = NO_RENDER_PASS;
+    }
 
     id<MTLCommandQueue> commandQueue;
+    // Transfer command buffers only encode copies
+    FvQueueType queueType;
+    FvCommandPool commandPool;
+    // Executed from primary command buffers instead of being submitted
+    bool secondary;
     // FvGraphicsPipeline graphicsPipelineHandle;
     std::vector<FvClearValue> clearValues;
     std::vector<ImageWrapper> attachments;
     bool readyForSubmit;
+    // Copies are not recorded inside the render pass. Those recorded before
+    // it begins are encoded ahead of it, those after it ends behind it.
+    bool inRenderPass;
+    // Number of commands recorded when the render pass began
+    size_t renderPassBegin;
 
-    FvGraphicsPipeline graphicsPipeline;
-    DrawCall drawCall;
+    // Commands recorded since 'fvCommandBufferBegin', replayed at submit
+    CommandStream commands;
 
-    std::vector<FvBuffer> vertexBuffers;
-    FvBuffer indexBuffer;
+    // What the recorded commands have bound, binds changing nothing are dropped
+    BindingCache bindings;
 
-    std::vector<FvDescriptorSet> descriptorSets;
+    // Pipeline states already set when encoding, summed over submits
+    uint32_t numElidedStateChanges;
+};
+
+struct CommandPoolWrapper {
+    CommandPoolWrapper()
+        : commandQueue(nil), queueType(FV_QUEUE_TYPE_GRAPHICS),
+          blockPool(new CommandBlockPool(CommandStream::DEFAULT_BLOCK_SIZE)) {}
+
+    // Command queue of the queue the pool submits to, retained by the pool
+    id<MTLCommandQueue> commandQueue;
+    FvQueueType queueType;
+
+    // Memory all command buffers of the pool record into. Kept behind a
+    // pointer so it stays put when the pool wrapper moves.
+    std::unique_ptr<CommandBlockPool> blockPool;
+
+    // Command buffers created from the pool, destroyed with it
+    std::vector<FvCommandBuffer> commandBuffers;
 };
 
 struct SemaphoreWrapper {
@@ -157,66 +202,59 @@ struct SemaphoreWrapper {
 
     void release() { dispatch_release(semaphore); }
 
+    /**
+     * Get the dispatch semaphore, with a reference the caller releases with
+     * dispatch_release, so it may be used after the wrapper is destroyed.
+     */
+    dispatch_semaphore_t retainSemaphore() {
+        dispatch_retain(semaphore);
+        return semaphore;
+    }
+
+    // Set for timeline semaphores, which don't use the dispatch semaphore.
+    // Shared with the submissions waiting for or signaling it.
+    std::shared_ptr<TimelineSemaphore> timeline;
+
   private:
     dispatch_semaphore_t semaphore;
 };
 
-struct SwapchainWrapper {
-    FvExtent3D extent;
+// A timeline semaphore value a submission waits for or signals
+struct TimelineValue {
+    std::shared_ptr<TimelineSemaphore> semaphore;
+    uint64_t value;
+};
+
+struct JobCounterWrapper {
+    std::shared_ptr<JobCounter> counter;
 };
 
-struct DescriptorBufferBinding {
-    FvDescriptorBufferInfo bufferInfo;
-    FvDescriptorInfo descriptorInfo;
+struct FenceWrapper {
+    // Shared with the completion handlers of the submissions signaling it,
+    // so the fence may be destroyed while they are pending
+    std::shared_ptr<Fence> fence;
 };
 
-struct DescriptorImageBinding {
-    FvDescriptorImageInfo imageInfo;
-    FvDescriptorInfo descriptorInfo;
+struct SwapchainWrapper {
+    FvExtent3D extent;
 };
 
+/** Descriptor set bindings resolved to Metal objects. */
+typedef BindingTable<id<MTLBuffer>, id<MTLTexture>, id<MTLSamplerState>>
+    MetalBindingTable;
+
 // struct DescriptorSetLayoutWrapper {
 //     std::vector<FvDescriptorSetLayoutBinding> descriptorSetLayoutBindings;
 // };
 
 struct DescriptorSetWrapper {
     // FvDescriptorSetLayout descriptorSetLayout;
-    std::vector<DescriptorBufferBinding> bufferBindings;
-    std::vector<DescriptorImageBinding> imageBindings;
-
-    // Gets reference to the buffer descriptor to be bound at the given binding
-    // index.
-    DescriptorBufferBinding *getBufferBinding(uint32_t bindingPoint) {
-        std::vector<DescriptorBufferBinding>::iterator bufferBinding =
-            std::find_if(std::begin(bufferBindings), std::end(bufferBindings),
-                         [&](const DescriptorBufferBinding &binding) {
-                             return binding.descriptorInfo.binding ==
-                                    bindingPoint;
-                         });
-
-        if (bufferBinding == std::end(bufferBindings)) {
-            return nullptr;
-        }
-
-        return &(*bufferBinding);
-    }
 
-    // Gets reference to the image descriptor to be bound at the given binding
-    // index.
-    DescriptorImageBinding *getImageBinding(uint32_t bindingPoint) {
-        std::vector<DescriptorImageBinding>::iterator imageBinding =
-            std::find_if(std::begin(imageBindings), std::end(imageBindings),
-                         [&](const DescriptorImageBinding &binding) {
-                             return binding.descriptorInfo.binding ==
-                                    bindingPoint;
-                         });
-
-        if (imageBinding == std::end(imageBindings)) {
-            return nullptr;
-        }
-
-        return &(*imageBinding);
-    }
+    // Resolved when the descriptor set is updated, so binding it at submit
+    // looks up no handles. Holds a reference to every bound object. Kept on
+    // the heap, as recorded binds point at it and the store moves its
+    // objects when it grows.
+    std::unique_ptr<MetalBindingTable> bindings;
 };
 
 // struct DescriptorPoolWrapper {
@@ -229,39 +267,29 @@ struct DescriptorSetWrapper {
 //     uint32_t maxSets;
 // };
 
+/**
+ * Handle layout of every object handed out by the MetalWrapper. Transient
+ * objects are re-created every frame, which would wrap the 8-bit generation of
+ * a compact Handle within seconds and let stale handles alias new objects.
+ *
+ * The same handles are recorded into command streams.
+ */
+typedef CommandHandle ObjectHandle;
+
+/** Store for objects handed out by the MetalWrapper. */
+template <typename T>
+using ObjectStore = PagedPersistentHandleDataStore<T, ObjectHandle>;
+
 class MetalWrapper {
   public:
-    static const uint32_t MAX_NUM_LIBRARIES          = 64;
-    static const uint32_t MAX_NUM_RENDER_PASSES      = 64;
-    static const uint32_t MAX_NUM_GRAPHICS_PIPELINES = 64;
-    static const uint32_t MAX_NUM_TEXTURES           = 256;
-    static const uint32_t MAX_NUM_FRAMEBUFFERS       = 64;
-    static const uint32_t MAX_NUM_COMMAND_QUEUES     = 64;
-    static const uint32_t MAX_NUM_COMMAND_BUFFERS    = 64;
-    static const uint32_t MAX_NUM_DRAWABLES          = 32;
-    static const uint32_t MAX_NUM_SEMAPHORES         = 32;
-    static const uint32_t MAX_NUM_SWAPCHAINS         = 16;
-    static const uint32_t MAX_NUM_BUFFERS            = 256;
-    // static const uint32_t MAX_NUM_DESCRIPTOR_SET_LAYOUTS = 256;
-    // static const uint32_t MAX_NUM_DESCRIPTOR_POOLS       = 64;
-    static const uint32_t MAX_NUM_DESCRIPTOR_SETS = 512;
-    static const uint32_t MAX_NUM_SAMPLERS        = 512;
-
     MetalWrapper()
-        : metalLayer(NULL), device(nil), libraries(MAX_NUM_LIBRARIES),
-          renderPasses(MAX_NUM_RENDER_PASSES),
-          graphicsPipelines(MAX_NUM_GRAPHICS_PIPELINES),
-          textures(MAX_NUM_TEXTURES), framebuffers(MAX_NUM_FRAMEBUFFERS),
-          commandQueues(MAX_NUM_COMMAND_QUEUES),
-          commandBuffers(MAX_NUM_COMMAND_BUFFERS),
-          semaphores(MAX_NUM_SEMAPHORES), swapchains(MAX_NUM_SWAPCHAINS),
-          buffers(MAX_NUM_BUFFERS),
-          // descriptorSetLayouts(MAX_NUM_DESCRIPTOR_SET_LAYOUTS),
-          // descriptorPools(MAX_NUM_DESCRIPTOR_POOLS),
-          descriptorSets(MAX_NUM_DESCRIPTOR_SETS), samplers(MAX_NUM_SAMPLERS) {}
+        : metalLayer(NULL), device(nil), nativeIndirectDraws(false),
+          queueHandles(), submittedSerial(0), submitFailed(false) {}
 
     FvResult init(const FvInitInfo *initInfo);
 
+    FvResult getQueue(FvQueueType type, FvQueue *queue);
+
     void shutdown();
 
     FvResult descriptorSetCreate(FvDescriptorSet *descriptorSet,
@@ -277,12 +305,69 @@ class MetalWrapper {
 
     void bufferDestroy(FvBuffer buffer);
 
+    FvResult buffersCreate(uint32_t count,
+                           const FvBufferCreateInfo *createInfos,
+                           FvBuffer *buffers);
+
+    void buffersDestroy(uint32_t count, const FvBuffer *buffers);
+
+    /**
+     * Create the Metal buffer described by the given creation parameters.
+     *
+     * \return Retained buffer or nil on failure.
+     */
+    id<MTLBuffer> newMtlBuffer(const FvBufferCreateInfo *createInfo);
+
     void bufferReplaceData(FvBuffer buffer, void *data, size_t dataSize);
 
+    FvResult bufferUpdateRange(FvBuffer buffer, FvSize offset,
+                               const void *data, FvSize size);
+
+    FvResult bufferMap(FvBuffer buffer, void **data);
+
+    FvResult bufferFlushRanges(FvBuffer buffer, uint32_t rangeCount,
+                               const FvBufferRange *ranges);
+
+    void bufferUnmap(FvBuffer buffer);
+
     FvResult semaphoreCreate(FvSemaphore *semaphore);
 
     void semaphoreDestroy(FvSemaphore semaphore);
 
+    FvResult semaphoreCreateTimeline(FvSemaphore *semaphore,
+                                     uint64_t initialValue);
+
+    FvResult semaphoreSignal(FvSemaphore semaphore, uint64_t value);
+
+    FvResult semaphoreWait(FvSemaphore semaphore, uint64_t value,
+                           uint64_t timeout);
+
+    FvResult semaphoreGetCounterValue(FvSemaphore semaphore, uint64_t *value);
+
+    FvResult jobCounterCreate(FvJobCounter *counter);
+
+    void jobCounterDestroy(FvJobCounter counter);
+
+    void jobCounterWait(FvJobCounter counter);
+
+    FvResult jobRun(FvJobFunction function, void *userData,
+                    FvJobCounter counter, FvJobCounter dependency);
+
+    FvResult parallelFor(uint32_t count, uint32_t grainSize,
+                         FvParallelForFunction function, void *userData);
+
+    FvResult fenceCreate(FvFence *fence, const FvFenceCreateInfo *createInfo);
+
+    void fenceDestroy(FvFence fence);
+
+    void fenceReset(FvFence fence);
+
+    FvResult fenceWait(FvFence fence, uint64_t timeout);
+
+    FvResult fenceGetStatus(FvFence fence);
+
+    void deviceWaitIdle();
+
     FvResult acquireNextImage(FvSwapchain swapchain,
                               FvSemaphore imageAvailableSemaphore);
 
@@ -296,7 +381,7 @@ class MetalWrapper {
     void queuePresent(const FvPresentInfo *presentInfo);
 
     FvResult queueSubmit(uint32_t submissionsCount,
-                         const FvSubmitInfo *submissions);
+                         const FvSubmitInfo *submissions, FvFence fence);
 
     // FvResult getDrawable(FvDrawable *drawable);
 
@@ -315,7 +400,13 @@ class MetalWrapper {
     void cmdBindDescriptorSets(FvCommandBuffer commandBuffer,
                                FvPipelineLayout layout, uint32_t firstSet,
                                uint32_t descriptorSetCount,
-                               const FvDescriptorSet *descriptorSets);
+                               const FvDescriptorSet *descriptorSets,
+                               uint32_t dynamicOffsetCount,
+                               const uint32_t *dynamicOffsets);
+
+    void cmdPushConstants(FvCommandBuffer commandBuffer,
+                          FvPipelineLayout layout, int stageFlags,
+                          uint32_t offset, uint32_t size, const void *values);
 
     void cmdDraw(FvCommandBuffer commandBuffer, uint32_t vertexCount,
                  uint32_t instanceCount, uint32_t firstVertex,
@@ -325,16 +416,43 @@ class MetalWrapper {
                         uint32_t instanceCount, uint32_t firstIndex,
                         int32_t vertexOffset, uint32_t firstInstance);
 
+    void cmdDrawIndirect(FvCommandBuffer commandBuffer, FvBuffer buffer,
+                         FvSize offset, uint32_t drawCount, uint32_t stride);
+
+    void cmdDrawIndexedIndirect(FvCommandBuffer commandBuffer, FvBuffer buffer,
+                                FvSize offset, uint32_t drawCount,
+                                uint32_t stride);
+
     void cmdBeginRenderPass(FvCommandBuffer commandBuffer,
                             const FvRenderPassBeginInfo *renderPassInfo);
 
     void cmdEndRenderPass(FvCommandBuffer commandBuffer);
 
+    void cmdExecuteCommands(FvCommandBuffer commandBuffer,
+                            uint32_t commandBufferCount,
+                            const FvCommandBuffer *secondaries);
+
+    void cmdCopyBuffer(FvCommandBuffer commandBuffer, FvBuffer srcBuffer,
+                       FvBuffer dstBuffer, uint32_t regionCount,
+                       const FvBufferCopy *regions);
+
+    void cmdCopyBufferToImage(FvCommandBuffer commandBuffer,
+                              FvBuffer srcBuffer, FvImage dstImage,
+                              uint32_t regionCount,
+                              const FvBufferImageCopy *regions);
+
     FvResult commandBufferCreate(FvCommandBuffer *commandBuffer,
-                                 FvCommandPool commandPool);
+                                 FvCommandPool commandPool, bool secondary);
+
+    void commandBufferDestroy(FvCommandBuffer commandBuffer);
 
     void commandBufferBegin(FvCommandBuffer commandBuffer);
 
+    void commandBufferReset(FvCommandBuffer commandBuffer);
+
+    void commandBufferGetStatistics(FvCommandBuffer commandBuffer,
+                                    FvCommandBufferStatistics *statistics);
+
     FvResult commandBufferEnd(FvCommandBuffer commandBuffer);
 
     FvResult commandPoolCreate(FvCommandPool *commandPool,
@@ -342,6 +460,8 @@ class MetalWrapper {
 
     void commandPoolDestroy(FvCommandPool commandPool);
 
+    void commandPoolReset(FvCommandPool commandPool);
+
     FvResult framebufferCreate(FvFramebuffer *framebuffer,
                                const FvFramebufferCreateInfo *createInfo);
 
@@ -355,15 +475,51 @@ class MetalWrapper {
 
     void imageDestroy(FvImage image);
 
+    FvResult imagesCreate(uint32_t count, const FvImageCreateInfo *createInfos,
+                          FvImage *images);
+
+    void imagesDestroy(uint32_t count, const FvImage *images);
+
+    /**
+     * Create the Metal texture described by the given creation parameters.
+     *
+     * \param textureDesc Descriptor to fill in, may be shared between calls.
+     * \return            Retained texture or nil on failure.
+     */
+    id<MTLTexture> newMtlTexture(const FvImageCreateInfo *createInfo,
+                                 MTLTextureDescriptor *textureDesc);
+
     FvResult samplerCreate(FvSampler *sampler,
                            const FvSamplerCreateInfo *createInfo);
 
     void samplerDestroy(FvSampler sampler);
 
+    FvResult samplersCreate(uint32_t count,
+                            const FvSamplerCreateInfo *createInfos,
+                            FvSampler *samplers);
+
+    void samplersDestroy(uint32_t count, const FvSampler *samplers);
+
+    /**
+     * Create the Metal sampler state described by the given creation
+     * parameters.
+     *
+     * \param samplerDesc Descriptor to fill in, may be shared between calls.
+     * \return            Retained sampler state or nil on failure.
+     */
+    id<MTLSamplerState>
+    newMtlSamplerState(const FvSamplerCreateInfo *createInfo,
+                       MTLSamplerDescriptor *samplerDesc);
+
     FvResult
     graphicsPipelineCreate(FvGraphicsPipeline *graphicsPipeline,
                            const FvGraphicsPipelineCreateInfo *createInfo);
 
+    FvResult
+    graphicsPipelinesCreate(uint32_t count,
+                            const FvGraphicsPipelineCreateInfo *createInfos,
+                            FvGraphicsPipeline *graphicsPipelines);
+
     void graphicsPipelineDestroy(FvGraphicsPipeline graphicsPipeline);
 
     FvResult renderPassCreate(FvRenderPass *renderPass,
@@ -430,23 +586,285 @@ class MetalWrapper {
     static MTLSamplerBorderColor
     toMtlSamplerBorderColor(FvBorderColor borderColor);
 
+    /**
+     * Get whether a range lies within a buffer.
+     */
+    static bool isRangeInBuffer(id<MTLBuffer> buffer, FvSize offset,
+                                FvSize size);
+
+    /**
+     * Notify the GPU that the CPU modified a range of a buffer's contents.
+     */
+    static void didModifyRange(id<MTLBuffer> buffer, FvSize offset,
+                               FvSize size);
+
+    /**
+     * Bindings carried from one replayed command to the next.
+     */
+    struct EncoderState {
+        EncoderState()
+            : pipeline(nullptr), appliedPipeline(nullptr), indexBuffer(nullptr),
+              indexType(MTLIndexTypeUInt16), indexBufferOffset(0),
+              pushConstantsSize(0), numElidedStateChanges(0) {}
+
+        GraphicsPipelineWrapper *pipeline;
+        // Pipeline whose states were last set on the encoder
+        const GraphicsPipelineWrapper *appliedPipeline;
+        // Index buffer used by indexed draws
+        const BufferWrapper *indexBuffer;
+        MTLIndexType indexType;
+        FvSize indexBufferOffset;
+        // Push constants so far, set as a whole because Metal has no partial
+        // updates of inline bytes
+        uint8_t pushConstants[FV_MAX_PUSH_CONSTANTS_SIZE];
+        uint32_t pushConstantsSize;
+        // Pipeline states not set because the encoder already had them
+        uint32_t numElidedStateChanges;
+    };
+
+    /**
+     * Replay the commands recorded into a command buffer into a Metal command
+     * buffer.
+     *
+     * Copies are encoded by 'encodeCopies' in the order they were recorded
+     * in, around the render pass. The render pass is taken from the first
+     * graphics pipeline bound, including those bound by executed secondary
+     * command buffers.
+     *
+     * \return FV_RESULT_FAILURE if neither copies nor a valid graphics
+     *         pipeline were recorded, a transfer command buffer bound a
+     *         graphics pipeline, or the render pass lacks an attachment the
+     *         pipeline uses.
+     */
+    FvResult encodeCommands(CommandBufferWrapper *commandBufferWrapper,
+                            id<MTLCommandBuffer> commandBuffer);
+
+    /**
+     * Make the render pass descriptor of one submission: a copy of the
+     * pipeline's, which every command buffer using the pipeline shares,
+     * filled out with the attachments and clear values the command buffer
+     * began its render pass with.
+     *
+     * \return Descriptor the caller owns, or nil if the pipeline uses an
+     *         attachment that has no framebuffer attachment or clear value.
+     */
+    MTLRenderPassDescriptor *
+    newRenderPassDescriptor(const GraphicsPipelineWrapper *pipelineWrapper,
+                            const CommandBufferWrapper *commandBufferWrapper);
+
+    /**
+     * Encode the copies among a range of the commands recorded into a command
+     * stream with a blit encoder.
+     *
+     * \param first Index of the first command of the range.
+     * \param last  Index of the command past the range, clamped to the end
+     *              of the stream.
+     * \return      Whether the range recorded any copies.
+     */
+    bool encodeCopies(id<MTLCommandBuffer> commandBuffer,
+                      const CommandStream &commands, size_t first,
+                      size_t last);
+
+    /**
+     * Replay a command stream into an encoder, descending into the secondary
+     * command buffers it executes.
+     */
+    void encodeStream(id<MTLRenderCommandEncoder> encoder,
+                      const CommandStream &commands, EncoderState *state);
+
+    /**
+     * Set the fixed-function and render pipeline states of a graphics pipeline
+     * on the encoder, skipping those the encoder already has.
+     */
+    void encodePipelineState(id<MTLRenderCommandEncoder> encoder,
+                             const GraphicsPipelineWrapper *pipeline,
+                             EncoderState *state);
+
+    /**
+     * Get the handle an Fv handle points at, to record into a command stream.
+     *
+     * \return Handle no store holds if \p object is null.
+     */
+    static ObjectHandle getRecordedHandle(const void *object);
+
+    /**
+     * Get the first graphics pipeline bound by a command stream or the
+     * secondary command buffers it executes.
+     *
+     * \return Pipeline or nullptr if no valid graphics pipeline is bound.
+     */
+    GraphicsPipelineWrapper *
+    getFirstGraphicsPipeline(const CommandStream &commands);
+
+    /**
+     * Get the primary command buffer a submission refers to.
+     *
+     * \return Command buffer or nullptr if \p commandBuffer is not a valid
+     *         primary command buffer.
+     */
+    CommandBufferWrapper *
+    getPrimaryCommandBuffer(FvCommandBuffer commandBuffer);
+
+    /**
+     * Get the secondary command buffer an ExecuteCommandsCommand refers to.
+     *
+     * \return Command buffer or nullptr if it is not a valid secondary
+     *         command buffer.
+     */
+    const CommandBufferWrapper *
+    getSecondaryCommandBuffer(const ExecuteCommandsCommand &command);
+
+    /**
+     * Bind a buffer to a slot of a descriptor set, holding a reference to it
+     * in place of the one held to the buffer it replaces.
+     *
+     * Destroying the buffer while the descriptor set refers to it then
+     * leaves the descriptor set with a valid, if stale, buffer.
+     */
+    static void setBoundBuffer(MetalBindingTable *bindings, uint32_t binding,
+                               id<MTLBuffer> buffer, FvSize offset);
+
+    /**
+     * Bind a texture and sampler to a slot of a descriptor set, holding a
+     * reference to each in place of the ones held to those they replace.
+     */
+    static void setBoundImage(MetalBindingTable *bindings, uint32_t binding,
+                              id<MTLTexture> texture,
+                              id<MTLSamplerState> sampler);
+
+    /**
+     * Release the references a descriptor set holds to its bound objects.
+     */
+    static void releaseBindings(MetalBindingTable *bindings);
+
+    /**
+     * Bind the resolved buffers and images of a descriptor set to the
+     * encoder.
+     *
+     * \param dynamicOffsets One offset per dynamic buffer slot of \p
+     *                       bindings, added to the slot's offset.
+     */
+    static void encodeDescriptorSet(id<MTLRenderCommandEncoder> encoder,
+                                    const MetalBindingTable *bindings,
+                                    const uint32_t *dynamicOffsets);
+
+    /**
+     * Add an object to one of the object stores under 'objectMutex'. Every
+     * store adds through here, so none grows while another thread reads it.
+     *
+     * \return Handle or nullptr if the object could not be added.
+     */
+    template <typename T>
+    const ObjectHandle *addObject(ObjectStore<T> &store, T object) {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        return store.add(std::move(object));
+    }
+
+    /**
+     * Destroy an object once every submission made so far has completed.
+     *
+     * Runs any earlier destructions that are no longer in flight.
+     *
+     * \param destroy Function destroying the object.
+     */
+    void deferDestroy(DeferredDestructionQueue::Destroyer destroy);
+
+    /**
+     * Make submissions, on the submit thread with asynchronous submission.
+     *
+     * Every submission completes, signaling its semaphores and the fence,
+     * even when some of its command buffers could not be submitted.
+     *
+     * \param firstSerial Serial of the first submission, reserved by
+     *                    'queueSubmit'.
+     */
+    FvResult submit(uint32_t submissionsCount, const FvSubmitInfo *submissions,
+                    std::shared_ptr<Fence> fenceObject, uint64_t firstSerial);
+
+    /**
+     * Build the Metal states of a graphics pipeline, without adding it.
+     *
+     * Called from several jobs at once by 'graphicsPipelinesCreate', so only
+     * reads the object stores.
+     *
+     * \param [out]built Pipeline and the reflection for its shader modules,
+     *                   left untouched on failure.
+     */
+    FvResult
+    buildGraphicsPipeline(const FvGraphicsPipelineCreateInfo *createInfo,
+                          BuiltGraphicsPipeline *built);
+
+    /**
+     * Get the counter of a job counter handle.
+     *
+     * \return Counter or nullptr if \p counter is not a valid job counter.
+     */
+    JobCounter *getJobCounter(FvJobCounter counter);
+
+    /**
+     * Get the semaphore a handle refers to.
+     *
+     * \return Semaphore or nullptr if \p semaphore is not a valid semaphore.
+     */
+    SemaphoreWrapper *getSemaphore(FvSemaphore semaphore);
+
+    /**
+     * Get the timeline of a semaphore.
+     *
+     * \return Timeline or nullptr if \p semaphore is not a valid timeline
+     *         semaphore.
+     */
+    std::shared_ptr<TimelineSemaphore>
+    getTimelineSemaphore(FvSemaphore semaphore);
+
     CAMetalLayer *metalLayer;
     id<MTLDevice> device;
 
-    PersistentHandleDataStore<ShaderModuleWrapper> libraries;
-    PersistentHandleDataStore<RenderPassWrapper> renderPasses;
-    PersistentHandleDataStore<GraphicsPipelineWrapper> graphicsPipelines;
-    PersistentHandleDataStore<ImageWrapper> textures;
-    PersistentHandleDataStore<FramebufferWrapper> framebuffers;
-    PersistentHandleDataStore<id<MTLCommandQueue>> commandQueues;
-    PersistentHandleDataStore<CommandBufferWrapper> commandBuffers;
-    PersistentHandleDataStore<SemaphoreWrapper> semaphores;
-    PersistentHandleDataStore<SwapchainWrapper> swapchains;
-    PersistentHandleDataStore<BufferWrapper> buffers;
-    PersistentHandleDataStore<DescriptorSetWrapper> descriptorSets;
-    PersistentHandleDataStore<id<MTLSamplerState>> samplers;
+    /** Whether the GPU reads indirect draw arguments itself, if not they are
+     * read from the buffer at submit. */
+    bool nativeIndirectDraws;
+
+    ObjectStore<ShaderModuleWrapper> libraries;
+    ObjectStore<RenderPassWrapper> renderPasses;
+    ObjectStore<GraphicsPipelineWrapper> graphicsPipelines;
+    ObjectStore<PipelineLayoutWrapper> pipelineLayouts;
+    ObjectStore<ImageWrapper> textures;
+    ObjectStore<FramebufferWrapper> framebuffers;
+    ObjectStore<CommandPoolWrapper> commandPools;
+    ObjectStore<CommandBufferWrapper> commandBuffers;
+    ObjectStore<SemaphoreWrapper> semaphores;
+    ObjectStore<FenceWrapper> fences;
+    ObjectStore<JobCounterWrapper> jobCounters;
+    ObjectStore<SwapchainWrapper> swapchains;
+    ObjectStore<BufferWrapper> buffers;
+    ObjectStore<DescriptorSetWrapper> descriptorSets;
+    ObjectStore<id<MTLSamplerState>> samplers;
 
     id<CAMetalDrawable> currentDrawable;
-    id<MTLCommandQueue> currentCommandQueue;
+
+    /** Queue of each FvQueueType, created by 'init'. */
+    static const uint32_t NUM_QUEUE_TYPES = 2;
+    ObjectStore<QueueWrapper> queues;
+    const ObjectHandle *queueHandles[NUM_QUEUE_TYPES];
+
+    /** Serial of the last submission made, see DeferredDestructionQueue. */
+    uint64_t submittedSerial;
+    /** Submissions the GPU has finished, which may be out of order. */
+    SerialTracker completedSerials;
+    /** Destroyed objects the GPU may still be using. */
+    DeferredDestructionQueue destructionQueue;
+
+    /** Makes submissions with asynchronous submission, null otherwise. */
+    std::unique_ptr<SubmitThread> submitThread;
+    /** Guards what 'submit' reads, which may be on the submit thread: the
+     * object stores, and the contents of command buffers and descriptor sets.
+     * Taken by the application thread to change them, e.g. by every add
+     * through 'addObject', and by 'submit' to encode. */
+    std::mutex objectMutex;
+    /** Set by the submit thread when a submission fails. */
+    std::atomic<bool> submitFailed;
+
+    /** Runs the application's jobs and Fever's own, created by 'init'. */
+    std::unique_ptr<JobSystem> jobs;
 };
 }
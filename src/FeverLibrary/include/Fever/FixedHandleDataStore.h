@@ -0,0 +1,146 @@
+/*===-- Fever/FixedHandleDataStore.h - Fixed-capacity store -------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Container for data referred to by handle that never allocates.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <type_traits>
+
+#include <Fever/Handle.h>
+
+namespace fv {
+/**
+ * Fixed-capacity variant of the HandleDataStore for objects created and
+ * destroyed on hot paths.
+ *
+ * - All storage is inline, so the store lives wherever its owner puts it.
+ * - Free slots form an intrusive list threaded through the unused object
+ *   storage, no separate free index container is needed.
+ * - No member function ever allocates memory.
+ *
+ * \tparam CAPACITY   Maximum number of live objects.
+ * \tparam HandleType BasicHandle layout of the handles given out, see Handle
+ *                    and Handle64.
+ */
+template <typename T, uint32_t CAPACITY, typename HandleType = Handle>
+class FixedHandleDataStore {
+  public:
+    static_assert(CAPACITY > 0, "FixedHandleDataStore needs a capacity.");
+    static_assert(CAPACITY - 1 <= HandleType::HANDLE_INDEX_MASK,
+                  "Capacity is larger than the Handle can index.");
+
+    FixedHandleDataStore();
+
+    ~FixedHandleDataStore();
+
+    FixedHandleDataStore(const FixedHandleDataStore &) = delete;
+    FixedHandleDataStore &operator=(const FixedHandleDataStore &) = delete;
+
+    /**
+     * \copydoc HandleDataStore::isValid
+     */
+    bool isValid(HandleType handle) const;
+
+    /**
+     * Add a new object to the data store.
+     *
+     * \param  object      Reference to object to add.
+     * \param  [out]handle Handle referring to the added object.
+     * \return             True if the object was added, false if the store is
+     *                     full.
+     */
+    bool add(const T &object, HandleType *handle);
+
+    /**
+     * Move a new object into the data store.
+     *
+     * \param  object      Object to move into the store.
+     * \param  [out]handle Handle referring to the added object.
+     * \return             True if the object was added, false if the store is
+     *                     full.
+     */
+    bool add(T &&object, HandleType *handle);
+
+    /**
+     * Construct a new object in place in the data store.
+     *
+     * \param  [out]handle Handle referring to the added object.
+     * \param  args        Arguments forwarded to the constructor of the object.
+     * \return             True if the object was added, false if the store is
+     *                     full.
+     */
+    template <typename... Args>
+    bool emplace(HandleType *handle, Args &&... args);
+
+    /**
+     * \copydoc HandleDataStore::remove
+     */
+    void remove(HandleType handle);
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle) const
+     */
+    const T *get(HandleType handle) const;
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle)
+     */
+    T *get(HandleType handle);
+
+    /**
+     * Get the maximum number of live objects the store can hold.
+     */
+    uint32_t capacity() const { return CAPACITY; }
+
+    /**
+     * Get the number of live objects.
+     */
+    uint32_t size() const { return numLive; }
+
+  private:
+    /** Marks the end of the free slot list. */
+    static const uint32_t FREE_LIST_END = 0xFFFFFFFF;
+
+    struct Slot {
+        union {
+            /** The object, while the slot is live. */
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            /** The next free slot, while the slot is free. */
+            uint32_t nextFree;
+        };
+        typename HandleType::GenerationType generation;
+        bool live;
+    };
+
+    /**
+     * Get the object stored in the given slot.
+     *
+     * \pre The slot holds a constructed object.
+     */
+    T *getObject(uint32_t index) {
+        return reinterpret_cast<T *>(&slots[index].storage);
+    }
+    const T *getObject(uint32_t index) const {
+        return reinterpret_cast<const T *>(&slots[index].storage);
+    }
+
+    /**
+     * \copydoc HandleDataStore::makeHandle
+     */
+    HandleType makeHandle(uint32_t index,
+                          typename HandleType::GenerationType generation) const;
+
+    Slot slots[CAPACITY];
+    uint32_t firstFree;
+    uint32_t numLive;
+};
+}
+
+#include <Fever/FixedHandleDataStore.hpp>
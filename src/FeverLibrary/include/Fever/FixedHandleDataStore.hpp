@@ -0,0 +1,124 @@
+#include <cassert>
+#include <new>
+#include <utility>
+
+#include <Fever/FixedHandleDataStore.h>
+
+namespace fv {
+template <typename T, uint32_t CAPACITY, typename HandleType>
+FixedHandleDataStore<T, CAPACITY, HandleType>::FixedHandleDataStore()
+    : firstFree(0), numLive(0) {
+    // Thread every slot onto the free list in order
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        slots[i].nextFree   = i + 1;
+        slots[i].generation = 0;
+        slots[i].live       = false;
+    }
+    slots[CAPACITY - 1].nextFree = FREE_LIST_END;
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+FixedHandleDataStore<T, CAPACITY, HandleType>::~FixedHandleDataStore() {
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        if (slots[i].live) {
+            getObject(i)->~T();
+        }
+    }
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+bool FixedHandleDataStore<T, CAPACITY, HandleType>::isValid(
+    HandleType handle) const {
+    const uint32_t index = handle.getIndex();
+
+    return (index < CAPACITY && slots[index].live &&
+            slots[index].generation == handle.getGeneration());
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+bool FixedHandleDataStore<T, CAPACITY, HandleType>::add(const T &object,
+                                                        HandleType *handle) {
+    return emplace(handle, object);
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+bool FixedHandleDataStore<T, CAPACITY, HandleType>::add(T &&object,
+                                                        HandleType *handle) {
+    return emplace(handle, std::move(object));
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+template <typename... Args>
+bool FixedHandleDataStore<T, CAPACITY, HandleType>::emplace(
+    HandleType *handle, Args &&... args) {
+    assert(handle != nullptr);
+
+    if (firstFree == FREE_LIST_END) {
+        return false;
+    }
+
+    const uint32_t index = firstFree;
+    Slot &slot           = slots[index];
+
+    // The link is overwritten by the object, so unlink the slot first
+    firstFree = slot.nextFree;
+
+    new (&slot.storage) T(std::forward<Args>(args)...);
+    slot.live = true;
+    ++numLive;
+
+    *handle = makeHandle(index, slot.generation);
+
+    return true;
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+void FixedHandleDataStore<T, CAPACITY, HandleType>::remove(HandleType handle) {
+    // Only try to destroy valid Entities.
+    if (!isValid(handle)) {
+        return;
+    }
+
+    const uint32_t index = handle.getIndex();
+    Slot &slot           = slots[index];
+
+    getObject(index)->~T();
+    slot.live       = false;
+    slot.generation = (slot.generation + 1) & HandleType::HANDLE_MAX_GENERATION;
+    --numLive;
+
+    // The freed storage now holds the free list link
+    slot.nextFree = firstFree;
+    firstFree     = index;
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+const T *
+FixedHandleDataStore<T, CAPACITY, HandleType>::get(HandleType handle) const {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return getObject(handle.getIndex());
+    }
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+T *FixedHandleDataStore<T, CAPACITY, HandleType>::get(HandleType handle) {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return getObject(handle.getIndex());
+    }
+}
+
+template <typename T, uint32_t CAPACITY, typename HandleType>
+HandleType FixedHandleDataStore<T, CAPACITY, HandleType>::makeHandle(
+    uint32_t index, typename HandleType::GenerationType generation) const {
+    typedef typename HandleType::IdType IdType;
+
+    HandleType handle;
+    handle.id = ((IdType)generation << HandleType::HANDLE_INDEX_BITS) + index;
+
+    return handle;
+}
+}
@@ -0,0 +1,120 @@
+/*===-- Fever/FramesInFlight.h - Per-frame resources --------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Cycles through copies of per-frame resources so the CPU can record a
+ * frame while the GPU still renders earlier ones.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * A fixed number of frame slots, each holding the resources one frame
+ * writes on the CPU and reads on the GPU, e.g. its uniform buffers and
+ * command buffer, guarded by a fence.
+ *
+ * 'beginFrame' moves on to the next slot and waits until the GPU has finished
+ * the frame that used it last, so with N slots the CPU runs up to N - 1
+ * frames ahead of the GPU. The frame's last submission signals the slot's
+ * fence:
+ *
+ * \code
+ * frames.beginFrame(FV_WAIT_FOREVER);
+ * // ... overwrite frames.getFrame() and record its command buffer ...
+ * fvQueueSubmit(1, &submitInfo, frames.getSubmitFence());
+ * \endcode
+ *
+ * \tparam Frame Resources of one frame, default constructible.
+ */
+template <typename Frame> class FramesInFlight {
+  public:
+    /** Lets the CPU record one frame while the GPU renders the previous. */
+    static const uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+    /**
+     * \param numFrames Number of frame slots, at least 1.
+     */
+    explicit FramesInFlight(uint32_t numFrames = DEFAULT_FRAMES_IN_FLIGHT);
+
+    /**
+     * Destroys the fences, the resources of each frame are destroyed by their
+     * owner, after 'waitIdle'.
+     */
+    ~FramesInFlight();
+
+    FramesInFlight(const FramesInFlight &) = delete;
+    FramesInFlight &operator=(const FramesInFlight &) = delete;
+
+    /**
+     * Create the fence of every frame slot.
+     *
+     * \pre Fever has been initialized.
+     */
+    FvResult init();
+
+    /**
+     * Move on to the next frame slot, waiting until the GPU has finished with
+     * it.
+     *
+     * \param  timeout Nanoseconds to wait for at most, see fvFenceWait.
+     * \return         FV_RESULT_TIMEOUT if the slot is still in use, in which
+     *                 case the current frame doesn't change.
+     */
+    FvResult beginFrame(uint64_t timeout);
+
+    /**
+     * Get the fence for the last submission of the current frame to signal,
+     * reset so that the next 'beginFrame' on this slot waits for it.
+     *
+     * A frame that never asks for its fence doesn't hold up the slot.
+     */
+    FvFence getSubmitFence();
+
+    /**
+     * Wait until the GPU has finished every frame, e.g. before destroying
+     * their resources.
+     *
+     * \param timeout Nanoseconds to wait for each frame at most.
+     */
+    FvResult waitIdle(uint64_t timeout);
+
+    /**
+     * Get the resources of the current frame.
+     *
+     * \pre 'beginFrame' has succeeded.
+     */
+    Frame &getFrame() { return frames[current]; }
+
+    /**
+     * Get the resources of a frame slot, e.g. to create or destroy them.
+     */
+    Frame &getFrame(uint32_t index) { return frames[index]; }
+
+    /**
+     * Get the slot of the current frame.
+     */
+    uint32_t getFrameIndex() const { return current; }
+
+    /**
+     * Get the number of frame slots.
+     */
+    uint32_t size() const { return (uint32_t)frames.size(); }
+
+  private:
+    std::vector<Frame> frames;
+    std::vector<FvFence> fences;
+    uint32_t current;
+};
+}
+
+#include <Fever/FramesInFlight.hpp>
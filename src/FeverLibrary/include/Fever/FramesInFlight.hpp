@@ -0,0 +1,68 @@
+#include <cassert>
+
+#include <Fever/FramesInFlight.h>
+
+namespace fv {
+template <typename Frame>
+FramesInFlight<Frame>::FramesInFlight(uint32_t numFrames)
+    : frames(numFrames), fences(numFrames, FV_NULL_HANDLE),
+      current(numFrames - 1) {
+    assert(numFrames > 0 && "Need at least one frame in flight.");
+}
+
+template <typename Frame> FramesInFlight<Frame>::~FramesInFlight() {
+    // Pending submissions keep their fences alive until they complete
+    for (size_t i = 0; i < fences.size(); ++i) {
+        if (fences[i] != FV_NULL_HANDLE) {
+            fvFenceDestroy(fences[i]);
+        }
+    }
+}
+
+template <typename Frame> FvResult FramesInFlight<Frame>::init() {
+    // Signaled, as no frame has used its slot yet
+    FvFenceCreateInfo createInfo = {};
+    createInfo.signaled          = FV_TRUE;
+
+    for (size_t i = 0; i < fences.size(); ++i) {
+        if (fences[i] == FV_NULL_HANDLE &&
+            fvFenceCreate(&fences[i], &createInfo) != FV_RESULT_SUCCESS) {
+            return FV_RESULT_FAILURE;
+        }
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+template <typename Frame>
+FvResult FramesInFlight<Frame>::beginFrame(uint64_t timeout) {
+    const uint32_t next = (current + 1) % size();
+
+    const FvResult result = fvFenceWait(fences[next], timeout);
+
+    if (result == FV_RESULT_SUCCESS) {
+        current = next;
+    }
+
+    return result;
+}
+
+template <typename Frame> FvFence FramesInFlight<Frame>::getSubmitFence() {
+    fvFenceReset(fences[current]);
+
+    return fences[current];
+}
+
+template <typename Frame>
+FvResult FramesInFlight<Frame>::waitIdle(uint64_t timeout) {
+    for (size_t i = 0; i < fences.size(); ++i) {
+        const FvResult result = fvFenceWait(fences[i], timeout);
+
+        if (result != FV_RESULT_SUCCESS) {
+            return result;
+        }
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+}
@@ -16,42 +16,67 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
 namespace fv {
 /**
  * An handle is merely a unique identifier.
  *
  * This unique identifier is made up of two parts:
- *     - an index (lower, less significant X bits)
- *     - a generation (higher, more significant Y bits)
+ *     - an index (lower, less significant INDEX_BITS bits)
+ *     - a generation (higher, more significant remaining bits)
  * Each time an index is re-used it's generation is increased,
  * this allows us to check if an Handle id is valid or not.
+ *
+ * Once the generation of an index wraps around, a stale Handle to that index
+ * looks valid again. The more generation bits, the more re-uses of a single
+ * index it takes for that to happen.
+ *
+ * \tparam IdT        Unsigned integer type holding the whole id.
+ * \tparam INDEX_BITS Number of bits of the id making up the index.
  */
-class Handle {
+template <typename IdT, uint8_t INDEX_BITS> class BasicHandle {
   public:
+    /** Unsigned integer type holding the whole id. */
+    typedef IdT IdType;
+
+    static_assert(std::is_unsigned<IdType>::value,
+                  "Handle id type must be an unsigned integer.");
+    static_assert(INDEX_BITS > 0 && INDEX_BITS < sizeof(IdType) * 8,
+                  "Handle needs at least one index and one generation bit.");
+
     /**
      * Get the index part of the Handle id.
      *
-     * @return     unsigned int, index part of Handle id.
+     * @return     IdType, index part of Handle id.
      */
-    unsigned int getIndex() const;
+    IdType getIndex() const {
+        // Bitwise AND id with index mask to get index bits only
+        return (id & HANDLE_INDEX_MASK);
+    }
 
     /**
      * Get the generation part of the Handle id.
      *
-     * @return     unsigned int, generation part of Handle id.
+     * @return     IdType, generation part of Handle id.
      */
-    unsigned int getGeneration() const;
+    IdType getGeneration() const {
+        // Bitwise AND id with gen mask to get gen bits only
+        return (id & HANDLE_GENERATION_MASK) >> HANDLE_INDEX_BITS;
+    }
 
     /**
      * Equality operator.
      */
-    bool operator==(const Handle &other) const;
+    bool operator==(const BasicHandle &other) const {
+        return (id == other.id);
+    }
 
     /** Number of bits making up index */
-    static const uint8_t HANDLE_INDEX_BITS = 24;
+    static const uint8_t HANDLE_INDEX_BITS = INDEX_BITS;
     /** Number of bits making up generation */
-    static const uint8_t HANDLE_GENERATION_BITS = 8;
+    static const uint8_t HANDLE_GENERATION_BITS =
+        sizeof(IdType) * 8 - INDEX_BITS;
 
     /**
      * Index mask.
@@ -61,11 +86,51 @@ class Handle {
      *  Subtracting 1 from this will leave 1s in all 22 bits and 0s elsewhere,
      *  forming a mask for the index bits.
      */
-    static const uint32_t HANDLE_INDEX_MASK = (1 << HANDLE_INDEX_BITS) - 1;
+    static const IdType HANDLE_INDEX_MASK =
+        ((IdType)1 << HANDLE_INDEX_BITS) - 1;
     /** Generation mask */
-    static const uint32_t HANDLE_GENERATION_MASK = ~HANDLE_INDEX_MASK;
+    static const IdType HANDLE_GENERATION_MASK = (IdType)~HANDLE_INDEX_MASK;
+
+    /** Largest generation, the generation after it is zero again. */
+    static const IdType HANDLE_MAX_GENERATION =
+        HANDLE_GENERATION_MASK >> HANDLE_INDEX_BITS;
+
+    /** Smallest unsigned type able to hold a generation. */
+    typedef typename std::conditional<
+        (HANDLE_GENERATION_BITS <= 8), uint8_t,
+        typename std::conditional<
+            (HANDLE_GENERATION_BITS <= 16), uint16_t,
+            typename std::conditional<(HANDLE_GENERATION_BITS <= 32),
+                                      uint32_t, uint64_t>::type>::type>::type
+        GenerationType;
 
     /** Unique identifier */
-    uint32_t id;
+    IdType id;
 };
+
+template <typename IdT, uint8_t INDEX_BITS>
+const uint8_t BasicHandle<IdT, INDEX_BITS>::HANDLE_INDEX_BITS;
+template <typename IdT, uint8_t INDEX_BITS>
+const uint8_t BasicHandle<IdT, INDEX_BITS>::HANDLE_GENERATION_BITS;
+template <typename IdT, uint8_t INDEX_BITS>
+const IdT BasicHandle<IdT, INDEX_BITS>::HANDLE_INDEX_MASK;
+template <typename IdT, uint8_t INDEX_BITS>
+const IdT BasicHandle<IdT, INDEX_BITS>::HANDLE_GENERATION_MASK;
+template <typename IdT, uint8_t INDEX_BITS>
+const IdT BasicHandle<IdT, INDEX_BITS>::HANDLE_MAX_GENERATION;
+
+/**
+ * Compact handle: 24 index bits and 8 generation bits.
+ *
+ * The generation wraps after 256 re-uses of an index.
+ */
+typedef BasicHandle<uint32_t, 24> Handle;
+
+/**
+ * Wide handle: 32 index bits and 32 generation bits.
+ *
+ * Use for objects that are destroyed and re-created often enough for the
+ * generation of a compact Handle to wrap around.
+ */
+typedef BasicHandle<uint64_t, 32> Handle64;
 }
@@ -15,7 +15,9 @@
  *===----------------------------------------------------------------------===*/
 #pragma once
 
+#include <memory>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
 #include <Fever/Handle.h>
@@ -26,9 +28,26 @@ namespace fv {
  *
  * - Re-uses expired handle IDs.
  * - Prevents duplication of handle IDs.
+ * - Destroys objects as soon as they are removed, so resources they own are
+ *   released immediately rather than when their slot is re-used.
+ *
+ * Growing the store moves objects, invalidating pointers returned by 'get'.
+ *
+ * \tparam HandleType BasicHandle layout of the handles given out, see Handle
+ *                    and Handle64.
  */
-template <typename T> class HandleDataStore {
+template <typename T, typename HandleType = Handle> class HandleDataStore {
   public:
+    static_assert(HandleType::HANDLE_INDEX_BITS <= 32,
+                  "HandleDataStore indices are limited to 32 bits.");
+
+    HandleDataStore() : numSlots(0) {}
+
+    ~HandleDataStore();
+
+    HandleDataStore(const HandleDataStore &) = delete;
+    HandleDataStore &operator=(const HandleDataStore &) = delete;
+
     /**
      * Handle id's are a weak reference. This method checks to see if the id is
      * valid.
@@ -41,35 +60,58 @@ template <typename T> class HandleDataStore {
      * \param  handle Handle to check for validity.
      * \return        True if handle id is valid, false otherwise.
      */
-    bool isValid(Handle handle) const;
+    bool isValid(HandleType handle) const;
 
     /**
      * Add a new object to the data store.
      *
      * \param  object Reference to object to add.
-     * \return        Handle, created handle.
+     * \return        HandleType, created handle.
+     */
+    HandleType add(const T &object);
+
+    /**
+     * Move a new object into the data store.
+     *
+     * \param  object Object to move into the store.
+     * \return        HandleType, created handle.
+     */
+    HandleType add(T &&object);
+
+    /**
+     * Construct a new object in place in the data store.
+     *
+     * \param  args Arguments forwarded to the constructor of the object.
+     * \return      HandleType, created handle.
      */
-    Handle add(const T &object);
+    template <typename... Args> HandleType emplace(Args &&... args);
+
+    /**
+     * Make room for adding the given number of objects without growing.
+     *
+     * \param count Number of objects about to be added.
+     */
+    void reserve(uint32_t count);
 
     /**
      * Remove the object referred to by the given handle from the data store.
      *
-     * Release the Handle's id so it can be re-used and invalidate any current
-     * references to the Handle.
+     * Destroy the object, release the Handle's id so it can be re-used and
+     * invalidate any current references to the Handle.
      *
      * \param handle Handle to destroy.
      */
-    void remove(Handle handle);
+    void remove(HandleType handle);
 
     /**
      * Get pointer to element with given handle or nullptr if handle invalid.
      */
-    const T *get(Handle handle) const;
+    const T *get(HandleType handle) const;
 
     /**
      * Get pointer to element with given handle or nullptr if handle invalid.
      */
-    T *get(Handle handle);
+    T *get(HandleType handle);
 
   private:
     /**
@@ -80,15 +122,40 @@ template <typename T> class HandleDataStore {
      * \pre    generation is smaller than the maximum value possible given the
      * number of bits assigned to it.
      *
-     * \param  index       unsigned int, index value to give Handle.
-     * \param  generation  unsigned int, generation value to give Handle.
-     * \return             Handle, constructed from index and value.
+     * \param  index       uint32_t, index value to give Handle.
+     * \param  generation  GenerationType, generation value to give Handle.
+     * \return             HandleType, constructed from index and value.
      */
-    Handle makeHandle(unsigned int index, unsigned int generation) const;
+    HandleType makeHandle(uint32_t index,
+                          typename HandleType::GenerationType generation) const;
+
+    /** Uninitialized storage for one object. */
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+    /**
+     * Get the object stored in the given slot.
+     *
+     * \pre The slot holds a constructed object.
+     */
+    T *getObject(uint32_t index) {
+        return reinterpret_cast<T *>(&slots[index]);
+    }
+    const T *getObject(uint32_t index) const {
+        return reinterpret_cast<const T *>(&slots[index]);
+    }
+
+    /**
+     * Move every constructed object into the given, larger, storage.
+     */
+    void moveObjects(Slot *newSlots);
 
     std::queue<uint32_t> freeIndices;
-    std::vector<uint8_t> generations;
-    std::vector<T> objects;
+    std::vector<typename HandleType::GenerationType> generations;
+    /** Whether each slot currently holds a constructed object. */
+    std::vector<uint8_t> liveSlots;
+
+    std::unique_ptr<Slot[]> slots;
+    uint32_t numSlots;
 };
 }
 
@@ -3,91 +3,182 @@
  * http://bitsquid.blogspot.com.au/2014/08/building-data-oriented-handle-system.html?m=1
  * (Niklas Frykholm).
  */
+#include <algorithm>
 #include <cassert>
+#include <new>
+#include <utility>
 
 #include <Fever/HandleDataStore.h>
 
 namespace fv {
-template <typename T> bool HandleDataStore<T>::isValid(Handle handle) const {
+template <typename T, typename HandleType>
+HandleDataStore<T, HandleType>::~HandleDataStore() {
+    for (uint32_t i = 0; i < liveSlots.size(); ++i) {
+        if (liveSlots[i]) {
+            getObject(i)->~T();
+        }
+    }
+}
+
+template <typename T, typename HandleType>
+bool HandleDataStore<T, HandleType>::isValid(HandleType handle) const {
     bool result = false;
 
     // Only try to check Entities that could possibly
     // have an entry in out generation array.
     if (handle.getIndex() < generations.size()) {
         // Handle is only valid if the Handle's generation
-        // matches our recorded valid generation.
-        result = generations[handle.getIndex()] == handle.getGeneration();
+        // matches our recorded valid generation. A wrapped around generation
+        // may match a free slot, which holds no object.
+        result = generations[handle.getIndex()] == handle.getGeneration() &&
+                 liveSlots[handle.getIndex()];
     }
 
     return result;
 }
 
-template <typename T> Handle HandleDataStore<T>::add(const T &object) {
-    uint32_t index     = 0;
-    uint8_t generation = 0;
+template <typename T, typename HandleType>
+HandleType HandleDataStore<T, HandleType>::add(const T &object) {
+    return emplace(object);
+}
+
+template <typename T, typename HandleType>
+HandleType HandleDataStore<T, HandleType>::add(T &&object) {
+    return emplace(std::move(object));
+}
+
+template <typename T, typename HandleType>
+template <typename... Args>
+HandleType HandleDataStore<T, HandleType>::emplace(Args &&... args) {
+    typedef typename HandleType::GenerationType GenerationType;
+
+    uint32_t index            = 0;
+    GenerationType generation = 0;
 
     // If the queue doesn't have any free indices, create new index.
     if (freeIndices.empty()) {
+        index = generations.size();
+
+        if (index < numSlots) {
+            new (&slots[index]) T(std::forward<Args>(args)...);
+        } else {
+            const uint32_t newNumSlots = (numSlots == 0) ? 16 : numSlots * 2;
+            std::unique_ptr<Slot[]> newSlots(new Slot[newNumSlots]);
+
+            // Construct before moving the other objects, the arguments may
+            // refer to one of them.
+            new (&newSlots[index]) T(std::forward<Args>(args)...);
+            moveObjects(newSlots.get());
+
+            slots    = std::move(newSlots);
+            numSlots = newNumSlots;
+        }
+
         generations.push_back(0);
-        objects.push_back(object);
-        index = generations.size() - 1;
+        liveSlots.push_back(1);
     }
     // If the queue has filled up, re-use index from queue.
     else {
         index = freeIndices.front();
+        new (&slots[index]) T(std::forward<Args>(args)...);
+
         freeIndices.pop();
-        generation     = generations[index];
-        objects[index] = object;
+        generation       = generations[index];
+        liveSlots[index] = 1;
     }
 
     return makeHandle(index, generation);
 }
 
-template <typename T> void HandleDataStore<T>::remove(Handle handle) {
+template <typename T, typename HandleType>
+void HandleDataStore<T, HandleType>::reserve(uint32_t count) {
+    // Free indices are re-used first, only the rest need new slots
+    const uint32_t numFree = freeIndices.size();
+    const uint32_t numNew  = (count > numFree) ? count - numFree : 0;
+    const uint32_t needed  = generations.size() + numNew;
+
+    if (needed <= numSlots) {
+        return;
+    }
+
+    // Keep growing geometrically so many small reservations stay cheap
+    const uint32_t newNumSlots = std::max(needed, numSlots * 2);
+    std::unique_ptr<Slot[]> newSlots(new Slot[newNumSlots]);
+    moveObjects(newSlots.get());
+
+    slots    = std::move(newSlots);
+    numSlots = newNumSlots;
+
+    generations.reserve(newNumSlots);
+    liveSlots.reserve(newNumSlots);
+}
+
+template <typename T, typename HandleType>
+void HandleDataStore<T, HandleType>::remove(HandleType handle) {
     // Only try to destroy valid Entities.
     if (isValid(handle)) {
         const uint32_t index = handle.getIndex();
 
+        // Destroy the object now rather than when the slot is re-used
+        getObject(index)->~T();
+        liveSlots[index] = 0;
+
         // Free index to be re-used
         freeIndices.push(index);
-        // Increment the generation value for that index,
-        // invalidating any previous references to that Handle.
-        generations[index]++;
+        // Increment the generation value for that index, wrapping within the
+        // generation bits, invalidating any previous references to that
+        // Handle.
+        generations[index] =
+            (generations[index] + 1) & HandleType::HANDLE_MAX_GENERATION;
     }
 }
 
-template <typename T> const T *HandleDataStore<T>::get(Handle handle) const {
+template <typename T, typename HandleType>
+const T *HandleDataStore<T, HandleType>::get(HandleType handle) const {
     if (!isValid(handle)) {
         return nullptr;
     } else {
         const uint32_t index = handle.getIndex();
 
-        return &objects[index];
+        return getObject(index);
     }
 }
 
-template <typename T> T *HandleDataStore<T>::get(Handle handle) {
+template <typename T, typename HandleType>
+T *HandleDataStore<T, HandleType>::get(HandleType handle) {
     if (!isValid(handle)) {
         return nullptr;
     } else {
         const uint32_t index = handle.getIndex();
 
-        return &objects[index];
+        return getObject(index);
+    }
+}
+
+template <typename T, typename HandleType>
+void HandleDataStore<T, HandleType>::moveObjects(Slot *newSlots) {
+    for (uint32_t i = 0; i < liveSlots.size(); ++i) {
+        if (liveSlots[i]) {
+            new (&newSlots[i]) T(std::move(*getObject(i)));
+            getObject(i)->~T();
+        }
     }
 }
 
-template <typename T>
-Handle HandleDataStore<T>::makeHandle(unsigned int index,
-                                      unsigned int generation) const {
+template <typename T, typename HandleType>
+HandleType HandleDataStore<T, HandleType>::makeHandle(
+    uint32_t index, typename HandleType::GenerationType generation) const {
     // Ensure index is not above maximum amount of Entities.
-    assert(index < (Handle::HANDLE_INDEX_MASK + 1) &&
+    assert(index <= HandleType::HANDLE_INDEX_MASK &&
            "Tried to create an Handle with too high an index.");
     // Ensure generation is not about maximum generation.
-    assert(generation < (Handle::HANDLE_GENERATION_MASK + 1) &&
+    assert(generation <= HandleType::HANDLE_MAX_GENERATION &&
            "Tried to create an Handle with too high a generation.");
 
-    Handle handle;
-    handle.id = (generation << Handle::HANDLE_INDEX_BITS) + index;
+    typedef typename HandleType::IdType IdType;
+
+    HandleType handle;
+    handle.id = ((IdType)generation << HandleType::HANDLE_INDEX_BITS) + index;
 
     return handle;
 }
@@ -0,0 +1,74 @@
+/*===-- Fever/IndirectDrawRecords.h - Indirect draw arguments -----*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Reads the draw arguments of indirect draws out of buffer memory, for
+ * backends that expand indirect draws on the CPU.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * The records of one indirect draw command in a buffer.
+ *
+ * Only records lying entirely inside the buffer are visible, so a draw count
+ * or offset running past the end of the buffer is clamped instead of reading
+ * out of bounds. Records are copied out, so they need no particular alignment.
+ *
+ * \tparam Record FvDrawIndirectCommand or FvDrawIndexedIndirectCommand.
+ */
+template <typename Record> class IndirectDrawRecords {
+  public:
+    /**
+     * \param data      Start of the buffer memory, may be nullptr if only
+     *                  offsets are needed.
+     * \param dataSize  Size of the buffer in bytes.
+     * \param offset    Offset of the first record in bytes.
+     * \param drawCount Number of records.
+     * \param stride    Bytes from one record to the next, 0 for tightly
+     *                  packed records.
+     */
+    IndirectDrawRecords(const void *data, FvSize dataSize, FvSize offset,
+                        uint32_t drawCount, uint32_t stride);
+
+    /**
+     * Get the number of records inside the buffer.
+     */
+    uint32_t size() const { return count; }
+
+    /**
+     * Get the offset of a record in bytes, for backends reading the records
+     * on the GPU.
+     *
+     * \pre \p index is less than 'size'.
+     */
+    FvSize getOffset(uint32_t index) const {
+        return offset + (FvSize)index * stride;
+    }
+
+    /**
+     * Get a copy of a record.
+     *
+     * \pre \p index is less than 'size' and the records were given data.
+     */
+    Record operator[](uint32_t index) const;
+
+  private:
+    const uint8_t *data;
+    FvSize offset;
+    FvSize stride;
+    uint32_t count;
+};
+}
+
+#include <Fever/IndirectDrawRecords.hpp>
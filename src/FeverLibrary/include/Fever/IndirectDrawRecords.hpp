@@ -0,0 +1,34 @@
+#include <cassert>
+#include <cstring>
+
+#include <Fever/IndirectDrawRecords.h>
+
+namespace fv {
+template <typename Record>
+IndirectDrawRecords<Record>::IndirectDrawRecords(const void *data,
+                                                 FvSize dataSize, FvSize offset,
+                                                 uint32_t drawCount,
+                                                 uint32_t stride)
+    : data((const uint8_t *)data), offset(offset),
+      stride(stride != 0 ? stride : sizeof(Record)), count(0) {
+    // Count the records ending inside the buffer, without overflowing
+    if (offset > dataSize || dataSize - offset < sizeof(Record)) {
+        return;
+    }
+
+    const FvSize lastStart = dataSize - offset - sizeof(Record);
+    const FvSize fitting   = lastStart / this->stride + 1;
+
+    count = fitting < drawCount ? (uint32_t)fitting : drawCount;
+}
+
+template <typename Record>
+Record IndirectDrawRecords<Record>::operator[](uint32_t index) const {
+    assert(index < count && data != nullptr);
+
+    Record record;
+    memcpy(&record, data + getOffset(index), sizeof(Record));
+
+    return record;
+}
+}
@@ -0,0 +1,214 @@
+/*===-- Fever/JobSystem.h - Work-stealing jobs --------------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Pool of worker threads running jobs, balanced by work stealing.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Fever/WorkStealingDeque.h>
+
+namespace fv {
+struct Job;
+
+/**
+ * Counts the jobs of a group that have yet to finish.
+ *
+ * Each job run against the counter raises it and lowers it again once it has
+ * finished. Jobs can be made to wait for a counter to reach zero, see
+ * JobSystem::runAfter, and threads can wait for it with JobSystem::wait.
+ *
+ * A counter can be reused once it has reached zero, but must outlive the jobs
+ * run against it and the jobs waiting for it.
+ */
+class JobCounter {
+  public:
+    JobCounter() : count(0) {}
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    /**
+     * Get whether every job run against the counter has finished.
+     */
+    bool isDone() const { return count.load(std::memory_order_acquire) == 0; }
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> count;
+    /** Guards the counter reaching zero, and the jobs waiting for it to. */
+    std::mutex mutex;
+    std::vector<Job *> waiting;
+};
+
+/**
+ * Runs jobs on a fixed pool of worker threads.
+ *
+ * Each worker owns a WorkStealingDeque. Jobs run from a worker go onto its own
+ * deque and are popped most recent first, staying hot in its cache. Idle
+ * workers steal the oldest jobs from the others, so the work spreads out
+ * without a shared queue to fight over. Jobs run from other threads go onto
+ * a locked injection queue the workers take from.
+ *
+ * Threads waiting for a counter run jobs until it reaches zero, so a job can
+ * wait on jobs it runs without tying up its worker, and a system with no
+ * workers runs every job on the threads waiting for them.
+ */
+class JobSystem {
+  public:
+    /** Work of a job. */
+    typedef std::function<void()> Function;
+
+    /**
+     * Start the worker threads.
+     *
+     * \param numWorkers Number of worker threads, which may be zero.
+     */
+    explicit JobSystem(uint32_t numWorkers = getDefaultNumWorkers());
+
+    /**
+     * Stop the worker threads.
+     *
+     * \pre No jobs are running. Jobs that have not started are dropped.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+     * Get a worker for every hardware thread but the one the application
+     * runs on.
+     */
+    static uint32_t getDefaultNumWorkers();
+
+    uint32_t getNumWorkers() const { return (uint32_t)workers.size(); }
+
+    /**
+     * Run a job, from any thread, including from jobs.
+     *
+     * \param function Work of the job.
+     * \param counter  Counter to raise until the job has finished, or
+     *                 nullptr.
+     */
+    void run(Function function, JobCounter *counter = nullptr);
+
+    /**
+     * Run a job once every job run against another counter has finished.
+     *
+     * \param dependency Counter the job waits for, runs straight away if it is
+     *                   already zero.
+     * \param function   Work of the job.
+     * \param counter    Counter to raise until the job has finished, or
+     *                   nullptr.
+     */
+    void runAfter(JobCounter &dependency, Function function,
+                  JobCounter *counter = nullptr);
+
+    /**
+     * Run jobs until every job run against a counter has finished.
+     *
+     * \param counter Counter to wait for.
+     */
+    void wait(JobCounter &counter);
+
+    /**
+     * Call a function over chunks of a range of indices, in parallel, and
+     * wait for every chunk to finish.
+     *
+     * The range is halved until the halves are no bigger than the grain
+     * size, handing out one half as a job each time, so idle workers steal
+     * big pieces of the range and split them further themselves.
+     *
+     * \param count     Number of indices, from zero.
+     * \param grainSize Largest number of indices in a chunk, taken as one if
+     *                  zero.
+     * \param function  Called as function(begin, end) for each chunk, from
+     *                  several threads at once.
+     */
+    template <typename F>
+    void parallelFor(uint32_t count, uint32_t grainSize, const F &function);
+
+  private:
+    struct Worker;
+
+    /**
+     * Run the chunks of [begin, end), see 'parallelFor'.
+     */
+    template <typename F>
+    void parallelForRange(uint32_t begin, uint32_t end, uint32_t grainSize,
+                          const F &function, JobCounter &counter);
+
+    /**
+     * Make a job ready to run and wake a worker for it.
+     */
+    void schedule(Job *job);
+
+    /**
+     * Take a ready job, from the worker's own deque, the injection queue or
+     * another worker's deque, in that order.
+     *
+     * \param self Worker taking the job, nullptr for other threads.
+     * \return     Job taken, nullptr if none was found.
+     */
+    Job *findJob(Worker *self);
+
+    /**
+     * Get whether there may be jobs ready to run.
+     */
+    bool hasReadyJobs() const;
+
+    /**
+     * Run a job, lower its counter and free it.
+     */
+    void execute(Job *job);
+
+    /**
+     * Get the worker of this system running on the calling thread, nullptr if
+     * there is none.
+     */
+    Worker *getCurrentWorker() const;
+
+    /**
+     * Body of the worker threads.
+     */
+    void workerMain(Worker *self);
+
+    /** Worker running on this thread, of whichever system started it. */
+    static thread_local Worker *currentWorker;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /** Jobs run from threads other than the workers. */
+    std::mutex injectedMutex;
+    std::deque<Job *> injected;
+    std::atomic<size_t> injectedCount;
+
+    /** Number of workers asleep, or about to go to sleep. */
+    std::atomic<uint32_t> sleepers;
+    /** Guards 'wakeups' and 'stopping', and puts workers to sleep. */
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    uint32_t wakeups;
+    bool stopping;
+};
+}
+
+#include <Fever/JobSystem.hpp>
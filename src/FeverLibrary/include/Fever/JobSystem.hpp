@@ -0,0 +1,39 @@
+#include <Fever/JobSystem.h>
+
+namespace fv {
+template <typename F>
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize,
+                            const F &function) {
+    if (count == 0) {
+        return;
+    }
+    if (grainSize == 0) {
+        grainSize = 1;
+    }
+
+    JobCounter counter;
+    parallelForRange(0, count, grainSize, function, counter);
+    wait(counter);
+}
+
+template <typename F>
+void JobSystem::parallelForRange(uint32_t begin, uint32_t end,
+                                 uint32_t grainSize, const F &function,
+                                 JobCounter &counter) {
+    // Hand out the right half and keep splitting the left one, so the caller
+    // ends up with the first chunk
+    while (end - begin > grainSize) {
+        const uint32_t middle = begin + (end - begin) / 2;
+
+        run(
+            [this, middle, end, grainSize, &function, &counter]() {
+                parallelForRange(middle, end, grainSize, function, counter);
+            },
+            &counter);
+
+        end = middle;
+    }
+
+    function(begin, end);
+}
+}
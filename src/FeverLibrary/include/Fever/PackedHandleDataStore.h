@@ -0,0 +1,114 @@
+/*===-- Fever/PackedHandleDataStore.h - Packed store --------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Container for data referred to by handle that keeps all live objects
+ * next to each other in memory.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <queue>
+#include <vector>
+
+#include <Fever/Handle.h>
+
+namespace fv {
+/**
+ * Sparse set variant of the HandleDataStore.
+ *
+ * Live objects are kept in a dense array without holes. Each handle index
+ * maps to the object's position in that array, and removing an object moves
+ * the last object into the freed position.
+ *
+ * - Iterating over all live objects touches only live objects.
+ * - get costs one more indirection than in the HandleDataStore.
+ * - Adding or removing an object may move other objects, invalidating
+ *   pointers returned by 'get' and iterators.
+ *
+ * \tparam HandleType BasicHandle layout of the handles given out, see Handle
+ *                    and Handle64.
+ */
+template <typename T, typename HandleType = Handle>
+class PackedHandleDataStore {
+  public:
+    static_assert(HandleType::HANDLE_INDEX_BITS <= 32,
+                  "PackedHandleDataStore indices are limited to 32 bits.");
+
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    /**
+     * \copydoc HandleDataStore::isValid
+     */
+    bool isValid(HandleType handle) const;
+
+    /**
+     * \copydoc HandleDataStore::add
+     */
+    HandleType add(const T &object);
+
+    /**
+     * Remove the object referred to by the given handle from the data store.
+     *
+     * The last live object is moved into the removed object's place.
+     *
+     * \param handle Handle to destroy.
+     */
+    void remove(HandleType handle);
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle) const
+     */
+    const T *get(HandleType handle) const;
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle)
+     */
+    T *get(HandleType handle);
+
+    /**
+     * Get the number of live objects.
+     */
+    size_t size() const { return objects.size(); }
+
+    /**
+     * Get the handle of the live object at the given position of the
+     * iteration order.
+     *
+     * \pre position is smaller than 'size'.
+     */
+    HandleType getHandle(size_t position) const;
+
+    /**
+     * Iterators over the live objects, in no particular order.
+     */
+    iterator begin() { return objects.begin(); }
+    iterator end() { return objects.end(); }
+    const_iterator begin() const { return objects.begin(); }
+    const_iterator end() const { return objects.end(); }
+
+  private:
+    /**
+     * \copydoc HandleDataStore::makeHandle
+     */
+    HandleType makeHandle(uint32_t index,
+                          typename HandleType::GenerationType generation) const;
+
+    std::queue<uint32_t> freeIndices;
+    std::vector<typename HandleType::GenerationType> generations;
+    /** Position in 'objects' of each live handle, indexed by handle index. */
+    std::vector<uint32_t> positions;
+
+    /** Live objects, without holes. */
+    std::vector<T> objects;
+    /** Handle index of each object in 'objects'. */
+    std::vector<uint32_t> objectIndices;
+};
+}
+
+#include <Fever/PackedHandleDataStore.hpp>
@@ -0,0 +1,117 @@
+#include <cassert>
+#include <utility>
+
+#include <Fever/PackedHandleDataStore.h>
+
+namespace fv {
+template <typename T, typename HandleType>
+bool PackedHandleDataStore<T, HandleType>::isValid(HandleType handle) const {
+    const uint32_t index = handle.getIndex();
+
+    // Removing bumps the generation, so a matching generation means the index
+    // still refers to a live object.
+    return (index < generations.size() &&
+            generations[index] == handle.getGeneration());
+}
+
+template <typename T, typename HandleType>
+HandleType PackedHandleDataStore<T, HandleType>::add(const T &object) {
+    typedef typename HandleType::GenerationType GenerationType;
+
+    uint32_t index            = 0;
+    GenerationType generation = 0;
+
+    // If the queue doesn't have any free indices, create new index.
+    if (freeIndices.empty()) {
+        generations.push_back(0);
+        positions.push_back(0);
+        index = generations.size() - 1;
+    }
+    // Else re-use index from queue.
+    else {
+        index = freeIndices.front();
+        freeIndices.pop();
+        generation = generations[index];
+    }
+
+    // New objects always go at the end of the dense array
+    positions[index] = objects.size();
+    objects.push_back(object);
+    objectIndices.push_back(index);
+
+    return makeHandle(index, generation);
+}
+
+template <typename T, typename HandleType>
+void PackedHandleDataStore<T, HandleType>::remove(HandleType handle) {
+    // Only try to destroy valid Entities.
+    if (!isValid(handle)) {
+        return;
+    }
+
+    const uint32_t index    = handle.getIndex();
+    const uint32_t position = positions[index];
+    const uint32_t last     = objects.size() - 1;
+
+    // Fill the hole with the last object so the array stays dense
+    if (position != last) {
+        objects[position]       = std::move(objects[last]);
+        objectIndices[position] = objectIndices[last];
+
+        positions[objectIndices[position]] = position;
+    }
+
+    objects.pop_back();
+    objectIndices.pop_back();
+
+    // Free index to be re-used and invalidate any previous references to that
+    // Handle.
+    freeIndices.push(index);
+    generations[index] =
+        (generations[index] + 1) & HandleType::HANDLE_MAX_GENERATION;
+}
+
+template <typename T, typename HandleType>
+const T *PackedHandleDataStore<T, HandleType>::get(HandleType handle) const {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return &objects[positions[handle.getIndex()]];
+    }
+}
+
+template <typename T, typename HandleType>
+T *PackedHandleDataStore<T, HandleType>::get(HandleType handle) {
+    if (!isValid(handle)) {
+        return nullptr;
+    } else {
+        return &objects[positions[handle.getIndex()]];
+    }
+}
+
+template <typename T, typename HandleType>
+HandleType
+PackedHandleDataStore<T, HandleType>::getHandle(size_t position) const {
+    assert(position < objects.size() &&
+           "Tried to get the handle of a position past the last object.");
+
+    const uint32_t index = objectIndices[position];
+
+    return makeHandle(index, generations[index]);
+}
+
+template <typename T, typename HandleType>
+HandleType PackedHandleDataStore<T, HandleType>::makeHandle(
+    uint32_t index, typename HandleType::GenerationType generation) const {
+    // Ensure index is not above maximum amount of Entities.
+    assert(index <= HandleType::HANDLE_INDEX_MASK &&
+           "Tried to create an Handle with too high an index.");
+
+    typedef typename HandleType::IdType IdType;
+
+    HandleType handle;
+    handle.id = ((IdType)generation << HandleType::HANDLE_INDEX_BITS) + index;
+
+    return handle;
+}
+}
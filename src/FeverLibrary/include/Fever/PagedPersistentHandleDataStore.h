@@ -0,0 +1,151 @@
+/*===-- Fever/PagedPersistentHandleDataStore.h - Paged store ------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief PersistentHandleDataStore without a fixed capacity.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Fever/HandleDataStore.h>
+
+namespace fv {
+/**
+ * Duplicates the interface of the PersistentHandleDataStore but stores the
+ * handles in fixed-size pages rather than in a single pre-sized array.
+ *
+ * - New pages are allocated on demand, so the store has no hard capacity.
+ * - Pages never move, so a pointer returned by 'add' stays valid until its
+ *   handle is removed, no matter how much the store grows.
+ * - A page whose handles have all been removed is released back to the
+ *   allocator, unless it is the only page with free slots left.
+ *
+ * isValid, add and remove run in constant time.
+ *
+ * Because empty pages are released, a pointer returned by 'add' must not be
+ * dereferenced after its handle has been removed.
+ */
+template <typename T, typename HandleType = Handle,
+          uint32_t HANDLES_PER_PAGE = 64>
+class PagedPersistentHandleDataStore {
+  public:
+    PagedPersistentHandleDataStore() : numLiveHandles(0) {}
+
+    /**
+     * \copydoc HandleDataStore::isValid
+     */
+    bool isValid(HandleType handle) const;
+
+    /**
+     * Add an object to the data store.
+     *
+     * Handle guaranteed to exist in same spot in memory until handle and object
+     * removed using 'remove'.
+     *
+     * \returns Pointer to a handle to the object.
+     */
+    const HandleType *add(const T &object);
+
+    /**
+     * \copydoc HandleDataStore::add(T &&object)
+     *
+     * \returns Pointer to a handle to the object.
+     */
+    const HandleType *add(T &&object);
+
+    /**
+     * \copydoc HandleDataStore::emplace
+     *
+     * \returns Pointer to a handle to the object.
+     */
+    template <typename... Args> const HandleType *emplace(Args &&... args);
+
+    /**
+     * Allocate enough pages and storage to add the given number of objects
+     * without further allocation.
+     *
+     * \param count Number of objects about to be added.
+     */
+    void reserve(uint32_t count);
+
+    /**
+     * \copydoc HandleDataStore::remove
+     */
+    void remove(HandleType handle);
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle) const
+     */
+    const T *get(HandleType handle) const;
+
+    /**
+     * \copydoc HandleDataStore::get(HandleType handle)
+     */
+    T *get(HandleType handle);
+
+    /**
+     * Get the number of pages currently allocated.
+     */
+    uint32_t getNumPages() const {
+        return (uint32_t)(pages.size() - freePageIndices.size());
+    }
+
+  private:
+    /** Marks the end of a page's free slot list. */
+    static const uint32_t FREE_LIST_END = 0xFFFFFFFF;
+
+    /** Marks a page that is not in 'availablePages'. */
+    static const uint32_t NOT_AVAILABLE = 0xFFFFFFFF;
+
+    struct Page {
+        HandleType handles[HANDLES_PER_PAGE];
+        /** Per-slot link to the next free slot (only meaningful while free). */
+        uint32_t nextFreeSlots[HANDLES_PER_PAGE];
+        uint32_t firstFreeSlot;
+        uint32_t numLiveHandles;
+        /** Position of this page in 'availablePages' or NOT_AVAILABLE. */
+        uint32_t availableIndex;
+    };
+
+    /**
+     * Allocate a page and mark it as having free slots.
+     */
+    void allocatePage();
+
+    /**
+     * Release an empty page back to the allocator.
+     */
+    void releasePage(uint32_t pageIndex);
+
+    /**
+     * Remove a page from the list of pages with free slots.
+     */
+    void markUnavailable(uint32_t pageIndex);
+
+    HandleDataStore<T, HandleType> dataStore;
+
+    /** All pages, nullptr where a page has been released. */
+    std::vector<std::unique_ptr<Page>> pages;
+    /** Entries of 'pages' that are nullptr and may be re-used. */
+    std::vector<uint32_t> freePageIndices;
+    /** Pages with at least one free slot. */
+    std::vector<uint32_t> availablePages;
+    /** Number of live handles across all pages. */
+    uint32_t numLiveHandles;
+
+    /**
+     * Slot of each live handle, indexed by handle index. The slot is the page
+     * index times HANDLES_PER_PAGE plus the position within the page.
+     */
+    std::vector<uint32_t> handleSlots;
+};
+}
+
+#include <Fever/PagedPersistentHandleDataStore.hpp>
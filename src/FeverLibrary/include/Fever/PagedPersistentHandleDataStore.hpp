@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <utility>
+
+#include <Fever/PagedPersistentHandleDataStore.h>
+
+namespace fv {
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+bool PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::isValid(
+    HandleType handle) const {
+    // Valid if handle is a valid handle and exists in our handle storage
+    if (!dataStore.isValid(handle)) {
+        return false;
+    }
+
+    const uint32_t index = handle.getIndex();
+
+    if (index >= handleSlots.size()) {
+        return false;
+    }
+
+    const uint32_t slot = handleSlots[index];
+    const Page *page    = pages[slot / HANDLES_PER_PAGE].get();
+
+    return (page != nullptr &&
+            page->handles[slot % HANDLES_PER_PAGE] == handle);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+const HandleType *
+PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::add(
+    const T &object) {
+    return emplace(object);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+const HandleType *
+PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::add(
+    T &&object) {
+    return emplace(std::move(object));
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+template <typename... Args>
+const HandleType *
+PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::emplace(
+    Args &&... args) {
+    if (availablePages.empty()) {
+        allocatePage();
+    }
+
+    const uint32_t pageIndex = availablePages.back();
+    Page *page               = pages[pageIndex].get();
+
+    const uint32_t offset = page->firstFreeSlot;
+    page->firstFreeSlot   = page->nextFreeSlots[offset];
+    ++page->numLiveHandles;
+    ++numLiveHandles;
+
+    if (page->firstFreeSlot == FREE_LIST_END) {
+        markUnavailable(pageIndex);
+    }
+
+    HandleType *handlePtr = &page->handles[offset];
+    *handlePtr            = dataStore.emplace(std::forward<Args>(args)...);
+
+    // Remember where the handle lives so it can be found without a search
+    const uint32_t index = handlePtr->getIndex();
+
+    if (index >= handleSlots.size()) {
+        handleSlots.resize(index + 1);
+    }
+    handleSlots[index] = pageIndex * HANDLES_PER_PAGE + offset;
+
+    return handlePtr;
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+void PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::reserve(
+    uint32_t count) {
+    // Every allocated page adds HANDLES_PER_PAGE free slots
+    while (getNumPages() * HANDLES_PER_PAGE - numLiveHandles < count) {
+        allocatePage();
+    }
+
+    dataStore.reserve(count);
+
+    // New handle indices are at most 'count' past the current ones
+    const size_t neededSlots = handleSlots.size() + count;
+
+    if (neededSlots > handleSlots.capacity()) {
+        handleSlots.reserve(std::max(neededSlots, handleSlots.capacity() * 2));
+    }
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+void PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::remove(
+    HandleType handle) {
+    // Only free the slot of a live handle, a stale handle may share its index
+    // with a newer one.
+    if (!isValid(handle)) {
+        return;
+    }
+
+    dataStore.remove(handle);
+
+    const uint32_t slot      = handleSlots[handle.getIndex()];
+    const uint32_t pageIndex = slot / HANDLES_PER_PAGE;
+    const uint32_t offset    = slot % HANDLES_PER_PAGE;
+    Page *page               = pages[pageIndex].get();
+
+    page->nextFreeSlots[offset] = page->firstFreeSlot;
+    page->firstFreeSlot         = offset;
+    --page->numLiveHandles;
+    --numLiveHandles;
+
+    if (page->availableIndex == NOT_AVAILABLE) {
+        page->availableIndex = (uint32_t)availablePages.size();
+        availablePages.push_back(pageIndex);
+    }
+
+    // Keep the page if it is the only one with room, otherwise adding and
+    // removing a single object at a page boundary would allocate every time.
+    if (page->numLiveHandles == 0 && availablePages.size() > 1) {
+        releasePage(pageIndex);
+    }
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+const T *
+PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::get(
+    HandleType handle) const {
+    return dataStore.get(handle);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+T *PagedPersistentHandleDataStore<T, HandleType, HANDLES_PER_PAGE>::get(
+    HandleType handle) {
+    return dataStore.get(handle);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+void PagedPersistentHandleDataStore<
+    T, HandleType, HANDLES_PER_PAGE>::allocatePage() {
+    uint32_t pageIndex = 0;
+
+    // Re-use the entry of a released page if there is one
+    if (freePageIndices.empty()) {
+        pageIndex = (uint32_t)pages.size();
+        pages.push_back(std::unique_ptr<Page>());
+    } else {
+        pageIndex = freePageIndices.back();
+        freePageIndices.pop_back();
+    }
+
+    Page *page = new Page;
+
+    for (uint32_t i = 0; i < HANDLES_PER_PAGE; ++i) {
+        page->nextFreeSlots[i] = i + 1;
+    }
+    page->nextFreeSlots[HANDLES_PER_PAGE - 1] = FREE_LIST_END;
+    page->firstFreeSlot                       = 0;
+    page->numLiveHandles                      = 0;
+
+    pages[pageIndex].reset(page);
+
+    page->availableIndex = (uint32_t)availablePages.size();
+    availablePages.push_back(pageIndex);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+void PagedPersistentHandleDataStore<
+    T, HandleType, HANDLES_PER_PAGE>::releasePage(uint32_t pageIndex) {
+    markUnavailable(pageIndex);
+
+    pages[pageIndex].reset();
+    freePageIndices.push_back(pageIndex);
+}
+
+template <typename T, typename HandleType, uint32_t HANDLES_PER_PAGE>
+void PagedPersistentHandleDataStore<
+    T, HandleType, HANDLES_PER_PAGE>::markUnavailable(uint32_t pageIndex) {
+    const uint32_t availableIndex = pages[pageIndex]->availableIndex;
+    const uint32_t lastPageIndex  = availablePages.back();
+
+    // Swap with the last entry so removal does not shift the list
+    availablePages[availableIndex]       = lastPageIndex;
+    pages[lastPageIndex]->availableIndex = availableIndex;
+    availablePages.pop_back();
+    pages[pageIndex]->availableIndex = NOT_AVAILABLE;
+}
+}
@@ -19,17 +19,23 @@ namespace fv {
  * Duplicates the interface of the HandleDataStore but store handles internally
  * and returns pointers to those handles rather than returning the handles by
  * value.
+ *
+ * The slot each handle is stored in is recorded against the handle's index,
+ * so isValid and remove run in constant time regardless of the number of live
+ * handles.
  */
-template <typename T> class PersistentHandleDataStore {
+template <typename T, typename HandleType = Handle>
+class PersistentHandleDataStore {
   public:
     PersistentHandleDataStore(uint32_t maxNumHandles) {
         handles.reserve(maxNumHandles);
+        handleSlots.reserve(maxNumHandles);
     }
 
     /**
      * \copydoc HandleDataStore::isValid
      */
-    bool isValid(Handle handle) const;
+    bool isValid(HandleType handle) const;
 
     /**
      * Add an object to the data store.
@@ -39,28 +45,45 @@ template <typename T> class PersistentHandleDataStore {
      *
      * \returns Pointer to a handle to the object or nullptr if adding failed.
      */
-    const Handle *add(const T &object);
+    const HandleType *add(const T &object);
+
+    /**
+     * \copydoc HandleDataStore::add(T &&object)
+     *
+     * \returns Pointer to a handle to the object or nullptr if adding failed.
+     */
+    const HandleType *add(T &&object);
+
+    /**
+     * \copydoc HandleDataStore::emplace
+     *
+     * \returns Pointer to a handle to the object or nullptr if adding failed.
+     */
+    template <typename... Args> const HandleType *emplace(Args &&... args);
 
     /**
      * \copydoc HandleDataStore::remove
      */
-    void remove(Handle handle);
+    void remove(HandleType handle);
 
     /**
-     * \copydoc HandleDataStore::get(Handle handle) const
+     * \copydoc HandleDataStore::get(HandleType handle) const
      */
-    const T *get(Handle handle) const;
+    const T *get(HandleType handle) const;
 
     /**
-     * \copydoc HandleDataStore::get(Handle handle)
+     * \copydoc HandleDataStore::get(HandleType handle)
      */
-    T *get(Handle handle);
+    T *get(HandleType handle);
 
   private:
-    HandleDataStore<T> dataStore;
+    HandleDataStore<T, HandleType> dataStore;
 
-    std::vector<Handle> handles;
+    std::vector<HandleType> handles;
     std::queue<size_t> freeIndices;
+
+    /** Slot in 'handles' of each live handle, indexed by handle index. */
+    std::vector<size_t> handleSlots;
 };
 }
 
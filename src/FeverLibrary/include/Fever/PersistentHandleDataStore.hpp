@@ -1,53 +1,89 @@
+#include <utility>
+
 namespace fv {
-template <typename T>
-bool PersistentHandleDataStore<T>::isValid(Handle handle) const {
-    // Valid if handle exists in our handle storage and is a valid handle
-    return (
-        (std::find(handles.begin(), handles.end(), handle) != handles.end()) &&
-        (dataStore.isValid(handle)));
+template <typename T, typename HandleType>
+bool PersistentHandleDataStore<T, HandleType>::isValid(
+    HandleType handle) const {
+    // Valid if handle is a valid handle and exists in our handle storage
+    if (!dataStore.isValid(handle)) {
+        return false;
+    }
+
+    const uint32_t index = handle.getIndex();
+
+    return (index < handleSlots.size() &&
+            handles[handleSlots[index]] == handle);
+}
+
+template <typename T, typename HandleType>
+const HandleType *
+PersistentHandleDataStore<T, HandleType>::add(const T &object) {
+    return emplace(object);
+}
+
+template <typename T, typename HandleType>
+const HandleType *PersistentHandleDataStore<T, HandleType>::add(T &&object) {
+    return emplace(std::move(object));
 }
 
-template <typename T>
-const Handle *PersistentHandleDataStore<T>::add(const T &object) {
-    Handle *handlePtr = nullptr;
+template <typename T, typename HandleType>
+template <typename... Args>
+const HandleType *
+PersistentHandleDataStore<T, HandleType>::emplace(Args &&... args) {
+    HandleType *handlePtr = nullptr;
+    size_t slot           = 0;
 
     // No 'holes' to fill
     if (freeIndices.empty()) {
         // Haven't exceeded maxNumHandles
         if (handles.size() < handles.capacity()) {
-            handles.push_back(dataStore.add(object));
-            handlePtr = &handles[handles.size() - 1];
+            handles.push_back(dataStore.emplace(std::forward<Args>(args)...));
+            slot = handles.size() - 1;
+
+            handlePtr = &handles[slot];
         }
     }
     // Else fill free indices
     else {
-        size_t index = freeIndices.front();
+        slot = freeIndices.front();
         freeIndices.pop();
-        handles[index] = dataStore.add(object);
-        handlePtr      = &handles[index];
+        handles[slot] = dataStore.emplace(std::forward<Args>(args)...);
+
+        handlePtr = &handles[slot];
     }
 
-    return handlePtr;
-}
+    if (handlePtr != nullptr) {
+        // Remember where the handle lives so it can be found without a search
+        const uint32_t index = handlePtr->getIndex();
 
-template <typename T> void PersistentHandleDataStore<T>::remove(Handle handle) {
-    dataStore.remove(handle);
+        if (index >= handleSlots.size()) {
+            handleSlots.resize(index + 1);
+        }
+        handleSlots[index] = slot;
+    }
 
-    std::vector<Handle>::const_iterator it =
-        std::find(handles.begin(), handles.end(), handle);
-    if (it != handles.end()) {
-        size_t index = it - handles.begin();
+    return handlePtr;
+}
 
-        freeIndices.push(index);
+template <typename T, typename HandleType>
+void PersistentHandleDataStore<T, HandleType>::remove(HandleType handle) {
+    // Only free the slot of a live handle, a stale handle may share its index
+    // with a newer one.
+    if (isValid(handle)) {
+        freeIndices.push(handleSlots[handle.getIndex()]);
     }
+
+    dataStore.remove(handle);
 }
 
-template <typename T>
-const T *PersistentHandleDataStore<T>::get(Handle handle) const {
+template <typename T, typename HandleType>
+const T *
+PersistentHandleDataStore<T, HandleType>::get(HandleType handle) const {
     return dataStore.get(handle);
 }
 
-template <typename T> T *PersistentHandleDataStore<T>::get(Handle handle) {
+template <typename T, typename HandleType>
+T *PersistentHandleDataStore<T, HandleType>::get(HandleType handle) {
     return dataStore.get(handle);
 }
 }
@@ -0,0 +1,157 @@
+/*===-- Fever/RenderQueue.h - State-sorted draws ------------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Queue of draws sorted by the state they need before being recorded
+ * into a command buffer.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * Everything needed to record one draw.
+ */
+struct DrawItem {
+    FvGraphicsPipeline graphicsPipeline;
+    FvPipelineLayout pipelineLayout;
+    /** Bound to set 0, or FV_NULL_HANDLE for none. Bound without dynamic
+     * offsets, so it must not hold dynamic descriptors. */
+    FvDescriptorSet descriptorSet;
+    /** Bound to binding 0. */
+    FvBuffer vertexBuffer;
+    FvSize vertexBufferOffset;
+    /** FV_NULL_HANDLE for non-indexed draws. */
+    FvBuffer indexBuffer;
+    FvSize indexBufferOffset;
+    FvIndexType indexType;
+    /** Number of indices for indexed draws, vertices otherwise. */
+    uint32_t count;
+    uint32_t instanceCount;
+    /** First index for indexed draws, first vertex otherwise. */
+    uint32_t first;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+/**
+ * Collects the draws of one render pass and records them into a command
+ * buffer in the order of their sort keys.
+ *
+ * Sort keys are built by 'makeSortKey' so that draws sharing a pipeline are
+ * recorded together, then those sharing a descriptor set and then those
+ * sharing a vertex buffer, front to back within each. Recording in that order
+ * changes as little state as possible between draws.
+ *
+ * Sorting is a least significant digit radix sort on the keys, small queues
+ * fall back to a comparison sort. Either way it is stable, so draws with equal
+ * keys keep the order they were added in. Use one queue per render pass and
+ * 'clear' it every frame, it stops allocating once it has seen its largest
+ * frame.
+ */
+class RenderQueue {
+  public:
+    /** Bits of the sort key given to each part, most significant first. */
+    static const uint32_t PIPELINE_BITS       = 12;
+    static const uint32_t DESCRIPTOR_SET_BITS = 14;
+    static const uint32_t VERTEX_BUFFER_BITS  = 14;
+    static const uint32_t DEPTH_BITS          = 24;
+
+    /**
+     * Build a sort key.
+     *
+     * The ids are chosen by the application, e.g. the index of the material a
+     * pipeline belongs to, and are truncated to their number of bits.
+     *
+     * \param pipeline      Id of the graphics pipeline.
+     * \param descriptorSet Id of the descriptor set.
+     * \param vertexBuffer  Id of the vertex buffer.
+     * \param depth         View depth in [0, 1], values outside are clamped.
+     * \return              Key sorting by pipeline, descriptor set, vertex
+     *                      buffer and then depth.
+     */
+    static uint64_t makeSortKey(uint32_t pipeline, uint32_t descriptorSet,
+                                uint32_t vertexBuffer, float depth);
+
+    /**
+     * Allocate enough storage to add the given number of draws without
+     * further allocation.
+     */
+    void reserve(size_t count);
+
+    /**
+     * Add a draw to the queue.
+     *
+     * \param key  Sort key of the draw, see 'makeSortKey'.
+     * \param item Draw to record.
+     */
+    void add(uint64_t key, const DrawItem &item);
+
+    /**
+     * Sort the draws added since the last 'clear' by key.
+     */
+    void sort();
+
+    /**
+     * Record the draws into a command buffer in sorted order, only binding
+     * the state that changes from one draw to the next.
+     *
+     * \pre 'sort' has been called since the last 'add'.
+     * \pre \p commandBuffer is inside the render pass the draws belong to.
+     */
+    void submit(FvCommandBuffer commandBuffer) const;
+
+    /**
+     * Remove every draw, keeping the storage.
+     */
+    void clear();
+
+    /**
+     * Get the number of draws in the queue.
+     */
+    size_t size() const { return items.size(); }
+
+    /**
+     * Get a draw in sorted order.
+     *
+     * \pre 'sort' has been called since the last 'add'.
+     * \pre \p position is less than 'size'.
+     */
+    const DrawItem &getSorted(size_t position) const {
+        return items[entries[position].item];
+    }
+
+    /**
+     * Get the sort key of a draw in sorted order.
+     *
+     * \copydetails getSorted
+     */
+    uint64_t getSortedKey(size_t position) const {
+        return entries[position].key;
+    }
+
+  private:
+    /** Sorted in place of the draws, so sorting moves 16 bytes per draw. */
+    struct SortEntry {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    std::vector<DrawItem> items;
+    std::vector<SortEntry> entries;
+    /** Ping-pong buffer of the radix sort. */
+    std::vector<SortEntry> scratch;
+    /** Digit counts of every radix sort pass. */
+    std::vector<uint32_t> histograms;
+};
+}
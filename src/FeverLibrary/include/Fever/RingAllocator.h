@@ -0,0 +1,103 @@
+/*===-- Fever/RingAllocator.h - Per-frame transient allocator -----*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Sub-allocates data written once a frame, e.g. uniforms, from one
+ * buffer split into a region per frame in flight.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <cstdint>
+
+#include <Fever/Fever.h>
+
+namespace fv {
+/**
+ * Hands out aligned offsets into a buffer the application owns, typically a
+ * persistently mapped one, see fvBufferMap.
+ *
+ * The buffer is split into one equal region per frame in flight. Each frame
+ * allocates from its own region by bumping a cursor, and starting the frame
+ * again frees everything it allocated before at once, so the CPU never
+ * writes over data the GPU may still be reading as long as the regions
+ * follow the frames of a FramesInFlight:
+ *
+ * \code
+ * frames.beginFrame(FV_WAIT_FOREVER);
+ * ring.beginFrame(frames.getFrameIndex());
+ *
+ * FvSize offset;
+ * if (ring.allocate(sizeof(ubo), &offset)) {
+ *     memcpy(mapped + offset, &ubo, sizeof(ubo));
+ *     uint32_t dynamicOffset = (uint32_t)offset;
+ *     // ... flush the range and bind with the dynamic offset ...
+ * }
+ * \endcode
+ *
+ * Only offsets are tracked, the allocator never touches the buffer.
+ */
+class RingAllocator {
+  public:
+    /**
+     * \param size       Bytes of the buffer allocations are made from.
+     * \param numRegions Number of frames in flight, at least 1.
+     * \param alignment  Alignment of every offset handed out, a power of two.
+     */
+    RingAllocator(FvSize size, uint32_t numRegions,
+                  FvSize alignment = FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+
+    /**
+     * Start allocating from the region of a frame, freeing everything
+     * allocated from it before.
+     *
+     * \pre The GPU has finished with what was allocated from the region.
+     *
+     * \param regionIndex Region of the frame, e.g.
+     *                    FramesInFlight::getFrameIndex, taken modulo the
+     *                    number of regions.
+     */
+    void beginFrame(uint32_t regionIndex);
+
+    /**
+     * Allocate from the region of the current frame.
+     *
+     * \param  size   Bytes to allocate.
+     * \param  offset Set to the offset of the allocation from the start of
+     *                the buffer.
+     * \return        False if the region has no room left, in which case
+     *                \p offset is left alone.
+     */
+    bool allocate(FvSize size, FvSize *offset);
+
+    /**
+     * Get the bytes of each region, the buffer size split evenly and rounded
+     * down to the alignment.
+     */
+    FvSize getRegionSize() const { return regionSize; }
+
+    uint32_t getNumRegions() const { return numRegions; }
+
+    FvSize getAlignment() const { return alignment; }
+
+    /**
+     * Get the bytes allocated from the current region, including the padding
+     * between allocations.
+     */
+    FvSize getUsed() const { return cursor - regionBegin; }
+
+  private:
+    FvSize regionSize;
+    uint32_t numRegions;
+    FvSize alignment;
+
+    /** Offset of the current region in the buffer. */
+    FvSize regionBegin;
+    /** Offset of the first byte not yet allocated. */
+    FvSize cursor;
+};
+}
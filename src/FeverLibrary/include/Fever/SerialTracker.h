@@ -0,0 +1,67 @@
+/*===-- Fever/SerialTracker.h - Completed submission serials ------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Tracks which submission serials have completed, when submissions
+ * may complete in any order.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace fv {
+/**
+ * The last serial up to which every submission has completed, see
+ * DeferredDestructionQueue.
+ *
+ * Submissions to different queues, or held back by a semaphore, complete out
+ * of order, so submission N + 1 may finish while N is still running. The
+ * completed serial only moves over serials that have all completed, those
+ * completed ahead of an earlier one are kept until the gap is filled.
+ *
+ * Serials are completed from any thread, each exactly once.
+ */
+class SerialTracker {
+  public:
+    SerialTracker() : completed(0) {}
+
+    SerialTracker(const SerialTracker &) = delete;
+    SerialTracker &operator=(const SerialTracker &) = delete;
+
+    /**
+     * Record that a submission has completed, waking threads waiting for it.
+     *
+     * \param serial Serial of the submission, starting at 1.
+     */
+    void complete(uint64_t serial);
+
+    /**
+     * Get the serial up to which every submission has completed, without
+     * blocking.
+     */
+    uint64_t getCompleted() const {
+        return completed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Block until every submission up to the given serial has completed.
+     */
+    void wait(uint64_t serial) const;
+
+  private:
+    mutable std::mutex mutex;
+    mutable std::condition_variable condition;
+    std::atomic<uint64_t> completed;
+    /** Serials completed ahead of an earlier one, sorted. */
+    std::vector<uint64_t> pending;
+};
+}
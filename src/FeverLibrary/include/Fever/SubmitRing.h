@@ -0,0 +1,90 @@
+/*===-- Fever/SubmitRing.h - Lock-free submission ring ------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Bounded queue passing submissions from any number of threads to the
+ * thread submitting them.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace fv {
+/**
+ * Bounded multi-producer, single-consumer ring of slots.
+ *
+ * Each slot carries a sequence number telling producers and the consumer
+ * whose turn it is, so pushing and popping are lock-free: a producer claims a
+ * slot with one compare-and-swap on the write position and publishes it with
+ * one store, the consumer needs no read-modify-write at all.
+ *
+ * Elements are filled and consumed in place and never destroyed until the
+ * ring is, so elements owning storage, like vectors, keep it from one use of
+ * the slot to the next.
+ *
+ * Any number of threads may push, only one thread may pop at a time.
+ */
+template <typename T> class SubmitRing {
+  public:
+    /**
+     * \param capacity Number of slots, rounded up to a power of two.
+     */
+    explicit SubmitRing(size_t capacity);
+
+    SubmitRing(const SubmitRing &) = delete;
+    SubmitRing &operator=(const SubmitRing &) = delete;
+
+    /**
+     * Claim a slot and fill it, unless the ring is full.
+     *
+     * \param  fill Called with the claimed element, on the calling thread.
+     * \return      Whether a slot was free.
+     */
+    template <typename Fill> bool tryPush(Fill &&fill);
+
+    /**
+     * Consume the oldest filled slot, unless the ring is empty.
+     *
+     * \param  consume Called with the oldest element, which stays valid until
+     *                 it returns.
+     * \return         Whether there was an element.
+     */
+    template <typename Consume> bool tryPop(Consume &&consume);
+
+    /**
+     * Get whether every pushed element has been popped.
+     *
+     * Only meaningful on the consumer thread, producers may push at any time.
+     */
+    bool empty() const;
+
+    /**
+     * Get the number of slots.
+     */
+    size_t capacity() const { return mask + 1; }
+
+  private:
+    struct Slot {
+        /** Equal to the position of the next push into the slot while it is
+         * free, one more once it has been filled. */
+        std::atomic<size_t> sequence;
+        T element;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<size_t> writePosition;
+    // Keeps producers and the consumer off each other's cache line
+    char padding[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> readPosition;
+};
+}
+
+#include <Fever/SubmitRing.hpp>
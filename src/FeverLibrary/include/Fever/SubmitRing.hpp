@@ -0,0 +1,75 @@
+#include <Fever/SubmitRing.h>
+
+namespace fv {
+template <typename T>
+SubmitRing<T>::SubmitRing(size_t capacity)
+    : writePosition(0), readPosition(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+template <typename Fill>
+bool SubmitRing<T>::tryPush(Fill &&fill) {
+    size_t position = writePosition.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot &slot = slots[position & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence == position) {
+            // Slot is free, claim it unless another producer got there first.
+            // Claims are ordered after every earlier claim, and what the
+            // producers making them did beforehand.
+            if (writePosition.compare_exchange_weak(
+                    position, position + 1, std::memory_order_acq_rel,
+                    std::memory_order_relaxed)) {
+                fill(slot.element);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < position) {
+            // The consumer hasn't got to the slot since it was last filled
+            return false;
+        } else {
+            // Another producer claimed the slot, try the next position
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+template <typename Consume>
+bool SubmitRing<T>::tryPop(Consume &&consume) {
+    const size_t position = readPosition.load(std::memory_order_relaxed);
+    Slot &slot            = slots[position & mask];
+
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    consume(slot.element);
+
+    // Hand the slot back to producers a lap later
+    readPosition.store(position + 1, std::memory_order_relaxed);
+    slot.sequence.store(position + mask + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T> bool SubmitRing<T>::empty() const {
+    const size_t position = readPosition.load(std::memory_order_relaxed);
+
+    return slots[position & mask].sequence.load(std::memory_order_acquire) !=
+           position + 1;
+}
+}
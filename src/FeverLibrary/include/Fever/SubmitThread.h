@@ -0,0 +1,146 @@
+/*===-- Fever/SubmitThread.h - Asynchronous submission ------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Thread making queue submissions on behalf of the application, so
+ * submitting returns as soon as the submission is copied.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Fever/Fence.h>
+#include <Fever/Fever.h>
+#include <Fever/SubmitRing.h>
+
+namespace fv {
+/**
+ * A copy of the arguments of one queue submit, owning every array the
+ * submissions point to.
+ */
+class SubmitBatch {
+  public:
+    /**
+     * Copy a queue submit into the batch, reusing the batch's storage.
+     *
+     * \param submissionsCount Number of submissions.
+     * \param submissions      Submissions to copy, with the arrays they point
+     *                         to.
+     * \param fence            Fence to signal once every submission has
+     *                         completed, or nullptr.
+     * \param firstSerial      Serial of the first submission, see
+     *                         DeferredDestructionQueue.
+     */
+    void assign(uint32_t submissionsCount, const FvSubmitInfo *submissions,
+                std::shared_ptr<Fence> fence, uint64_t firstSerial);
+
+    /**
+     * Get the copied submissions, which point into the batch.
+     */
+    const FvSubmitInfo *getSubmissions() const { return submissions.data(); }
+
+    uint32_t getSubmissionsCount() const {
+        return (uint32_t)submissions.size();
+    }
+
+    const std::shared_ptr<Fence> &getFence() const { return fence; }
+
+    uint64_t getFirstSerial() const { return firstSerial; }
+
+  private:
+    std::vector<FvSubmitInfo> submissions;
+    std::vector<FvSemaphore> semaphores;
+    std::vector<uint64_t> values;
+    std::vector<FvCommandBuffer> commandBuffers;
+    std::shared_ptr<Fence> fence;
+    uint64_t firstSerial;
+};
+
+/**
+ * Makes queue submissions on a thread of its own.
+ *
+ * 'push' copies a submit into a lock-free ring and returns, the thread drains
+ * the ring in order and hands each batch to the submit function. The caller
+ * only pays for the copy, while waiting on semaphores, encoding and
+ * committing happen on the submit thread.
+ *
+ * Any number of threads may push. The submit thread sleeps while the ring is
+ * empty, producers only take its lock to wake it up.
+ */
+class SubmitThread {
+  public:
+    /** Makes the submissions of a batch, on the submit thread. */
+    typedef std::function<void(const SubmitBatch &batch)> Submit;
+
+    /** Number of batches that can be waiting for the submit thread. */
+    static const size_t DEFAULT_CAPACITY = 64;
+
+    /**
+     * Start the submit thread.
+     *
+     * \param submit   Function making the submissions of a batch.
+     * \param capacity Number of batches that can be waiting before 'push'
+     *                 has to wait for the submit thread.
+     */
+    explicit SubmitThread(Submit submit, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Make every pushed submission and stop the submit thread.
+     */
+    ~SubmitThread();
+
+    SubmitThread(const SubmitThread &) = delete;
+    SubmitThread &operator=(const SubmitThread &) = delete;
+
+    /**
+     * Queue a submit for the submit thread.
+     *
+     * Returns once the submissions are copied, unless the ring is full, in
+     * which case it yields until the submit thread frees a slot.
+     *
+     * \copydetails SubmitBatch::assign
+     */
+    void push(uint32_t submissionsCount, const FvSubmitInfo *submissions,
+              std::shared_ptr<Fence> fence, uint64_t firstSerial);
+
+    /**
+     * Block until every submit pushed so far has been made.
+     *
+     * \pre Not called from the submit function.
+     */
+    void flush();
+
+  private:
+    /**
+     * Body of the submit thread.
+     */
+    void run();
+
+    SubmitRing<SubmitBatch> ring;
+    Submit submit;
+    /** Batches pushed, counted before they are claimed, and batches made. */
+    std::atomic<uint64_t> pushedCount;
+    uint64_t submittedCount;
+    /** Whether the submit thread is, or is about to be, asleep. */
+    std::atomic<bool> sleeping;
+    bool stopping;
+    /** Wakes the submit thread, and threads waiting in 'flush'. */
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushCondition;
+    std::thread thread;
+};
+}
@@ -0,0 +1,102 @@
+/*===-- Fever/TimelineSemaphore.h - 64-bit semaphore counter ------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Semaphore whose state is a counter that only goes up, so one
+ * semaphore can order any number of submissions.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace fv {
+/**
+ * A 64-bit value that only increases, signaled by the host or by completed
+ * submissions and waited on for reaching a value.
+ *
+ * Unlike a binary semaphore, signals and waits need not be paired: any number
+ * of waits may wait for the same value, and a wait for a value that has
+ * already been reached returns at once. A producer signaling frame N with
+ * value N lets every consumer of frame N, on any queue, wait on one
+ * semaphore.
+ *
+ * All functions are thread-safe.
+ */
+class TimelineSemaphore {
+  public:
+    /** Timeout that waits for as long as it takes. */
+    static const uint64_t WAIT_FOREVER = UINT64_MAX;
+
+    /** Called once the semaphore has reached a value. */
+    typedef std::function<void()> Callback;
+
+    /**
+     * \param initialValue Value the semaphore starts at.
+     */
+    explicit TimelineSemaphore(uint64_t initialValue = 0)
+        : value(initialValue) {}
+
+    TimelineSemaphore(const TimelineSemaphore &) = delete;
+    TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+
+    /**
+     * Get the current value.
+     */
+    uint64_t getValue() const;
+
+    /**
+     * Raise the semaphore to the given value, waking the waits and running
+     * the callbacks it satisfies on this thread.
+     *
+     * \return False, changing nothing, if \p newValue is not greater than the
+     *         current value.
+     */
+    bool signal(uint64_t newValue);
+
+    /**
+     * Block until the semaphore has reached a value.
+     *
+     * \param  waitValue Value to wait for.
+     * \param  timeout   Nanoseconds to wait for at most, 0 only checks the
+     *                   value and WAIT_FOREVER never gives up.
+     * \return           Whether the value was reached before the timeout.
+     */
+    bool wait(uint64_t waitValue, uint64_t timeout = WAIT_FOREVER) const;
+
+    /**
+     * Run a callback once the semaphore has reached a value, without
+     * blocking.
+     *
+     * The callback runs right away on this thread if the value has been
+     * reached already, otherwise on the thread of the signal reaching it.
+     * Callbacks still pending when the semaphore is destroyed never run.
+     */
+    void whenReached(uint64_t waitValue, Callback callback);
+
+    /**
+     * Get the number of callbacks waiting for a value.
+     */
+    size_t getNumPendingCallbacks() const;
+
+  private:
+    struct PendingCallback {
+        uint64_t value;
+        Callback callback;
+    };
+
+    mutable std::mutex mutex;
+    mutable std::condition_variable condition;
+    uint64_t value;
+    std::vector<PendingCallback> pending;
+};
+}
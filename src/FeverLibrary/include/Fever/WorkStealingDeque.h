@@ -0,0 +1,117 @@
+/*===-- Fever/WorkStealingDeque.h - Chase-Lev deque ---------------*- C++ -*-===
+ *
+ *                     The Fever Graphics Library
+ *
+ * This file is distributed under the MIT License. See LICENSE.txt for details.
+ *===----------------------------------------------------------------------===*/
+/**
+ * \file
+ * \brief Deque of work owned by one thread, which other threads steal from.
+ *
+ *===----------------------------------------------------------------------===*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fv {
+/**
+ * Chase-Lev work-stealing deque.
+ *
+ * The owning thread pushes and pops at the bottom, last in first out, so it
+ * keeps working on what it touched most recently. Any other thread steals from
+ * the top, first in first out, taking the oldest and usually largest pieces of
+ * work. Only the owner and thieves racing for the last element ever contend,
+ * settled by a compare-and-swap on the top.
+ *
+ * The ring of elements grows when full. Rings it grew out of are kept until
+ * the deque is destroyed, as thieves may still be reading them.
+ *
+ * Follows "Correct and Efficient Work-Stealing for Weak Memory Models" by Lê,
+ * Pop, Cohen and Zappa Nardelli.
+ *
+ * \tparam T Trivially copyable element type, e.g. a pointer.
+ */
+template <typename T> class WorkStealingDeque {
+  public:
+    /** Number of elements the deque holds before growing. */
+    static const size_t DEFAULT_CAPACITY = 256;
+
+    /**
+     * \param capacity Initial number of elements, rounded up to a power of
+     *                 two.
+     */
+    explicit WorkStealingDeque(size_t capacity = DEFAULT_CAPACITY);
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /**
+     * Push an element onto the bottom, growing the deque if it is full.
+     *
+     * \pre Called by the owning thread.
+     */
+    void push(T element);
+
+    /**
+     * Pop the element pushed last.
+     *
+     * \pre Called by the owning thread.
+     *
+     * \param  [out]element Popped element.
+     * \return              Whether there was an element left.
+     */
+    bool pop(T *element);
+
+    /**
+     * Steal the oldest element, from any thread.
+     *
+     * \param  [out]element Stolen element.
+     * \return              Whether an element was stolen, false if the deque
+     *                      was empty or another thread took the element.
+     */
+    bool steal(T *element);
+
+    /**
+     * Get whether the deque looked empty, which may have changed by the time
+     * this returns.
+     */
+    bool empty() const;
+
+  private:
+    /** Ring of elements indexed by ever increasing positions. */
+    struct Array {
+        explicit Array(size_t capacity)
+            : mask(capacity - 1), elements(new std::atomic<T>[capacity]) {}
+
+        size_t capacity() const { return mask + 1; }
+
+        T get(int64_t position) const {
+            return elements[position & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t position, T element) {
+            elements[position & mask].store(element,
+                                            std::memory_order_relaxed);
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> elements;
+    };
+
+    /** Position of the oldest element, raised by thieves and the owner. */
+    std::atomic<int64_t> top;
+    // Keeps thieves off the cache line of the owner's end
+    char padding[64 - sizeof(std::atomic<int64_t>)];
+    /** Position after the newest element, only written by the owner. */
+    std::atomic<int64_t> bottom;
+    std::atomic<Array *> array;
+    /** Every ring the deque has used, the current one last. */
+    std::vector<std::unique_ptr<Array>> arrays;
+};
+}
+
+#include <Fever/WorkStealingDeque.hpp>
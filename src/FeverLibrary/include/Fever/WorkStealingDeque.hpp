@@ -0,0 +1,95 @@
+#include <Fever/WorkStealingDeque.h>
+
+namespace fv {
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) : top(0), bottom(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    arrays.emplace_back(new Array(size));
+    array.store(arrays.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T> void WorkStealingDeque<T>::push(T element) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    Array *a        = array.load(std::memory_order_relaxed);
+
+    if (b - t > (int64_t)a->capacity() - 1) {
+        // Full, move the elements into a ring twice the size
+        Array *grown = new Array(a->capacity() * 2);
+        for (int64_t i = t; i < b; ++i) {
+            grown->put(i, a->get(i));
+        }
+
+        arrays.emplace_back(grown);
+        array.store(grown, std::memory_order_release);
+        a = grown;
+    }
+
+    a->put(b, element);
+
+    // Publish the element before the new bottom
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template <typename T> bool WorkStealingDeque<T>::pop(T *element) {
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Array *a        = array.load(std::memory_order_relaxed);
+
+    // Claim the bottom element before looking at what thieves have taken
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    *element = a->get(b);
+
+    if (t == b) {
+        // Last element, race the thieves for it
+        const bool won = top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    return true;
+}
+
+template <typename T> bool WorkStealingDeque<T>::steal(T *element) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return false;
+    }
+
+    Array *a          = array.load(std::memory_order_acquire);
+    const T candidate = a->get(t);
+
+    // Lost to the owner or another thief if the top moved on
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+        return false;
+    }
+
+    *element = candidate;
+    return true;
+}
+
+template <typename T> bool WorkStealingDeque<T>::empty() const {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_relaxed);
+
+    return t >= b;
+}
+}
@@ -0,0 +1,91 @@
+#include <Fever/BindingCache.h>
+
+namespace fv {
+BindingCache::BindingCache() { reset(); }
+
+bool BindingCache::bindGraphicsPipeline(FvGraphicsPipeline graphicsPipeline) {
+    const bool changed = this->graphicsPipeline != graphicsPipeline;
+
+    this->graphicsPipeline = graphicsPipeline;
+
+    return count(changed);
+}
+
+bool BindingCache::bindVertexBuffer(uint32_t binding, FvBuffer buffer,
+                                    FvSize offset) {
+    if (binding >= MAX_VERTEX_BUFFERS) {
+        return count(true);
+    }
+
+    const bool changed = vertexBuffers[binding] != buffer ||
+                         vertexBufferOffsets[binding] != offset;
+
+    vertexBuffers[binding]       = buffer;
+    vertexBufferOffsets[binding] = offset;
+
+    return count(changed);
+}
+
+bool BindingCache::bindIndexBuffer(FvBuffer buffer, FvSize offset,
+                                   FvIndexType indexType) {
+    const bool changed = indexBuffer != buffer ||
+                         indexBufferOffset != offset ||
+                         this->indexType != indexType;
+
+    indexBuffer       = buffer;
+    indexBufferOffset = offset;
+    this->indexType   = indexType;
+
+    return count(changed);
+}
+
+bool BindingCache::bindDescriptorSet(uint32_t set,
+                                     FvDescriptorSet descriptorSet,
+                                     bool hasDynamicOffsets) {
+    if (set >= MAX_DESCRIPTOR_SETS) {
+        return count(true);
+    }
+
+    const bool changed =
+        hasDynamicOffsets || descriptorSets[set] != descriptorSet;
+
+    descriptorSets[set] = descriptorSet;
+
+    return count(changed);
+}
+
+void BindingCache::invalidate() {
+    // Nothing can be bound as the null handle, so every bind is a change
+    graphicsPipeline = FV_NULL_HANDLE;
+
+    for (uint32_t i = 0; i < MAX_VERTEX_BUFFERS; ++i) {
+        vertexBuffers[i]       = FV_NULL_HANDLE;
+        vertexBufferOffsets[i] = 0;
+    }
+
+    indexBuffer       = FV_NULL_HANDLE;
+    indexBufferOffset = 0;
+    indexType         = FV_INDEX_TYPE_UINT16;
+
+    for (uint32_t i = 0; i < MAX_DESCRIPTOR_SETS; ++i) {
+        descriptorSets[i] = FV_NULL_HANDLE;
+    }
+}
+
+void BindingCache::reset() {
+    invalidate();
+
+    numBinds       = 0;
+    numElidedBinds = 0;
+}
+
+bool BindingCache::count(bool changed) {
+    ++numBinds;
+
+    if (!changed) {
+        ++numElidedBinds;
+    }
+
+    return changed;
+}
+}
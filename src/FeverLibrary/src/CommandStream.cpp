@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include <Fever/CommandStream.h>
+
+namespace fv {
+CommandBlockPool::CommandBlockPool(size_t blockSize)
+    : blockSize(blockSize), numBlocks(0) {}
+
+CommandBlock CommandBlockPool::acquire(size_t size) {
+    // Free blocks are at least 'blockSize' large, so any of them will do
+    // unless the command is oversized
+    if (!freeBlocks.empty() && freeBlocks.back().capacity >= size) {
+        CommandBlock block = std::move(freeBlocks.back());
+        freeBlocks.pop_back();
+
+        return block;
+    }
+
+    CommandBlock block;
+    block.capacity = std::max(blockSize, size);
+    block.data.reset(new uint8_t[block.capacity]);
+    block.used = 0;
+    ++numBlocks;
+
+    return block;
+}
+
+void CommandBlockPool::release(CommandBlock &&block) {
+    block.used = 0;
+    freeBlocks.push_back(std::move(block));
+}
+
+CommandStream::const_iterator::const_iterator(
+    const std::vector<CommandBlock> *blocks, size_t block, size_t endBlock)
+    : blocks(blocks), block(block), offset(0), endBlock(endBlock) {
+    skipFinishedBlocks();
+}
+
+CommandStream::const_iterator &CommandStream::const_iterator::operator++() {
+    offset += (**this).size;
+    skipFinishedBlocks();
+
+    return *this;
+}
+
+void CommandStream::const_iterator::skipFinishedBlocks() {
+    while (block < endBlock && offset == (*blocks)[block].used) {
+        ++block;
+        offset = 0;
+    }
+}
+
+CommandStream::CommandStream(size_t blockSize)
+    : blockSize(blockSize), pool(nullptr), currentBlock(0), numCommands(0) {}
+
+CommandStream::CommandStream(CommandBlockPool *pool)
+    : blockSize(DEFAULT_BLOCK_SIZE), pool(pool), currentBlock(0),
+      numCommands(0) {
+    assert(pool != nullptr);
+}
+
+CommandStream::~CommandStream() {
+    if (pool != nullptr) {
+        releaseBlocks();
+    }
+}
+
+CommandStream &CommandStream::operator=(CommandStream &&other) {
+    if (this != &other) {
+        if (pool != nullptr) {
+            releaseBlocks();
+        }
+
+        blockSize    = other.blockSize;
+        pool         = other.pool;
+        blocks       = std::move(other.blocks);
+        currentBlock = other.currentBlock;
+        numCommands  = other.numCommands;
+
+        other.blocks.clear();
+        other.currentBlock = 0;
+        other.numCommands  = 0;
+    }
+
+    return *this;
+}
+
+void CommandStream::reset() {
+    if (pool != nullptr) {
+        releaseBlocks();
+    } else {
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i].used = 0;
+        }
+    }
+
+    currentBlock = 0;
+    numCommands  = 0;
+}
+
+CommandStream::const_iterator CommandStream::begin() const {
+    return const_iterator(&blocks, 0, blocks.empty() ? 0 : currentBlock + 1);
+}
+
+CommandStream::const_iterator CommandStream::end() const {
+    const size_t endBlock = blocks.empty() ? 0 : currentBlock + 1;
+
+    return const_iterator(&blocks, endBlock, endBlock);
+}
+
+void *CommandStream::allocate(size_t size) {
+    if (blocks.empty() ||
+        blocks[currentBlock].used + size > blocks[currentBlock].capacity) {
+        nextBlock(size);
+    }
+
+    CommandBlock &block = blocks[currentBlock];
+    void *memory        = block.data.get() + block.used;
+    block.used += size;
+
+    return memory;
+}
+
+void CommandStream::nextBlock(size_t size) {
+    const size_t next = blocks.empty() ? 0 : currentBlock + 1;
+
+    // A pooled stream only holds blocks it has used, so the next one always
+    // comes from the pool
+    if (pool != nullptr) {
+        assert(next == blocks.size());
+
+        blocks.push_back(pool->acquire(size));
+        currentBlock = next;
+        return;
+    }
+
+    if (next < blocks.size() && blocks[next].capacity >= size) {
+        assert(blocks[next].used == 0);
+        currentBlock = next;
+        return;
+    }
+
+    // Oversized commands get a block of their own
+    CommandBlock block;
+    block.capacity = std::max(blockSize, size);
+    block.data.reset(new uint8_t[block.capacity]);
+    block.used = 0;
+
+    blocks.insert(blocks.begin() + next, std::move(block));
+    currentBlock = next;
+}
+
+void CommandStream::releaseBlocks() {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        pool->release(std::move(blocks[i]));
+    }
+
+    // Keeps the vector's capacity, so recording again does not allocate
+    blocks.clear();
+}
+}
@@ -0,0 +1,40 @@
+#include <cassert>
+#include <limits>
+#include <utility>
+
+#include <Fever/DeferredDestructionQueue.h>
+
+namespace fv {
+DeferredDestructionQueue::~DeferredDestructionQueue() { flush(); }
+
+void DeferredDestructionQueue::enqueue(uint64_t serial, Destroyer destroy) {
+    assert((entries.empty() || entries.back().serial <= serial) &&
+           "Destructions must be enqueued in serial order.");
+
+    Entry entry;
+    entry.serial  = serial;
+    entry.destroy = std::move(destroy);
+
+    entries.push_back(std::move(entry));
+}
+
+size_t DeferredDestructionQueue::collect(uint64_t completedSerial) {
+    size_t count = 0;
+
+    // Entries are sorted, so stop at the first one still in flight
+    while (!entries.empty() && entries.front().serial <= completedSerial) {
+        // Pop before destroying so the destroyer may enqueue more work
+        Destroyer destroy = std::move(entries.front().destroy);
+        entries.pop_front();
+
+        destroy();
+        ++count;
+    }
+
+    return count;
+}
+
+size_t DeferredDestructionQueue::flush() {
+    return collect(std::numeric_limits<uint64_t>::max());
+}
+}
@@ -0,0 +1,39 @@
+#include <chrono>
+
+#include <Fever/Fence.h>
+
+namespace fv {
+void Fence::signal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        signaled = true;
+    }
+
+    condition.notify_all();
+}
+
+void Fence::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    signaled = false;
+}
+
+bool Fence::isSignaled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return signaled;
+}
+
+bool Fence::wait(uint64_t timeout) const {
+    // Longer than any wait could last, and would overflow the clock
+    static const uint64_t MAX_TIMEOUT = 1ull << 62;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (timeout >= MAX_TIMEOUT) {
+        condition.wait(lock, [this]() { return signaled; });
+        return true;
+    }
+
+    return condition.wait_for(lock, std::chrono::nanoseconds(timeout),
+                              [this]() { return signaled; });
+}
+}
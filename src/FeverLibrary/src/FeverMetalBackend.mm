@@ -67,6 +67,77 @@ void fvSemaphoreDestroy(FvSemaphore semaphore) {
     }
 }
 
+FvResult fvSemaphoreCreateTimeline(FvSemaphore *semaphore,
+                                   uint64_t initialValue) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->semaphoreCreateTimeline(semaphore, initialValue);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvSemaphoreSignal(FvSemaphore semaphore, uint64_t value) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->semaphoreSignal(semaphore, value);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvSemaphoreWait(FvSemaphore semaphore, uint64_t value,
+                         uint64_t timeout) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->semaphoreWait(semaphore, value, timeout);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvSemaphoreGetCounterValue(FvSemaphore semaphore, uint64_t *value) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->semaphoreGetCounterValue(semaphore, value);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvFenceCreate(FvFence *fence, const FvFenceCreateInfo *createInfo) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->fenceCreate(fence, createInfo);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvFenceDestroy(FvFence fence) {
+    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->fenceDestroy(fence);
+    }
+}
+
+void fvFenceReset(FvFence fence) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->fenceReset(fence);
+    }
+}
+
+FvResult fvFenceWait(FvFence fence, uint64_t timeout) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->fenceWait(fence, timeout);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvFenceGetStatus(FvFence fence) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->fenceGetStatus(fence);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
 FvResult fvCreateSwapchain(FvSwapchain *swapchain,
                            const FvSwapchainCreateInfo *createInfo) {
     if (metalWrapper != nullptr) {
@@ -100,9 +171,9 @@ FvResult fvAcquireNextImage(FvSwapchain swapchain,
 }
 
 FvResult fvQueueSubmit(uint32_t submissionsCount,
-                       const FvSubmitInfo *submissions) {
+                       const FvSubmitInfo *submissions, FvFence fence) {
     if (metalWrapper != nullptr) {
-        return metalWrapper->queueSubmit(submissionsCount, submissions);
+        return metalWrapper->queueSubmit(submissionsCount, submissions, fence);
     } else {
         return FV_RESULT_FAILURE;
     }
@@ -152,10 +223,73 @@ void fvCmdEndRenderPass(FvCommandBuffer commandBuffer) {
     }
 }
 
+void fvCmdDrawIndirect(FvCommandBuffer commandBuffer, FvBuffer buffer,
+                       FvSize offset, uint32_t drawCount, uint32_t stride) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdDrawIndirect(commandBuffer, buffer, offset, drawCount,
+                                      stride);
+    }
+}
+
+void fvCmdDrawIndexedIndirect(FvCommandBuffer commandBuffer, FvBuffer buffer,
+                              FvSize offset, uint32_t drawCount,
+                              uint32_t stride) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdDrawIndexedIndirect(commandBuffer, buffer, offset,
+                                             drawCount, stride);
+    }
+}
+
+void fvCmdExecuteCommands(FvCommandBuffer commandBuffer,
+                          uint32_t commandBufferCount,
+                          const FvCommandBuffer *commandBuffers) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdExecuteCommands(commandBuffer, commandBufferCount,
+                                         commandBuffers);
+    }
+}
+
+void fvCmdCopyBuffer(FvCommandBuffer commandBuffer, FvBuffer srcBuffer,
+                     FvBuffer dstBuffer, uint32_t regionCount,
+                     const FvBufferCopy *regions) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer,
+                                    regionCount, regions);
+    }
+}
+
+void fvCmdCopyBufferToImage(FvCommandBuffer commandBuffer, FvBuffer srcBuffer,
+                            FvImage dstImage, uint32_t regionCount,
+                            const FvBufferImageCopy *regions) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdCopyBufferToImage(commandBuffer, srcBuffer, dstImage,
+                                           regionCount, regions);
+    }
+}
+
+FvResult fvGetQueue(FvQueueType type, FvQueue *queue) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->getQueue(type, queue);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
 FvResult fvCommandBufferCreate(FvCommandBuffer *commandBuffer,
                                FvCommandPool commandPool) {
     if (metalWrapper != nullptr) {
-        return metalWrapper->commandBufferCreate(commandBuffer, commandPool);
+        return metalWrapper->commandBufferCreate(commandBuffer, commandPool,
+                                                 false);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvCommandBufferCreateSecondary(FvCommandBuffer *commandBuffer,
+                                        FvCommandPool commandPool) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->commandBufferCreate(commandBuffer, commandPool,
+                                                 true);
     } else {
         return FV_RESULT_FAILURE;
     }
@@ -163,7 +297,9 @@ FvResult fvCommandBufferCreate(FvCommandBuffer *commandBuffer,
 
 void fvCommandBufferDestroy(FvCommandBuffer commandBuffer,
                             FvCommandPool commandPool) {
-    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->commandBufferDestroy(commandBuffer);
+    }
 }
 
 void fvCommandBufferBegin(FvCommandBuffer commandBuffer) {
@@ -172,6 +308,19 @@ void fvCommandBufferBegin(FvCommandBuffer commandBuffer) {
     }
 }
 
+void fvCommandBufferReset(FvCommandBuffer commandBuffer) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->commandBufferReset(commandBuffer);
+    }
+}
+
+void fvCommandBufferGetStatistics(FvCommandBuffer commandBuffer,
+                                  FvCommandBufferStatistics *statistics) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->commandBufferGetStatistics(commandBuffer, statistics);
+    }
+}
+
 FvResult fvCommandBufferEnd(FvCommandBuffer commandBuffer) {
     if (metalWrapper != nullptr) {
         return metalWrapper->commandBufferEnd(commandBuffer);
@@ -196,6 +345,12 @@ void fvCommandPoolDestroy(FvCommandPool commandPool) {
     }
 }
 
+void fvCommandPoolReset(FvCommandPool commandPool) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->commandPoolReset(commandPool);
+    }
+}
+
 FvResult fvFramebufferCreate(FvFramebuffer *framebuffer,
                              const FvFramebufferCreateInfo *createInfo) {
     if (metalWrapper != nullptr) {
@@ -236,6 +391,22 @@ void fvImageDestroy(FvImage image) {
     }
 }
 
+FvResult fvImagesCreate(uint32_t count, const FvImageCreateInfo *createInfos,
+                        FvImage *images) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->imagesCreate(count, createInfos, images);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvImagesDestroy(uint32_t count, const FvImage *images) {
+    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->imagesDestroy(count, images);
+    }
+}
+
 FvResult fvSamplerCreate(FvSampler *sampler,
                          const FvSamplerCreateInfo *createInfo) {
     if (metalWrapper != nullptr) {
@@ -252,6 +423,23 @@ void fvSamplerDestroy(FvSampler sampler) {
     }
 }
 
+FvResult fvSamplersCreate(uint32_t count,
+                          const FvSamplerCreateInfo *createInfos,
+                          FvSampler *samplers) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->samplersCreate(count, createInfos, samplers);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvSamplersDestroy(uint32_t count, const FvSampler *samplers) {
+    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->samplersDestroy(count, samplers);
+    }
+}
+
 FvResult
 fvGraphicsPipelineCreate(FvGraphicsPipeline *graphicsPipeline,
                          const FvGraphicsPipelineCreateInfo *createInfo) {
@@ -263,6 +451,18 @@ fvGraphicsPipelineCreate(FvGraphicsPipeline *graphicsPipeline,
     }
 }
 
+FvResult
+fvGraphicsPipelinesCreate(uint32_t createInfoCount,
+                          const FvGraphicsPipelineCreateInfo *createInfos,
+                          FvGraphicsPipeline *graphicsPipelines) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->graphicsPipelinesCreate(
+            createInfoCount, createInfos, graphicsPipelines);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
 void fvGraphicsPipelineDestroy(FvGraphicsPipeline graphicsPipeline) {
     assert(metalWrapper != nullptr);
     if (metalWrapper != nullptr) {
@@ -377,7 +577,50 @@ void fvDestroySurface(FvSurface surface) {
     metalLayer = nil;
 }
 
-void fvDeviceWaitIdle() {}
+void fvDeviceWaitIdle() {
+    if (metalWrapper != nullptr) {
+        metalWrapper->deviceWaitIdle();
+    }
+}
+
+FvResult fvJobCounterCreate(FvJobCounter *counter) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->jobCounterCreate(counter);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvJobCounterDestroy(FvJobCounter counter) {
+    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->jobCounterDestroy(counter);
+    }
+}
+
+FvResult fvJobRun(FvJobFunction function, void *userData,
+                  FvJobCounter counter, FvJobCounter dependency) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->jobRun(function, userData, counter, dependency);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvJobCounterWait(FvJobCounter counter) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->jobCounterWait(counter);
+    }
+}
+
+FvResult fvParallelFor(uint32_t count, uint32_t grainSize,
+                       FvParallelForFunction function, void *userData) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->parallelFor(count, grainSize, function, userData);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
 
 FvResult fvBufferCreate(FvBuffer *buffer,
                         const FvBufferCreateInfo *createInfo) {
@@ -395,12 +638,60 @@ void fvBufferDestroy(FvBuffer buffer) {
     }
 }
 
+FvResult fvBuffersCreate(uint32_t count, const FvBufferCreateInfo *createInfos,
+                         FvBuffer *buffers) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->buffersCreate(count, createInfos, buffers);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvBuffersDestroy(uint32_t count, const FvBuffer *buffers) {
+    assert(metalWrapper != nullptr);
+    if (metalWrapper != nullptr) {
+        metalWrapper->buffersDestroy(count, buffers);
+    }
+}
+
 void fvBufferReplaceData(FvBuffer buffer, void *data, size_t dataSize) {
     if (metalWrapper != nullptr) {
         return metalWrapper->bufferReplaceData(buffer, data, dataSize);
     }
 }
 
+FvResult fvBufferUpdateRange(FvBuffer buffer, FvSize offset, const void *data,
+                             FvSize size) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->bufferUpdateRange(buffer, offset, data, size);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvBufferMap(FvBuffer buffer, void **data) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->bufferMap(buffer, data);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+FvResult fvBufferFlushRanges(FvBuffer buffer, uint32_t rangeCount,
+                             const FvBufferRange *ranges) {
+    if (metalWrapper != nullptr) {
+        return metalWrapper->bufferFlushRanges(buffer, rangeCount, ranges);
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+}
+
+void fvBufferUnmap(FvBuffer buffer) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->bufferUnmap(buffer);
+    }
+}
+
 void fvCmdBindIndexBuffer(FvCommandBuffer commandBuffer, FvBuffer buffer,
                           FvSize offset, FvIndexType indexType) {
     if (metalWrapper != nullptr) {
@@ -412,10 +703,22 @@ void fvCmdBindIndexBuffer(FvCommandBuffer commandBuffer, FvBuffer buffer,
 void fvCmdBindDescriptorSets(FvCommandBuffer commandBuffer,
                              FvPipelineLayout layout, uint32_t firstSet,
                              uint32_t descriptorSetCount,
-                             const FvDescriptorSet *descriptorSets) {
+                             const FvDescriptorSet *descriptorSets,
+                             uint32_t dynamicOffsetCount,
+                             const uint32_t *dynamicOffsets) {
+    if (metalWrapper != nullptr) {
+        metalWrapper->cmdBindDescriptorSets(
+            commandBuffer, layout, firstSet, descriptorSetCount,
+            descriptorSets, dynamicOffsetCount, dynamicOffsets);
+    }
+}
+
+void fvCmdPushConstants(FvCommandBuffer commandBuffer, FvPipelineLayout layout,
+                        int stageFlags, uint32_t offset, uint32_t size,
+                        const void *values) {
     if (metalWrapper != nullptr) {
-        metalWrapper->cmdBindDescriptorSets(commandBuffer, layout, firstSet,
-                                            descriptorSetCount, descriptorSets);
+        metalWrapper->cmdPushConstants(commandBuffer, layout, stageFlags,
+                                       offset, size, values);
     }
 }
 
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include <Fever/FeverMetalWrapper.h>
 
 namespace fv {
@@ -21,10 +23,115 @@ FvResult MetalWrapper::init(const FvInitInfo *initInfo) {
     // Assign device to metal layer
     metalLayer.device = device;
 
+    // Indirect draws with a base instance need an iOS GPU family 3 device,
+    // every Mac has them
+#if TARGET_OS_IPHONE
+    nativeIndirectDraws =
+        [device supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily3_v1];
+#else
+    nativeIndirectDraws = true;
+#endif
+
+    // One command queue per queue type, Metal runs command queues alongside
+    // each other
+    for (uint32_t type = 0; type < NUM_QUEUE_TYPES; ++type) {
+        if (queueHandles[type] != nullptr) {
+            continue;
+        }
+
+        QueueWrapper queueWrapper;
+        queueWrapper.commandQueue = [device newCommandQueue];
+        queueWrapper.type         = (FvQueueType)type;
+
+        if (queueWrapper.commandQueue == nil) {
+            return FV_RESULT_FAILURE;
+        }
+
+        queueHandles[type] = addObject(queues, queueWrapper);
+
+        if (queueHandles[type] == nullptr) {
+            FV_MTL_RELEASE(queueWrapper.commandQueue);
+            return FV_RESULT_FAILURE;
+        }
+    }
+
+    if (jobs == nullptr) {
+        jobs.reset(new JobSystem(initInfo->jobWorkerCount != 0
+                                     ? initInfo->jobWorkerCount
+                                     : JobSystem::getDefaultNumWorkers()));
+    }
+
+    if (initInfo->asyncSubmission && submitThread == nullptr) {
+        submitThread.reset(new SubmitThread([this](const SubmitBatch &batch) {
+            // The submit thread has no autorelease pool of its own
+            @autoreleasepool {
+                if (submit(batch.getSubmissionsCount(), batch.getSubmissions(),
+                           batch.getFence(),
+                           batch.getFirstSerial()) != FV_RESULT_SUCCESS) {
+                    submitFailed.store(true);
+                }
+            }
+        }));
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::shutdown() {
+    // Makes every submission still queued
+    submitThread.reset();
+
+    jobs.reset();
+
+    // Objects still waiting on the GPU go now, while the device is alive
+    destructionQueue.flush();
+
+    for (uint32_t type = 0; type < NUM_QUEUE_TYPES; ++type) {
+        if (queueHandles[type] != nullptr) {
+            QueueWrapper *queueWrapper = queues.get(*queueHandles[type]);
+
+            if (queueWrapper != nullptr) {
+                FV_MTL_RELEASE(queueWrapper->commandQueue);
+            }
+
+            queues.remove(*queueHandles[type]);
+            queueHandles[type] = nullptr;
+        }
+    }
+
+    FV_MTL_RELEASE(device);
+}
+
+FvResult MetalWrapper::getQueue(FvQueueType type, FvQueue *queue) {
+    if (queue == nullptr || (uint32_t)type >= NUM_QUEUE_TYPES ||
+        queueHandles[type] == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    *queue = (FvQueue)queueHandles[type];
+
     return FV_RESULT_SUCCESS;
 }
 
-void MetalWrapper::shutdown() { FV_MTL_RELEASE(device); }
+void MetalWrapper::deferDestroy(DeferredDestructionQueue::Destroyer destroy) {
+    destructionQueue.enqueue(submittedSerial, std::move(destroy));
+
+    std::lock_guard<std::mutex> lock(objectMutex);
+    destructionQueue.collect(completedSerials.getCompleted());
+}
+
+void MetalWrapper::deviceWaitIdle() {
+    if (submitThread != nullptr) {
+        submitThread->flush();
+    }
+
+    const uint64_t serial = submittedSerial;
+
+    completedSerials.wait(serial);
+
+    std::lock_guard<std::mutex> lock(objectMutex);
+    destructionQueue.collect(serial);
+}
 
 FvResult
 MetalWrapper::descriptorSetCreate(FvDescriptorSet *descriptorSet,
@@ -34,6 +141,7 @@ MetalWrapper::descriptorSetCreate(FvDescriptorSet *descriptorSet,
     }
 
     DescriptorSetWrapper descriptorSetWrapper;
+    descriptorSetWrapper.bindings.reset(new MetalBindingTable());
 
     // Loop thru the descriptors we've been asked to create and add them to the
     // descriptor set
@@ -41,32 +149,26 @@ MetalWrapper::descriptorSetCreate(FvDescriptorSet *descriptorSet,
         FvDescriptorInfo descriptorInfo = createInfo->descriptors[i];
 
         switch (descriptorInfo.descriptorType) {
-        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
-            DescriptorBufferBinding bufferBinding;
-            bufferBinding.descriptorInfo    = descriptorInfo;
-            bufferBinding.bufferInfo.buffer = FV_NULL_HANDLE;
-            bufferBinding.bufferInfo.offset = 0;
-            bufferBinding.bufferInfo.range  = 0;
-
-            descriptorSetWrapper.bufferBindings.push_back(bufferBinding);
+        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            descriptorSetWrapper.bindings->addBufferSlot(
+                descriptorInfo.binding, descriptorInfo.stageFlags);
             break;
-        }
-        case FV_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
-            DescriptorImageBinding imageBinding;
-            imageBinding.descriptorInfo    = descriptorInfo;
-            imageBinding.imageInfo.image   = FV_NULL_HANDLE;
-            imageBinding.imageInfo.sampler = FV_NULL_HANDLE;
-
-            descriptorSetWrapper.imageBindings.push_back(imageBinding);
+        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            descriptorSetWrapper.bindings->addBufferSlot(
+                descriptorInfo.binding, descriptorInfo.stageFlags, true);
+            break;
+        case FV_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            descriptorSetWrapper.bindings->addImageSlot(
+                descriptorInfo.binding, descriptorInfo.stageFlags);
             break;
-        }
         default:
             break;
         }
     }
 
     // Store the descriptor set
-    const Handle *handle = descriptorSets.add(descriptorSetWrapper);
+    const ObjectHandle *handle =
+        addObject(descriptorSets, std::move(descriptorSetWrapper));
 
     // Return the descriptor set
     *descriptorSet = (FvDescriptorSet)handle;
@@ -75,10 +177,65 @@ MetalWrapper::descriptorSetCreate(FvDescriptorSet *descriptorSet,
 }
 
 void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
-    const Handle *handle = (const Handle *)descriptorSet;
+    const ObjectHandle *handle = (const ObjectHandle *)descriptorSet;
 
     if (handle != nullptr) {
-        descriptorSets.remove(*handle);
+        // Recorded binds point at the bindings, which submitted work may
+        // still replay, so wait for it
+        const ObjectHandle descriptorSetHandle = *handle;
+
+        deferDestroy([this, descriptorSetHandle]() {
+            DescriptorSetWrapper *descriptorSetWrapper =
+                descriptorSets.get(descriptorSetHandle);
+
+            if (descriptorSetWrapper != nullptr) {
+                releaseBindings(descriptorSetWrapper->bindings.get());
+            }
+
+            descriptorSets.remove(descriptorSetHandle);
+        });
+    }
+}
+
+void MetalWrapper::setBoundBuffer(MetalBindingTable *bindings,
+                                  uint32_t binding, id<MTLBuffer> buffer,
+                                  FvSize offset) {
+    for (const MetalBindingTable::BufferSlot &slot : bindings->getBuffers()) {
+        if (slot.binding == binding) {
+            // Retain before releasing, the buffer may be the one it replaces
+            id<MTLBuffer> previous = slot.buffer;
+
+            bindings->setBuffer(binding, [buffer retain], offset);
+            [previous release];
+            return;
+        }
+    }
+}
+
+void MetalWrapper::setBoundImage(MetalBindingTable *bindings, uint32_t binding,
+                                 id<MTLTexture> texture,
+                                 id<MTLSamplerState> sampler) {
+    for (const MetalBindingTable::ImageSlot &slot : bindings->getImages()) {
+        if (slot.binding == binding) {
+            id<MTLTexture> previousTexture      = slot.texture;
+            id<MTLSamplerState> previousSampler = slot.sampler;
+
+            bindings->setImage(binding, [texture retain], [sampler retain]);
+            [previousTexture release];
+            [previousSampler release];
+            return;
+        }
+    }
+}
+
+void MetalWrapper::releaseBindings(MetalBindingTable *bindings) {
+    for (const MetalBindingTable::BufferSlot &slot : bindings->getBuffers()) {
+        [slot.buffer release];
+    }
+
+    for (const MetalBindingTable::ImageSlot &slot : bindings->getImages()) {
+        [slot.texture release];
+        [slot.sampler release];
     }
 }
 
@@ -101,7 +258,8 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 //             descriptorPoolWrapper.pools.push_back(pool);
 //         }
 
-//         const Handle *handle = descriptorPools.add(descriptorPoolWrapper);
+//         const ObjectHandle *handle =
+//             descriptorPools.add(descriptorPoolWrapper);
 
 //         if (handle != nullptr) {
 //             *descriptorPool = (FvDescriptorPool)handle;
@@ -113,7 +271,7 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 // }
 
 // void MetalWrapper::descriptorPoolDestroy(FvDescriptorPool descriptorPool) {
-//     const Handle *handle = (const Handle *)descriptorPool;
+//     const ObjectHandle *handle = (const ObjectHandle *)descriptorPool;
 
 //     if (handle != nullptr) {
 //         DescriptorPoolWrapper *descriptorPoolWrapper =
@@ -129,7 +287,8 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 //                      ++j) {
 //                     // Remove descriptor set from internal store
 //                     descriptorSets.remove(
-//                         *((const Handle *)descriptorPoolWrapper->pools[i]
+//                         *((const ObjectHandle *)descriptorPoolWrapper
+//                               ->pools[i]
 //                               .descriptorSets[j]));
 //                 }
 //             }
@@ -147,7 +306,8 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 
 //     if (descriptorSets != nullptr && allocateInfo != nullptr) {
 //         // Get descriptor pool to allocate from
-//         const Handle *handle = (const Handle *)allocateInfo->descriptorPool;
+//         const ObjectHandle *handle =
+//             (const ObjectHandle *)allocateInfo->descriptorPool;
 
 //         if (handle != nullptr) {
 //             DescriptorPoolWrapper *descriptorPoolWrapper =
@@ -167,7 +327,8 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 //                     // Get descriptor set layout wrapper
 //                     DescriptorSetLayoutWrapper *descriptorSetLayoutWrapper =
 //                         this->descriptorSetLayouts.get(
-//                             *((const Handle *)descriptorSetLayoutHandle));
+//                             *((const ObjectHandle *)
+//                                   descriptorSetLayoutHandle));
 
 //                     if (descriptorSetLayoutWrapper != nullptr) {
 //                         // Loop thru each binding and ensure an appropriate
@@ -191,7 +352,7 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 //                                         .descriptorSetsType) {
 //                                     poolFound = true;
 //                                     // Add descriptor set to internal store
-//                                     const Handle *handle =
+//                                     const ObjectHandle *handle =
 //                                         this->descriptorSets.add(
 //                                             descriptorSetWrapper);
 
@@ -228,32 +389,75 @@ void MetalWrapper::descriptorSetDestroy(FvDescriptorSet descriptorSet) {
 void MetalWrapper::updateDescriptorSets(
     uint32_t descriptorWriteCount,
     const FvWriteDescriptorSet *descriptorWrites) {
+    // The submit thread may be reading the bindings
+    std::lock_guard<std::mutex> lock(objectMutex);
+
     // For each write
     for (uint32_t i = 0; i < descriptorWriteCount; ++i) {
         FvWriteDescriptorSet write = descriptorWrites[i];
 
         // Get descriptor set to write to
-        DescriptorSetWrapper *descSet =
-            descriptorSets.get(*((const Handle *)write.dstSet));
+        DescriptorSetWrapper *descSet = nullptr;
+
+        const ObjectHandle *handle = (const ObjectHandle *)write.dstSet;
+
+        if (handle != nullptr) {
+            descSet = descriptorSets.get(*handle);
+        }
 
-        // Find which descriptor to write to in descriptor set using binding
-        // point as key
+        if (descSet == nullptr) {
+            continue;
+        }
+
+        // Resolve the written handles now rather than every time the
+        // descriptor set is bound. Invalid handles leave the slot unbound.
         switch (write.descriptorType) {
-        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
-            DescriptorBufferBinding *bufferBinding =
-                descSet->getBufferBinding(write.dstBinding);
+        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC: {
+            if (write.bufferInfo == nullptr) {
+                break;
+            }
+
+            const ObjectHandle *bufferHandle =
+                (const ObjectHandle *)write.bufferInfo->buffer;
+            const BufferWrapper *bufferWrapper = nullptr;
 
-            if (bufferBinding != nullptr) {
-                bufferBinding->bufferInfo = *(write.bufferInfo);
+            if (bufferHandle != nullptr) {
+                bufferWrapper = buffers.get(*bufferHandle);
             }
+
+            setBoundBuffer(
+                descSet->bindings.get(), write.dstBinding,
+                bufferWrapper != nullptr ? bufferWrapper->mtlBuffer : nil,
+                write.bufferInfo->offset);
             break;
         }
         case FV_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
-            DescriptorImageBinding *imageBinding =
-                descSet->getImageBinding(write.dstBinding);
+            if (write.imageInfo == nullptr) {
+                break;
+            }
+
+            const ObjectHandle *imageHandle =
+                (const ObjectHandle *)write.imageInfo->image;
+            const ObjectHandle *samplerHandle =
+                (const ObjectHandle *)write.imageInfo->sampler;
+            const ImageWrapper *imageWrapper      = nullptr;
+            const id<MTLSamplerState> *mtlSampler = nullptr;
+
+            if (imageHandle != nullptr) {
+                imageWrapper = textures.get(*imageHandle);
+            }
+            if (samplerHandle != nullptr) {
+                mtlSampler = samplers.get(*samplerHandle);
+            }
 
-            if (imageBinding != nullptr) {
-                imageBinding->imageInfo = *(write.imageInfo);
+            // An image is only bound together with its sampler
+            if (imageWrapper != nullptr && mtlSampler != nullptr) {
+                setBoundImage(descSet->bindings.get(), write.dstBinding,
+                              imageWrapper->texture, *mtlSampler);
+            } else {
+                setBoundImage(descSet->bindings.get(), write.dstBinding, nil,
+                              nil);
             }
             break;
         }
@@ -276,7 +480,7 @@ void MetalWrapper::updateDescriptorSets(
 //                 createInfo->bindings[i]);
 //         }
 
-//         const Handle *handle =
+//         const ObjectHandle *handle =
 //             descriptorSetLayouts.add(descriptorSetLayoutWrapper);
 
 //         if (handle != nullptr) {
@@ -290,32 +494,33 @@ void MetalWrapper::updateDescriptorSets(
 
 // void MetalWrapper::descriptorSetLayoutDestroy(
 //     FvDescriptorSetLayout descriptorSetLayout) {
-//     const Handle *handle = (const Handle *)descriptorSetLayout;
+//     const ObjectHandle *handle = (const ObjectHandle *)descriptorSetLayout;
 
 //     if (handle != nullptr) {
 //         descriptorSetLayouts.remove(*handle);
 //     }
 // }
 
+id<MTLBuffer>
+MetalWrapper::newMtlBuffer(const FvBufferCreateInfo *createInfo) {
+    if (createInfo->data == nullptr) {
+        return [device newBufferWithLength:createInfo->size options:0];
+    } else {
+        return [device newBufferWithBytes:createInfo->data
+                                   length:createInfo->size
+                                  options:0];
+    }
+}
+
 FvResult MetalWrapper::bufferCreate(FvBuffer *buffer,
                                     const FvBufferCreateInfo *createInfo) {
     FvResult result = FV_RESULT_FAILURE;
 
     if (buffer != nullptr && createInfo != nullptr) {
-        id<MTLBuffer> mtlBuffer = nil;
-
-        if (createInfo->data == nullptr) {
-            mtlBuffer = [device newBufferWithLength:createInfo->size options:0];
-        } else {
-            mtlBuffer = [device newBufferWithBytes:createInfo->data
-                                            length:createInfo->size
-                                           options:0];
-        }
-
         BufferWrapper bufferWrapper;
-        bufferWrapper.mtlBuffer = mtlBuffer;
+        bufferWrapper.mtlBuffer = newMtlBuffer(createInfo);
 
-        const Handle *handle = buffers.add(bufferWrapper);
+        const ObjectHandle *handle = addObject(buffers, bufferWrapper);
 
         if (handle != nullptr) {
             *buffer = (FvBuffer)handle;
@@ -326,210 +531,564 @@ FvResult MetalWrapper::bufferCreate(FvBuffer *buffer,
     return result;
 }
 
-void MetalWrapper::bufferDestroy(FvBuffer buffer) {
-    const Handle *handle = (const Handle *)buffer;
+FvResult MetalWrapper::buffersCreate(uint32_t count,
+                                     const FvBufferCreateInfo *createInfos,
+                                     FvBuffer *buffers) {
+    if (count == 0) {
+        return FV_RESULT_SUCCESS;
+    }
+    if (createInfos == nullptr || buffers == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
 
-    if (handle != nullptr) {
-        BufferWrapper *bufferWrapper = buffers.get(*handle);
+    // Find room for every handle up front rather than growing per buffer
+    {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        this->buffers.reserve(count);
+    }
 
-        if (bufferWrapper != nullptr) {
-            FV_MTL_RELEASE(bufferWrapper->mtlBuffer);
-        }
+    @autoreleasepool {
+        for (uint32_t i = 0; i < count; ++i) {
+            BufferWrapper bufferWrapper;
+            bufferWrapper.mtlBuffer = newMtlBuffer(&createInfos[i]);
 
-        buffers.remove(*handle);
-    }
-}
+            const ObjectHandle *handle = nullptr;
+            if (bufferWrapper.mtlBuffer != nil) {
+                handle = addObject(this->buffers, bufferWrapper);
+            }
 
-void MetalWrapper::bufferReplaceData(FvBuffer buffer, void *data,
-                                     size_t dataSize) {
-    // Get buffer wrapper
-    BufferWrapper *bufferWrapper = buffers.get(*((const Handle *)buffer));
+            if (handle == nullptr) {
+                // All or nothing, undo the buffers created so far
+                FV_MTL_RELEASE(bufferWrapper.mtlBuffer);
+                buffersDestroy(i, buffers);
+                return FV_RESULT_FAILURE;
+            }
 
-    if (bufferWrapper != nullptr) {
-        // Get buffer data pointer
-        void *bufferData = [bufferWrapper->mtlBuffer contents];
-        // Copy data to buffer
-        memcpy(bufferData, data, dataSize);
-        // Notify GPU that we modified buffer's contents (only applies if
-        // storage mode is managed)
-        // [bufferWrapper->mtlBuffer
-        //     didModifyRange:NSMakeRange((NSUInteger)bufferData, dataSize)];
+            buffers[i] = (FvBuffer)handle;
+        }
     }
+
+    return FV_RESULT_SUCCESS;
 }
 
-FvResult MetalWrapper::semaphoreCreate(FvSemaphore *semaphore) {
-    FvResult result = FV_RESULT_FAILURE;
+void MetalWrapper::bufferDestroy(FvBuffer buffer) {
+    const ObjectHandle *handle = (const ObjectHandle *)buffer;
 
-    if (semaphore != nullptr) {
-        SemaphoreWrapper semaphoreWrapper;
+    if (handle != nullptr) {
+        // Submitted work may still read the buffer, so wait for it
+        const ObjectHandle bufferHandle = *handle;
 
-        const Handle *handle = semaphores.add(semaphoreWrapper);
+        deferDestroy([this, bufferHandle]() {
+            BufferWrapper *bufferWrapper = buffers.get(bufferHandle);
 
-        if (handle != nullptr) {
-            *semaphore = (FvSemaphore)handle;
-            result     = FV_RESULT_SUCCESS;
-        }
+            if (bufferWrapper != nullptr) {
+                FV_MTL_RELEASE(bufferWrapper->mtlBuffer);
+            }
+
+            buffers.remove(bufferHandle);
+        });
     }
+}
 
-    return result;
+void MetalWrapper::buffersDestroy(uint32_t count, const FvBuffer *buffers) {
+    if (buffers == nullptr) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        bufferDestroy(buffers[i]);
+    }
 }
 
-void MetalWrapper::semaphoreDestroy(FvSemaphore semaphore) {
-    const Handle *handle = (const Handle *)semaphore;
+void MetalWrapper::bufferReplaceData(FvBuffer buffer, void *data,
+                                     size_t dataSize) {
+    bufferUpdateRange(buffer, 0, data, dataSize);
+}
 
-    if (handle != nullptr) {
-        SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
+bool MetalWrapper::isRangeInBuffer(id<MTLBuffer> buffer, FvSize offset,
+                                   FvSize size) {
+    const FvSize length = [buffer length];
 
-        if (semaphoreWrapper != nullptr) {
-            semaphoreWrapper->release();
-        }
+    return offset <= length && size <= length - offset;
+}
 
-        semaphores.remove(*handle);
+void MetalWrapper::didModifyRange(id<MTLBuffer> buffer, FvSize offset,
+                                  FvSize size) {
+    // Only buffers with managed storage keep a copy for the GPU
+    if (size != 0 && buffer.storageMode == MTLStorageModeManaged) {
+        [buffer didModifyRange:NSMakeRange((NSUInteger)offset,
+                                           (NSUInteger)size)];
     }
 }
 
-FvResult MetalWrapper::acquireNextImage(FvSwapchain swapchain,
-                                        FvSemaphore imageAvailableSemaphore) {
-    const Handle *handle = (const Handle *)swapchain;
+FvResult MetalWrapper::bufferUpdateRange(FvBuffer buffer, FvSize offset,
+                                         const void *data, FvSize size) {
+    const ObjectHandle *handle = (const ObjectHandle *)buffer;
 
-    if (handle == nullptr) {
+    if (handle == nullptr || (data == nullptr && size != 0)) {
         return FV_RESULT_FAILURE;
     }
 
-    SwapchainWrapper *swapchainWrapper = swapchains.get(*handle);
+    BufferWrapper *bufferWrapper = buffers.get(*handle);
 
-    CGSize drawableSize;
-    drawableSize.width  = swapchainWrapper->extent.width;
-    drawableSize.height = swapchainWrapper->extent.height;
+    if (bufferWrapper == nullptr ||
+        !isRangeInBuffer(bufferWrapper->mtlBuffer, offset, size)) {
+        return FV_RESULT_FAILURE;
+    }
 
-    metalLayer.drawableSize = drawableSize;
+    uint8_t *bufferData = (uint8_t *)[bufferWrapper->mtlBuffer contents];
+    memcpy(bufferData + offset, data, (size_t)size);
+    didModifyRange(bufferWrapper->mtlBuffer, offset, size);
 
-    currentDrawable = [metalLayer nextDrawable];
+    return FV_RESULT_SUCCESS;
+}
 
-    // Signal semaphore immediately
-    // (Metal nextDrawable is blocking and so when it returns, image is ready)
-    handle = (const Handle *)imageAvailableSemaphore;
+FvResult MetalWrapper::bufferMap(FvBuffer buffer, void **data) {
+    const ObjectHandle *handle = (const ObjectHandle *)buffer;
 
-    if (handle != nullptr) {
-        SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
+    if (handle == nullptr || data == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
 
-        if (semaphoreWrapper != nullptr) {
-            semaphoreWrapper->signal();
-        }
+    BufferWrapper *bufferWrapper = buffers.get(*handle);
+
+    if (bufferWrapper == nullptr) {
+        return FV_RESULT_FAILURE;
     }
 
+    // CPU accessible Metal buffers are always mapped, at the same address
+    *data = [bufferWrapper->mtlBuffer contents];
+    ++bufferWrapper->mapCount;
+
     return FV_RESULT_SUCCESS;
 }
 
-FvResult
-MetalWrapper::createSwapchain(FvSwapchain *swapchain,
-                              const FvSwapchainCreateInfo *createInfo) {
-    if (createInfo == nullptr || swapchain == nullptr) {
+FvResult MetalWrapper::bufferFlushRanges(FvBuffer buffer, uint32_t rangeCount,
+                                         const FvBufferRange *ranges) {
+    const ObjectHandle *handle = (const ObjectHandle *)buffer;
+
+    if (handle == nullptr || (ranges == nullptr && rangeCount != 0)) {
         return FV_RESULT_FAILURE;
     }
 
-    SwapchainWrapper swapchainWrapper;
-    swapchainWrapper.extent = createInfo->extent;
-
-    // Store swapchain wrapper and return handle
-    const Handle *handle = swapchains.add(swapchainWrapper);
+    BufferWrapper *bufferWrapper = buffers.get(*handle);
 
-    if (handle != nullptr) {
-        *swapchain = (FvSwapchain)handle;
-    } else {
+    if (bufferWrapper == nullptr || bufferWrapper->mapCount == 0) {
         return FV_RESULT_FAILURE;
     }
 
+    // Check every range before flushing any
+    for (uint32_t i = 0; i < rangeCount; ++i) {
+        if (!isRangeInBuffer(bufferWrapper->mtlBuffer, ranges[i].offset,
+                             ranges[i].size)) {
+            return FV_RESULT_FAILURE;
+        }
+    }
+
+    for (uint32_t i = 0; i < rangeCount; ++i) {
+        didModifyRange(bufferWrapper->mtlBuffer, ranges[i].offset,
+                       ranges[i].size);
+    }
+
     return FV_RESULT_SUCCESS;
 }
 
-void MetalWrapper::destroySwapchain(FvSwapchain swapchain) {
-    const Handle *handle = (const Handle *)swapchain;
+void MetalWrapper::bufferUnmap(FvBuffer buffer) {
+    const ObjectHandle *handle = (const ObjectHandle *)buffer;
 
     if (handle != nullptr) {
-        // SwapchainWrapper *swapchainWrapper = swapchains.get(*handle);
+        BufferWrapper *bufferWrapper = buffers.get(*handle);
 
-        swapchains.remove(*handle);
+        if (bufferWrapper != nullptr && bufferWrapper->mapCount > 0) {
+            --bufferWrapper->mapCount;
+        }
     }
 }
 
-void MetalWrapper::getSwapchainImage(FvSwapchain swapchain,
-                                     FvImage *swapchainImage) {
-    // Create drawable image
-    ImageWrapper imageWrapper;
-    imageWrapper.isDrawable = true;
-    imageWrapper.texture    = nil;
+FvResult MetalWrapper::semaphoreCreate(FvSemaphore *semaphore) {
+    FvResult result = FV_RESULT_FAILURE;
 
-    // Store texture and return handle
-    const Handle *handle = textures.add(imageWrapper);
+    if (semaphore != nullptr) {
+        SemaphoreWrapper semaphoreWrapper;
 
-    if (handle != nullptr) {
-        *swapchainImage = (FvImage)handle;
+        const ObjectHandle *handle = addObject(semaphores, semaphoreWrapper);
+
+        if (handle != nullptr) {
+            *semaphore = (FvSemaphore)handle;
+            result     = FV_RESULT_SUCCESS;
+        }
     }
+
+    return result;
 }
 
-void MetalWrapper::queuePresent(const FvPresentInfo *presentInfo) {
-    if (presentInfo != nullptr) {
-        // Wait for semaphores
-        for (uint32_t i = 0; i < presentInfo->waitSemaphoreCount; ++i) {
-            FvSemaphore semaphore = presentInfo->waitSemaphores[i];
+FvResult MetalWrapper::semaphoreCreateTimeline(FvSemaphore *semaphore,
+                                               uint64_t initialValue) {
+    if (semaphore == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
 
-            // Get internal semaphore
-            const Handle *handle = (const Handle *)semaphore;
+    SemaphoreWrapper semaphoreWrapper;
+    semaphoreWrapper.timeline =
+        std::make_shared<TimelineSemaphore>(initialValue);
 
-            if (handle != nullptr) {
-                SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
+    const ObjectHandle *handle = addObject(semaphores, semaphoreWrapper);
 
-                if (semaphoreWrapper != nullptr) {
-                    semaphoreWrapper->wait();
-                }
-            }
-        }
+    if (handle == nullptr) {
+        semaphoreWrapper.release();
+        return FV_RESULT_FAILURE;
+    }
 
-        // TODO: Expand for multiple presentation images
-        // uint32_t imageIndex = presentInfo->imageIndices[0];
+    *semaphore = (FvSemaphore)handle;
 
-        @autoreleasepool {
-            // Make separate command buffer to schedule drawable presentation
-            // and submit it
-            id<MTLCommandBuffer> commandBuffer =
-                [currentCommandQueue commandBuffer];
+    return FV_RESULT_SUCCESS;
+}
 
-            [commandBuffer presentDrawable:currentDrawable];
+SemaphoreWrapper *MetalWrapper::getSemaphore(FvSemaphore semaphore) {
+    const ObjectHandle *handle = (const ObjectHandle *)semaphore;
 
-            [commandBuffer commit];
+    return handle != nullptr ? semaphores.get(*handle) : nullptr;
+}
 
-            currentDrawable = nil;
+std::shared_ptr<TimelineSemaphore>
+MetalWrapper::getTimelineSemaphore(FvSemaphore semaphore) {
+    const SemaphoreWrapper *semaphoreWrapper = getSemaphore(semaphore);
 
-            currentCommandQueue = nil;
-        }
+    return semaphoreWrapper != nullptr ? semaphoreWrapper->timeline : nullptr;
+}
 
-        // Can now re-use drawable, so free it from swapchain
-        /*
-        for (uint32_t i = 0; i < currentSwapchain.size(); ++i) {
-            if (i == imageIndex) {
-                currentSwapchain[i] = nil;
-            }
-        }
-        */
+FvResult MetalWrapper::semaphoreSignal(FvSemaphore semaphore, uint64_t value) {
+    std::shared_ptr<TimelineSemaphore> timeline =
+        getTimelineSemaphore(semaphore);
+
+    if (timeline == nullptr || !timeline->signal(value)) {
+        return FV_RESULT_FAILURE;
     }
+
+    return FV_RESULT_SUCCESS;
 }
 
-FvResult MetalWrapper::queueSubmit(uint32_t submissionsCount,
-                                   const FvSubmitInfo *submissions) {
-    if (submissions == nullptr && submissionsCount != 0) {
+FvResult MetalWrapper::semaphoreWait(FvSemaphore semaphore, uint64_t value,
+                                     uint64_t timeout) {
+    // Waits on its own reference, in case another thread destroys the
+    // semaphore
+    std::shared_ptr<TimelineSemaphore> timeline =
+        getTimelineSemaphore(semaphore);
+
+    if (timeline == nullptr) {
         return FV_RESULT_FAILURE;
     }
 
-    // Loop thru each submission
-    for (uint32_t i = 0; i < submissionsCount; ++i) {
+    return timeline->wait(value, timeout) ? FV_RESULT_SUCCESS
+                                          : FV_RESULT_TIMEOUT;
+}
 
-        // Wait for semaphores
-        for (uint32_t j = 0; j < submissions[i].waitSemaphoreCount; ++j) {
-            FvSemaphore semaphore = submissions[i].waitSemaphores[j];
+FvResult MetalWrapper::semaphoreGetCounterValue(FvSemaphore semaphore,
+                                                uint64_t *value) {
+    std::shared_ptr<TimelineSemaphore> timeline =
+        getTimelineSemaphore(semaphore);
+
+    if (timeline == nullptr || value == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    *value = timeline->getValue();
+
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::semaphoreDestroy(FvSemaphore semaphore) {
+    const ObjectHandle *handle = (const ObjectHandle *)semaphore;
+
+    if (handle != nullptr) {
+        std::lock_guard<std::mutex> lock(objectMutex);
+
+        SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
+
+        // Pending submissions hold their own references to the semaphore
+        if (semaphoreWrapper != nullptr) {
+            semaphoreWrapper->release();
+        }
+
+        semaphores.remove(*handle);
+    }
+}
+
+FvResult MetalWrapper::jobCounterCreate(FvJobCounter *counter) {
+    if (counter == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    JobCounterWrapper jobCounterWrapper;
+    jobCounterWrapper.counter = std::make_shared<JobCounter>();
+
+    const ObjectHandle *handle =
+        addObject(jobCounters, std::move(jobCounterWrapper));
+
+    if (handle == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    *counter = (FvJobCounter)handle;
+
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::jobCounterDestroy(FvJobCounter counter) {
+    const ObjectHandle *handle = (const ObjectHandle *)counter;
+
+    if (handle != nullptr) {
+        jobCounters.remove(*handle);
+    }
+}
+
+JobCounter *MetalWrapper::getJobCounter(FvJobCounter counter) {
+    const ObjectHandle *handle = (const ObjectHandle *)counter;
+
+    if (handle != nullptr) {
+        JobCounterWrapper *jobCounterWrapper = jobCounters.get(*handle);
+
+        if (jobCounterWrapper != nullptr) {
+            return jobCounterWrapper->counter.get();
+        }
+    }
+
+    return nullptr;
+}
+
+void MetalWrapper::jobCounterWait(FvJobCounter counter) {
+    JobCounter *jobCounter = getJobCounter(counter);
+
+    if (jobCounter != nullptr) {
+        jobs->wait(*jobCounter);
+    }
+}
+
+FvResult MetalWrapper::jobRun(FvJobFunction function, void *userData,
+                              FvJobCounter counter, FvJobCounter dependency) {
+    if (function == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    JobCounter *jobCounter        = getJobCounter(counter);
+    JobCounter *dependencyCounter = getJobCounter(dependency);
+
+    if ((counter != FV_NULL_HANDLE && jobCounter == nullptr) ||
+        (dependency != FV_NULL_HANDLE && dependencyCounter == nullptr)) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // Jobs run on worker threads, which have no autorelease pool of their own
+    const auto job = [function, userData]() {
+        @autoreleasepool {
+            function(userData);
+        }
+    };
+
+    if (dependencyCounter != nullptr) {
+        jobs->runAfter(*dependencyCounter, job, jobCounter);
+    } else {
+        jobs->run(job, jobCounter);
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+FvResult MetalWrapper::parallelFor(uint32_t count, uint32_t grainSize,
+                                   FvParallelForFunction function,
+                                   void *userData) {
+    if (function == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    jobs->parallelFor(count, grainSize,
+                      [function, userData](uint32_t begin, uint32_t end) {
+                          @autoreleasepool {
+                              function(userData, begin, end);
+                          }
+                      });
+
+    return FV_RESULT_SUCCESS;
+}
+
+FvResult MetalWrapper::fenceCreate(FvFence *fence,
+                                   const FvFenceCreateInfo *createInfo) {
+    if (fence == nullptr || createInfo == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    FenceWrapper fenceWrapper;
+    fenceWrapper.fence =
+        std::make_shared<Fence>(createInfo->signaled != FV_FALSE);
+
+    const ObjectHandle *handle = addObject(fences, std::move(fenceWrapper));
+
+    if (handle == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    *fence = (FvFence)handle;
+
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::fenceDestroy(FvFence fence) {
+    const ObjectHandle *handle = (const ObjectHandle *)fence;
+
+    // Pending completion handlers keep their own reference to the fence
+    if (handle != nullptr) {
+        fences.remove(*handle);
+    }
+}
+
+void MetalWrapper::fenceReset(FvFence fence) {
+    const ObjectHandle *handle = (const ObjectHandle *)fence;
+
+    if (handle != nullptr) {
+        FenceWrapper *fenceWrapper = fences.get(*handle);
+
+        if (fenceWrapper != nullptr) {
+            fenceWrapper->fence->reset();
+        }
+    }
+}
+
+FvResult MetalWrapper::fenceWait(FvFence fence, uint64_t timeout) {
+    const ObjectHandle *handle = (const ObjectHandle *)fence;
+    std::shared_ptr<Fence> fenceObject;
+
+    if (handle != nullptr) {
+        const FenceWrapper *fenceWrapper = fences.get(*handle);
+
+        if (fenceWrapper != nullptr) {
+            fenceObject = fenceWrapper->fence;
+        }
+    }
+
+    if (fenceObject == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // Waits on its own reference, in case another thread destroys the fence
+    return fenceObject->wait(timeout) ? FV_RESULT_SUCCESS : FV_RESULT_TIMEOUT;
+}
+
+FvResult MetalWrapper::fenceGetStatus(FvFence fence) {
+    const ObjectHandle *handle = (const ObjectHandle *)fence;
+    const FenceWrapper *fenceWrapper = nullptr;
+
+    if (handle != nullptr) {
+        fenceWrapper = fences.get(*handle);
+    }
+
+    if (fenceWrapper == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    return fenceWrapper->fence->isSignaled() ? FV_RESULT_SUCCESS
+                                             : FV_RESULT_NOT_READY;
+}
+
+FvResult MetalWrapper::acquireNextImage(FvSwapchain swapchain,
+                                        FvSemaphore imageAvailableSemaphore) {
+    const ObjectHandle *handle = (const ObjectHandle *)swapchain;
+
+    if (handle == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    SwapchainWrapper *swapchainWrapper = swapchains.get(*handle);
+
+    CGSize drawableSize;
+    drawableSize.width  = swapchainWrapper->extent.width;
+    drawableSize.height = swapchainWrapper->extent.height;
+
+    metalLayer.drawableSize = drawableSize;
+
+    // Blocks until a drawable is free, so outside of the lock
+    id<CAMetalDrawable> drawable = [metalLayer nextDrawable];
+
+    {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        currentDrawable = drawable;
+    }
+
+    // Signal semaphore immediately
+    // (Metal nextDrawable is blocking and so when it returns, image is ready)
+    handle = (const ObjectHandle *)imageAvailableSemaphore;
+
+    if (handle != nullptr) {
+        SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
+
+        if (semaphoreWrapper != nullptr) {
+            semaphoreWrapper->signal();
+        }
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+FvResult
+MetalWrapper::createSwapchain(FvSwapchain *swapchain,
+                              const FvSwapchainCreateInfo *createInfo) {
+    if (createInfo == nullptr || swapchain == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    SwapchainWrapper swapchainWrapper;
+    swapchainWrapper.extent = createInfo->extent;
+
+    // Store swapchain wrapper and return handle
+    const ObjectHandle *handle = addObject(swapchains, swapchainWrapper);
+
+    if (handle != nullptr) {
+        *swapchain = (FvSwapchain)handle;
+    } else {
+        return FV_RESULT_FAILURE;
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::destroySwapchain(FvSwapchain swapchain) {
+    const ObjectHandle *handle = (const ObjectHandle *)swapchain;
+
+    if (handle != nullptr) {
+        // SwapchainWrapper *swapchainWrapper = swapchains.get(*handle);
+
+        swapchains.remove(*handle);
+    }
+}
+
+void MetalWrapper::getSwapchainImage(FvSwapchain swapchain,
+                                     FvImage *swapchainImage) {
+    // Create drawable image
+    ImageWrapper imageWrapper;
+    imageWrapper.isDrawable = true;
+    imageWrapper.texture    = nil;
+
+    // Store texture and return handle
+    const ObjectHandle *handle = addObject(textures, imageWrapper);
+
+    if (handle != nullptr) {
+        *swapchainImage = (FvImage)handle;
+    }
+}
+
+void MetalWrapper::queuePresent(const FvPresentInfo *presentInfo) {
+    // Presents after the submissions made so far, which the submit thread
+    // may not have committed yet
+    if (submitThread != nullptr) {
+        submitThread->flush();
+    }
+
+    if (presentInfo != nullptr) {
+        // Wait for semaphores
+        for (uint32_t i = 0; i < presentInfo->waitSemaphoreCount; ++i) {
+            FvSemaphore semaphore = presentInfo->waitSemaphores[i];
 
             // Get internal semaphore
-            const Handle *handle = (const Handle *)semaphore;
+            const ObjectHandle *handle = (const ObjectHandle *)semaphore;
 
             if (handle != nullptr) {
                 SemaphoreWrapper *semaphoreWrapper = semaphores.get(*handle);
@@ -540,59 +1099,228 @@ FvResult MetalWrapper::queueSubmit(uint32_t submissionsCount,
             }
         }
 
-        // Synchronization code from this excellent answer on SO:
-        // http://stackoverflow.com/a/20910658/
-        // Create a group of tasks (each command buffers work is a task)
-        // A group is created so we can be notified when they are ALL finished.
-        dispatch_group_t group = dispatch_group_create();
+        // TODO: Expand for multiple presentation images
+        // uint32_t imageIndex = presentInfo->imageIndices[0];
 
-        // Submit each command buffer
-        for (uint32_t j = 0; j < submissions[i].commandBufferCount; ++j) {
-            // Enter the group (essentially adding a new task that will wait for
-            // completion)
-            dispatch_group_enter(group);
+        const QueueWrapper *graphicsQueue =
+            queues.get(*queueHandles[FV_QUEUE_TYPE_GRAPHICS]);
 
-            FvCommandBuffer commandBufferHandle =
-                submissions[i].commandBuffers[j];
-            const Handle *handle = (const Handle *)commandBufferHandle;
+        @autoreleasepool {
+            // Make separate command buffer to schedule drawable presentation
+            // and submit it, on the graphics queue so it follows the frame
+            id<MTLCommandBuffer> commandBuffer =
+                [graphicsQueue->commandQueue commandBuffer];
 
-            // Get command buffer from handle
-            CommandBufferWrapper *commandBufferWrapper = nullptr;
+            [commandBuffer presentDrawable:currentDrawable];
 
-            if (handle == nullptr) {
-                return FV_RESULT_FAILURE;
+            [commandBuffer commit];
+
+            std::lock_guard<std::mutex> lock(objectMutex);
+            currentDrawable = nil;
+        }
+
+        // Can now re-use drawable, so free it from swapchain
+        /*
+        for (uint32_t i = 0; i < currentSwapchain.size(); ++i) {
+            if (i == imageIndex) {
+                currentSwapchain[i] = nil;
             }
+        }
+        */
+    }
+}
 
-            commandBufferWrapper = commandBuffers.get(*handle);
+FvResult MetalWrapper::queueSubmit(uint32_t submissionsCount,
+                                   const FvSubmitInfo *submissions,
+                                   FvFence fence) {
+    if (submissions == nullptr && submissionsCount != 0) {
+        return FV_RESULT_FAILURE;
+    }
 
-            if (commandBufferWrapper == nullptr) {
+    // Checked before any serial is reserved, a submission that fails later
+    // still has to complete its serial and fence
+    for (uint32_t i = 0; i < submissionsCount; ++i) {
+        const FvSubmitInfo &submission = submissions[i];
+
+        if (submission.commandBuffers == nullptr &&
+            submission.commandBufferCount != 0) {
+            return FV_RESULT_FAILURE;
+        }
+
+        for (uint32_t j = 0; j < submission.commandBufferCount; ++j) {
+            if (getPrimaryCommandBuffer(submission.commandBuffers[j]) ==
+                nullptr) {
                 return FV_RESULT_FAILURE;
             }
+        }
 
-            // Get graphics pipeline wrapper
-            handle = (const Handle *)commandBufferWrapper->graphicsPipeline;
+        // Timeline semaphores need values
 
-            if (handle == nullptr) {
+        for (uint32_t j = 0; j < submission.waitSemaphoreCount; ++j) {
+            if (submission.waitSemaphoreValues == nullptr &&
+                getTimelineSemaphore(submission.waitSemaphores[j]) != nullptr) {
                 return FV_RESULT_FAILURE;
             }
+        }
 
-            GraphicsPipelineWrapper *pipeline = nullptr;
+        for (uint32_t j = 0; j < submission.signalSemaphoreCount; ++j) {
+            if (submission.signalSemaphoreValues == nullptr &&
+                getTimelineSemaphore(submission.signalSemaphores[j]) !=
+                    nullptr) {
+                return FV_RESULT_FAILURE;
+            }
+        }
+    }
 
-            pipeline = graphicsPipelines.get(*handle);
+    // The completion handler holds on to the fence, so it can be destroyed
+    // while the submissions are pending
+    std::shared_ptr<Fence> fenceObject;
 
-            if (pipeline == nullptr) {
-                return FV_RESULT_FAILURE;
+    if (fence != FV_NULL_HANDLE) {
+        const FenceWrapper *fenceWrapper =
+            fences.get(*((const ObjectHandle *)fence));
+
+        if (fenceWrapper == nullptr) {
+            return FV_RESULT_FAILURE;
+        }
+
+        fenceObject = fenceWrapper->fence;
+    }
+
+    // Report a submission that failed on the submit thread
+    if (submitThread != nullptr && submitFailed.exchange(false)) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // Free objects the GPU has finished with since the last submission
+    {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        destructionQueue.collect(completedSerials.getCompleted());
+    }
+
+    // Objects destroyed from now on may be used by these submissions, even
+    // before the submit thread gets to them
+    const uint64_t firstSerial = submittedSerial + 1;
+    submittedSerial += submissionsCount;
+
+    if (submitThread == nullptr) {
+        return submit(submissionsCount, submissions, std::move(fenceObject),
+                      firstSerial);
+    }
+
+    submitThread->push(submissionsCount, submissions, std::move(fenceObject),
+                       firstSerial);
+
+    return FV_RESULT_SUCCESS;
+}
+
+FvResult MetalWrapper::submit(uint32_t submissionsCount,
+                              const FvSubmitInfo *submissions,
+                              std::shared_ptr<Fence> fenceObject,
+                              uint64_t firstSerial) {
+    FvResult result = FV_RESULT_SUCCESS;
+
+    // Every submission is a task of this group, the fence is signaled once
+    // they have all completed
+    dispatch_group_t fenceGroup = nullptr;
+
+    if (fenceObject != nullptr) {
+        fenceGroup = dispatch_group_create();
+    }
+
+    // Loop thru each submission
+    for (uint32_t i = 0; i < submissionsCount; ++i) {
+        const uint64_t serial = firstSerial + i;
+
+        if (fenceGroup != nullptr) {
+            dispatch_group_enter(fenceGroup);
+        }
+
+        // Semaphores are resolved now, holding references of their own, as
+        // the handles may be gone by the time they are waited on or signaled
+        std::vector<dispatch_semaphore_t> binaryWaits;
+        std::vector<dispatch_semaphore_t> binarySignals;
+        std::vector<TimelineValue> timelineWaits;
+        std::vector<TimelineValue> timelineSignals;
+
+        {
+            std::lock_guard<std::mutex> lock(objectMutex);
+
+            for (uint32_t j = 0; j < submissions[i].waitSemaphoreCount; ++j) {
+                SemaphoreWrapper *semaphoreWrapper =
+                    getSemaphore(submissions[i].waitSemaphores[j]);
+
+                if (semaphoreWrapper == nullptr) {
+                    continue;
+                }
+
+                if (semaphoreWrapper->timeline == nullptr) {
+                    binaryWaits.push_back(semaphoreWrapper->retainSemaphore());
+                } else {
+                    TimelineValue wait;
+                    wait.semaphore = semaphoreWrapper->timeline;
+                    wait.value     = submissions[i].waitSemaphoreValues[j];
+                    timelineWaits.push_back(wait);
+                }
             }
 
-            // Loop through each render pass color attachment, check if it's
-            // texture is a drawable. If it is, back it with the current
-            // drawable.
-            for (uint32_t k = 0; k < pipeline->colorAttachments.size(); ++k) {
-                if (commandBufferWrapper->attachments[k].isDrawable == true) {
-                    pipeline->renderPass.colorAttachments[k].texture =
-                        currentDrawable.texture;
+            for (uint32_t j = 0; j < submissions[i].signalSemaphoreCount;
+                 ++j) {
+                SemaphoreWrapper *semaphoreWrapper =
+                    getSemaphore(submissions[i].signalSemaphores[j]);
+
+                if (semaphoreWrapper == nullptr) {
+                    continue;
+                }
+
+                if (semaphoreWrapper->timeline == nullptr) {
+                    binarySignals.push_back(
+                        semaphoreWrapper->retainSemaphore());
+                } else {
+                    TimelineValue signal;
+                    signal.semaphore = semaphoreWrapper->timeline;
+                    signal.value     = submissions[i].signalSemaphoreValues[j];
+                    timelineSignals.push_back(signal);
                 }
             }
+        }
+
+        // Wait for binary semaphores, without the lock as the application
+        // thread may be the one to signal them. Timeline semaphores hold back
+        // the commit instead of blocking this thread.
+        for (dispatch_semaphore_t semaphore : binaryWaits) {
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+            dispatch_release(semaphore);
+        }
+
+        // Encoded command buffers waiting for the timeline semaphores
+        NSMutableArray *heldCommits = nil;
+
+        if (!timelineWaits.empty()) {
+            heldCommits = [[NSMutableArray alloc] init];
+        }
+
+        // Synchronization code from this excellent answer on SO:
+        // http://stackoverflow.com/a/20910658/
+        // Create a group of tasks (each command buffers work is a task)
+        // A group is created so we can be notified when they are ALL finished.
+        dispatch_group_t group = dispatch_group_create();
+
+        // Encoding reads the object stores and writes the command buffers and
+        // pipelines, which the application thread may be changing
+        std::unique_lock<std::mutex> lock(objectMutex);
+
+        // Submit each command buffer. One that fails is left out, the
+        // submission still completes so nothing waits on it forever.
+        for (uint32_t j = 0; j < submissions[i].commandBufferCount; ++j) {
+            // Checked by 'queueSubmit', but may have been freed since
+            CommandBufferWrapper *commandBufferWrapper =
+                getPrimaryCommandBuffer(submissions[i].commandBuffers[j]);
+
+            if (commandBufferWrapper == nullptr) {
+                result = FV_RESULT_FAILURE;
+                continue;
+            }
 
             @autoreleasepool {
                 // Create command buffer from it's command queue
@@ -601,460 +1329,678 @@ FvResult MetalWrapper::queueSubmit(uint32_t submissionsCount,
                 id<MTLCommandBuffer> commandBuffer =
                     [commandBufferWrapper->commandQueue commandBuffer];
 
-                // Set current command queue
-                currentCommandQueue = commandBufferWrapper->commandQueue;
-
-                // Special case, no vertex buffer, can still encode commands
-                if (commandBufferWrapper->vertexBuffers.size() == 0) {
-                    // Create command encoder from command buffer and render
-                    // pass descriptor
-                    id<MTLRenderCommandEncoder> encoder = [commandBuffer
-                        renderCommandEncoderWithDescriptor:pipeline->
-                                                           renderPass];
-                    // Set states
-                    [encoder setCullMode:pipeline->cullMode];
-                    [encoder setDepthStencilState:pipeline->depthStencilState];
-                    [encoder setFrontFacingWinding:pipeline->windingOrder];
-                    [encoder
-                        setRenderPipelineState:pipeline->renderPipelineState];
-                    [encoder setScissorRect:pipeline->scissor];
-                    [encoder setViewport:pipeline->viewport];
-
-                    // Bind descriptor sets
-                    for (uint32_t iDescSet = 0;
-                         iDescSet < commandBufferWrapper->descriptorSets.size();
-                         ++iDescSet) {
-                        // Get descriptor set
-                        FvDescriptorSet descSet =
-                            commandBufferWrapper->descriptorSets[iDescSet];
-                        const DescriptorSetWrapper *descSetWrapper =
-                            descriptorSets.get(*((const Handle *)descSet));
-
-                        if (descSetWrapper != nullptr) {
-                            // Bind buffers
-                            for (uint32_t iBufferBinding = 0;
-                                 iBufferBinding <
-                                 descSetWrapper->bufferBindings.size();
-                                 ++iBufferBinding) {
-                                DescriptorBufferBinding bufferBinding =
-                                    descSetWrapper
-                                        ->bufferBindings[iBufferBinding];
-
-                                // Get buffer to bind
-                                BufferWrapper *bufferWrapper = buffers.get(
-                                    *((const Handle *)
-                                          bufferBinding.bufferInfo.buffer));
-
-                                if (bufferWrapper != nullptr) {
-                                    int stageFlags =
-                                        bufferBinding.descriptorInfo.stageFlags;
-                                    id<MTLBuffer> mtlBufferToBind =
-                                        bufferWrapper->mtlBuffer;
-                                    FvSize offset =
-                                        bufferBinding.bufferInfo.offset;
-                                    uint32_t bindingPoint =
-                                        bufferBinding.descriptorInfo.binding;
-
-                                    if (stageFlags & FV_SHADER_STAGE_VERTEX) {
-                                        [encoder setVertexBuffer:mtlBufferToBind
-                                                          offset:offset
-                                                         atIndex:bindingPoint];
-                                    }
-                                    if (stageFlags & FV_SHADER_STAGE_FRAGMENT) {
-                                        [encoder
-                                            setFragmentBuffer:mtlBufferToBind
-                                                       offset:offset
-                                                      atIndex:bindingPoint];
-                                    }
-                                }
-                            }
-                            // Bind images
-                            for (uint32_t iImageBinding = 0;
-                                 iImageBinding <
-                                 descSetWrapper->imageBindings.size();
-                                 ++iImageBinding) {
-                                DescriptorImageBinding imageBinding =
-                                    descSetWrapper
-                                        ->imageBindings[iImageBinding];
-
-                                // Get image to bind
-                                ImageWrapper *imageWrapper = textures.get(
-                                    *((const Handle *)
-                                          imageBinding.imageInfo.image));
-
-                                if (imageWrapper != nullptr) {
-                                    int stageFlags =
-                                        imageBinding.descriptorInfo.stageFlags;
-                                    id<MTLTexture> mtlImageToBind =
-                                        imageWrapper->texture;
-                                    uint32_t bindingPoint =
-                                        imageBinding.descriptorInfo.binding;
-                                    id<MTLSamplerState> *mtlSamplerState =
-                                        samplers.get(
-                                            *((const Handle *)imageBinding
-                                                  .imageInfo.sampler));
-
-                                    if (stageFlags & FV_SHADER_STAGE_VERTEX) {
-                                        [encoder setVertexTexture:mtlImageToBind
-                                                          atIndex:bindingPoint];
-                                        [encoder
-                                            setVertexSamplerState:
-                                                *mtlSamplerState
-                                                          atIndex:bindingPoint];
-                                    }
-                                    if (stageFlags & FV_SHADER_STAGE_FRAGMENT) {
-                                        [encoder
-                                            setFragmentTexture:mtlImageToBind
-                                                       atIndex:bindingPoint];
-                                        [encoder
-                                            setFragmentSamplerState:
-                                                *mtlSamplerState
-                                                            atIndex:
-                                                                bindingPoint];
-                                    }
-                                }
-                            }
-                        }
-                    }
+                if (encodeCommands(commandBufferWrapper, commandBuffer) !=
+                    FV_RESULT_SUCCESS) {
+                    result = FV_RESULT_FAILURE;
+                    continue;
+                }
 
-                    // Make draw call
-                    DrawCallNonIndexed dc =
-                        commandBufferWrapper->drawCall.nonIndexed;
-                    [encoder drawPrimitives:pipeline->primitiveType
-                                vertexStart:dc.firstVertex
-                                vertexCount:dc.vertexCount
-                              instanceCount:dc.instanceCount
-                               baseInstance:dc.firstInstance];
-                    // End encoding
-                    [encoder endEncoding];
+                // Enter the group (essentially adding a new task that will
+                // wait for completion)
+                dispatch_group_enter(group);
+
+                [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+                  // Indicate that this task has finished
+                  dispatch_group_leave(group);
+                }];
+
+                // Commit command buffer, unless it waits for a timeline
+                if (heldCommits != nil) {
+                    [heldCommits addObject:commandBuffer];
                 } else {
-                    // otherwise, for each vertex buffer
-                    for (size_t iVertexBuffer = 0;
-                         iVertexBuffer <
-                         commandBufferWrapper->vertexBuffers.size();
-                         ++iVertexBuffer) {
-                        // Get vertex buffer
-                        const Handle *vertexBufferHandle =
-                            (const Handle *)commandBufferWrapper
-                                ->vertexBuffers[iVertexBuffer];
-
-                        const BufferWrapper *vertexBufferWrapper = nullptr;
-                        vertexBufferWrapper = buffers.get(*vertexBufferHandle);
-
-                        if (vertexBufferWrapper != nullptr) {
-                            // Create command encoder from command buffer and
-                            // render pass descriptor
-                            id<MTLRenderCommandEncoder> encoder = [commandBuffer
-                                renderCommandEncoderWithDescriptor:pipeline->
-                                                                   renderPass];
-                            // Set states
-                            [encoder setCullMode:pipeline->cullMode];
-                            [encoder setDepthStencilState:pipeline->
-                                                          depthStencilState];
-                            [encoder
-                                setFrontFacingWinding:pipeline->windingOrder];
-                            [encoder
-                                setRenderPipelineState:pipeline->
-                                                       renderPipelineState];
-                            [encoder setScissorRect:pipeline->scissor];
-                            [encoder setViewport:pipeline->viewport];
-                            [encoder
-                                setVertexBuffer:vertexBufferWrapper->mtlBuffer
-                                         offset:vertexBufferWrapper->offset
-                                        atIndex:vertexBufferWrapper->
-                                                bindingPoint];
-
-                            // Bind descriptor sets (uniform buffers)
-                            for (uint32_t iDescSet = 0;
-                                 iDescSet <
-                                 commandBufferWrapper->descriptorSets.size();
-                                 ++iDescSet) {
-                                // Get descriptor set
-                                FvDescriptorSet descSet =
-                                    commandBufferWrapper
-                                        ->descriptorSets[iDescSet];
-                                const DescriptorSetWrapper *descSetWrapper =
-                                    descriptorSets.get(
-                                        *((const Handle *)descSet));
-
-                                if (descSetWrapper != nullptr) {
-                                    // Bind buffers
-                                    for (uint32_t iBufferBinding = 0;
-                                         iBufferBinding <
-                                         descSetWrapper->bufferBindings.size();
-                                         ++iBufferBinding) {
-                                        DescriptorBufferBinding bufferBinding =
-                                            descSetWrapper->bufferBindings
-                                                [iBufferBinding];
-
-                                        // Get buffer to bind
-                                        BufferWrapper *bufferWrapper =
-                                            buffers.get(
-                                                *((const Handle *)bufferBinding
-                                                      .bufferInfo.buffer));
-
-                                        if (bufferWrapper != nullptr) {
-                                            int stageFlags =
-                                                bufferBinding.descriptorInfo
-                                                    .stageFlags;
-                                            id<MTLBuffer> mtlBufferToBind =
-                                                bufferWrapper->mtlBuffer;
-                                            FvSize offset =
-                                                bufferBinding.bufferInfo.offset;
-                                            uint32_t bindingPoint =
-                                                bufferBinding.descriptorInfo
-                                                    .binding;
-
-                                            if (stageFlags &
-                                                FV_SHADER_STAGE_VERTEX) {
-                                                [encoder
-                                                    setVertexBuffer:
-                                                        mtlBufferToBind
-                                                             offset:offset
-                                                            atIndex:
-                                                                bindingPoint];
-                                            }
-                                            if (stageFlags &
-                                                FV_SHADER_STAGE_FRAGMENT) {
-                                                [encoder
-                                                    setFragmentBuffer:
-                                                        mtlBufferToBind
-                                                               offset:offset
-                                                              atIndex:
-                                                                  bindingPoint];
-                                            }
-                                        }
-                                    }
-                                    // Bind images
-                                    for (uint32_t iImageBinding = 0;
-                                         iImageBinding <
-                                         descSetWrapper->imageBindings.size();
-                                         ++iImageBinding) {
-                                        DescriptorImageBinding imageBinding =
-                                            descSetWrapper
-                                                ->imageBindings[iImageBinding];
-
-                                        // Get image to bind
-                                        ImageWrapper *imageWrapper =
-                                            textures.get(
-                                                *((const Handle *)imageBinding
-                                                      .imageInfo.image));
-
-                                        if (imageWrapper != nullptr) {
-                                            int stageFlags =
-                                                imageBinding.descriptorInfo
-                                                    .stageFlags;
-                                            id<MTLTexture> mtlImageToBind =
-                                                imageWrapper->texture;
-                                            uint32_t bindingPoint =
-                                                imageBinding.descriptorInfo
-                                                    .binding;
-                                            id<MTLSamplerState>
-                                                *mtlSamplerState = samplers.get(
-                                                    *((const Handle *)
-                                                          imageBinding.imageInfo
-                                                              .sampler));
-
-                                            if (stageFlags &
-                                                FV_SHADER_STAGE_VERTEX) {
-                                                [encoder
-                                                    setVertexTexture:
-                                                        mtlImageToBind
-                                                             atIndex:
-                                                                 bindingPoint];
-                                                [encoder
-                                                    setVertexSamplerState:
-                                                        *mtlSamplerState
-                                                                  atIndex:
-                                                                      bindingPoint];
-                                            }
-                                            if (stageFlags &
-                                                FV_SHADER_STAGE_FRAGMENT) {
-                                                [encoder
-                                                    setFragmentTexture:
-                                                        mtlImageToBind
-                                                               atIndex:
-                                                                   bindingPoint];
-                                                [encoder
-                                                    setFragmentSamplerState:
-                                                        *mtlSamplerState
-                                                                    atIndex:
-                                                                        bindingPoint];
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+                    [commandBuffer commit];
+                }
+            }
+        }
+
+        lock.unlock();
+
+        if (heldCommits != nil) {
+            // Commit in order once every wait has been reached, on the thread
+            // of the signal reaching the last one
+            std::shared_ptr<std::atomic<size_t>> remainingWaits =
+                std::make_shared<std::atomic<size_t>>(timelineWaits.size());
+
+            for (const TimelineValue &wait : timelineWaits) {
+                wait.semaphore->whenReached(
+                    wait.value, [remainingWaits, heldCommits]() {
+                        if (--*remainingWaits > 0) {
+                            return;
+                        }
+
+                        for (id<MTLCommandBuffer> buffer in heldCommits) {
+                            [buffer commit];
+                        }
+                        [heldCommits release];
+                    });
+            }
+        }
+
+        // Notify us when all tasks are done. The block runs on another thread
+        // and copies the resolved semaphores, it doesn't touch the stores.
+        dispatch_group_notify(
+            group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0),
+            ^{
+              // Signal semaphores on completion
+              for (dispatch_semaphore_t semaphore : binarySignals) {
+                  dispatch_semaphore_signal(semaphore);
+                  dispatch_release(semaphore);
+              }
+
+              for (const TimelineValue &signal : timelineSignals) {
+                  signal.semaphore->signal(signal.value);
+              }
+
+              // Objects destroyed up to this submission can be freed once
+              // every earlier submission has completed too
+              completedSerials.complete(serial);
+
+              if (fenceGroup != nullptr) {
+                  dispatch_group_leave(fenceGroup);
+              }
+            });
+
+        // Make sure to release group. We can release here because: "The system
+        // holds a reference to the dispatch group while an asynchronous
+        // notification is pending, therefore it is valid to release the group
+        // after setting a notification block" from:
+        // https://developer.apple.com/library/mac/documentation/Darwin/Reference/ManPages/man3/dispatch_group_notify.3.html
+        dispatch_release(group);
+    }
+
+    if (fenceGroup != nullptr) {
+        // Signals at once if there were no submissions
+        dispatch_group_notify(
+            fenceGroup,
+            dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
+              fenceObject->signal();
+            });
+
+        dispatch_release(fenceGroup);
+    }
+
+    return result;
+}
+
+FvResult
+MetalWrapper::encodeCommands(CommandBufferWrapper *commandBufferWrapper,
+                             id<MTLCommandBuffer> commandBuffer) {
+    const CommandStream &commands = commandBufferWrapper->commands;
+
+    // The encoder needs the render pass up front, which is set up by the
+    // first graphics pipeline bound
+    GraphicsPipelineWrapper *pipelineWrapper =
+        getFirstGraphicsPipeline(commands);
+
+    if (pipelineWrapper == nullptr) {
+        // Nothing is drawn, the copies are all there is
+        return encodeCopies(commandBuffer, commands, 0, commands.size())
+                   ? FV_RESULT_SUCCESS
+                   : FV_RESULT_FAILURE;
+    }
+
+    if (commandBufferWrapper->queueType == FV_QUEUE_TYPE_TRANSFER ||
+        pipelineWrapper->renderPass == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    MTLRenderPassDescriptor *renderPass =
+        newRenderPassDescriptor(pipelineWrapper, commandBufferWrapper);
+
+    if (renderPass == nil) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // Uploads recorded before the render pass land before the draws that may
+    // read them
+    encodeCopies(commandBuffer, commands, 0,
+                 commandBufferWrapper->renderPassBegin);
+
+    // Create command encoder from command buffer and render pass descriptor
+    id<MTLRenderCommandEncoder> encoder =
+        [commandBuffer renderCommandEncoderWithDescriptor:renderPass];
+
+    FV_MTL_RELEASE(renderPass);
+
+    // Replay commands in the order they were recorded
+    EncoderState state;
+    encodeStream(encoder, commandBufferWrapper->commands, &state);
+
+    // End encoding
+    [encoder endEncoding];
+
+    // Copies recorded after the render pass, e.g. readbacks, follow it
+    encodeCopies(commandBuffer, commands, commandBufferWrapper->renderPassBegin,
+                 commands.size());
+
+    commandBufferWrapper->numElidedStateChanges += state.numElidedStateChanges;
+
+    return FV_RESULT_SUCCESS;
+}
+
+MTLRenderPassDescriptor *MetalWrapper::newRenderPassDescriptor(
+    const GraphicsPipelineWrapper *pipelineWrapper,
+    const CommandBufferWrapper *commandBufferWrapper) {
+    const std::vector<ImageWrapper> &attachments =
+        commandBufferWrapper->attachments;
+    const std::vector<FvClearValue> &clearValues =
+        commandBufferWrapper->clearValues;
+
+    // Every attachment the pipeline uses needs a framebuffer attachment and a
+    // clear value, both given when the render pass was begun
+    const size_t numAttachments =
+        std::min(attachments.size(), clearValues.size());
+
+    for (uint32_t i = 0; i < pipelineWrapper->colorAttachments.size(); ++i) {
+        if (pipelineWrapper->colorAttachments[i].attachment >= numAttachments) {
+            return nil;
+        }
+    }
+    if ((pipelineWrapper->depthAttachment.size() == 1 &&
+         pipelineWrapper->depthAttachment[0].attachment >= numAttachments) ||
+        (pipelineWrapper->stencilAttachment.size() == 1 &&
+         pipelineWrapper->stencilAttachment[0].attachment >= numAttachments)) {
+        return nil;
+    }
+
+    MTLRenderPassDescriptor *renderPass = [pipelineWrapper->renderPass copy];
+
+    // Fill out render pass color and depthStencil attachment information
+    for (uint32_t i = 0; i < pipelineWrapper->colorAttachments.size(); ++i) {
+        const uint32_t attachmentIndex =
+            pipelineWrapper->colorAttachments[i].attachment;
+        const FvClearColor &clearColor = clearValues[attachmentIndex].color;
+
+        // A drawable attachment is backed by the current drawable
+        renderPass.colorAttachments[i].texture =
+            attachments[attachmentIndex].isDrawable
+                ? currentDrawable.texture
+                : attachments[attachmentIndex].texture;
+
+        renderPass.colorAttachments[i].clearColor = MTLClearColorMake(
+            clearColor.float32[0], clearColor.float32[1],
+            clearColor.float32[2], clearColor.float32[3]);
+    }
+
+    // Should only be one depth stencil attachment per framebuffer
+    if (pipelineWrapper->depthAttachment.size() == 1) {
+        const uint32_t attachmentIndex =
+            pipelineWrapper->depthAttachment[0].attachment;
+
+        renderPass.depthAttachment.texture =
+            attachments[attachmentIndex].texture;
+        renderPass.depthAttachment.clearDepth =
+            clearValues[attachmentIndex].depthStencil.depth;
+    }
+    if (pipelineWrapper->stencilAttachment.size() == 1) {
+        const uint32_t attachmentIndex =
+            pipelineWrapper->stencilAttachment[0].attachment;
+
+        renderPass.stencilAttachment.texture =
+            attachments[attachmentIndex].texture;
+        renderPass.stencilAttachment.clearStencil =
+            clearValues[attachmentIndex].depthStencil.stencil;
+    }
+
+    return renderPass;
+}
+
+bool MetalWrapper::encodeCopies(id<MTLCommandBuffer> commandBuffer,
+                                const CommandStream &commands, size_t first,
+                                size_t last) {
+    // Only made once there is something to copy
+    id<MTLBlitCommandEncoder> encoder = nil;
+    size_t index                      = 0;
+
+    for (CommandStream::const_iterator it = commands.begin();
+         it != commands.end() && index < last; ++it, ++index) {
+        if (index < first || (it->type != COMMAND_TYPE_COPY_BUFFER &&
+                              it->type != COMMAND_TYPE_COPY_BUFFER_TO_IMAGE)) {
+            continue;
+        }
+
+        if (encoder == nil) {
+            encoder = [commandBuffer blitCommandEncoder];
+        }
+
+        if (it->type == COMMAND_TYPE_COPY_BUFFER) {
+            const CopyBufferCommand &command = it->as<CopyBufferCommand>();
+
+            // The buffers may have been destroyed since recording
+            const BufferWrapper *src = buffers.get(command.srcBuffer);
+            const BufferWrapper *dst = buffers.get(command.dstBuffer);
+
+            if (src != nullptr && dst != nullptr) {
+                [encoder copyFromBuffer:src->mtlBuffer
+                           sourceOffset:command.region.srcOffset
+                               toBuffer:dst->mtlBuffer
+                      destinationOffset:command.region.dstOffset
+                                   size:command.region.size];
+            }
+        } else {
+            const CopyBufferToImageCommand &command =
+                it->as<CopyBufferToImageCommand>();
+            const FvBufferImageCopy &region = command.region;
+
+            const BufferWrapper *src = buffers.get(command.srcBuffer);
+            const ImageWrapper *dst  = textures.get(command.dstImage);
+
+            if (src != nullptr && dst != nullptr) {
+                [encoder copyFromBuffer:src->mtlBuffer
+                           sourceOffset:region.bufferOffset
+                      sourceBytesPerRow:region.bytesPerRow
+                    sourceBytesPerImage:region.bytesPerImage
+                             sourceSize:MTLSizeMake(
+                                            region.imageRegion.extent.width,
+                                            region.imageRegion.extent.height,
+                                            region.imageRegion.extent.depth)
+                              toTexture:dst->texture
+                       destinationSlice:region.layer
+                       destinationLevel:region.mipLevel
+                      destinationOrigin:MTLOriginMake(
+                                            region.imageRegion.origin.x,
+                                            region.imageRegion.origin.y,
+                                            region.imageRegion.origin.z)];
+            }
+        }
+    }
+
+    if (encoder == nil) {
+        return false;
+    }
+
+    [encoder endEncoding];
+
+    return true;
+}
+
+void MetalWrapper::encodeStream(id<MTLRenderCommandEncoder> encoder,
+                                const CommandStream &commands,
+                                EncoderState *state) {
+    for (CommandStream::const_iterator it = commands.begin();
+         it != commands.end(); ++it) {
+        switch (it->type) {
+        case COMMAND_TYPE_BIND_GRAPHICS_PIPELINE: {
+            GraphicsPipelineWrapper *pipeline = graphicsPipelines.get(
+                it->as<BindGraphicsPipelineCommand>().graphicsPipeline);
+            state->pipeline = pipeline;
+
+            if (pipeline != nullptr) {
+                encodePipelineState(encoder, pipeline, state);
+            }
+            break;
+        }
+        case COMMAND_TYPE_BIND_VERTEX_BUFFER: {
+            const BindVertexBufferCommand &command =
+                it->as<BindVertexBufferCommand>();
+            const BufferWrapper *bufferWrapper = buffers.get(command.buffer);
+
+            if (bufferWrapper != nullptr) {
+                [encoder setVertexBuffer:bufferWrapper->mtlBuffer
+                                  offset:command.offset
+                                 atIndex:command.binding];
+            }
+            break;
+        }
+        case COMMAND_TYPE_BIND_INDEX_BUFFER: {
+            const BindIndexBufferCommand &command =
+                it->as<BindIndexBufferCommand>();
+
+            state->indexBuffer       = buffers.get(command.buffer);
+            state->indexType         = toMtlIndexType(command.indexType);
+            state->indexBufferOffset = command.offset;
+            break;
+        }
+        case COMMAND_TYPE_BIND_DESCRIPTOR_SET: {
+            const BindDescriptorSetCommand &command =
+                it->as<BindDescriptorSetCommand>();
+
+            // Resolved when recorded, the binding table lives as long as the
+            // descriptor set, which may have been destroyed since
+            if (descriptorSets.isValid(command.descriptorSet)) {
+                encodeDescriptorSet(
+                    encoder, (const MetalBindingTable *)command.resolvedSet,
+                    (const uint32_t *)getPayload(command));
+            }
+            break;
+        }
+        case COMMAND_TYPE_PUSH_CONSTANTS: {
+            const PushConstantsCommand &pc = it->as<PushConstantsCommand>();
+
+            memcpy(state->pushConstants + pc.offset, getPayload(pc), pc.size);
+            state->pushConstantsSize =
+                std::max(state->pushConstantsSize, pc.offset + pc.size);
+
+            // Inline bytes are copied by the encoder, later updates don't
+            // affect draws encoded before them
+            if ((pc.stageFlags & FV_SHADER_STAGE_VERTEX) != 0) {
+                [encoder setVertexBytes:state->pushConstants
+                                 length:state->pushConstantsSize
+                                atIndex:FV_METAL_PUSH_CONSTANTS_BUFFER_INDEX];
+            }
+            if ((pc.stageFlags & FV_SHADER_STAGE_FRAGMENT) != 0) {
+                [encoder
+                    setFragmentBytes:state->pushConstants
+                              length:state->pushConstantsSize
+                             atIndex:FV_METAL_PUSH_CONSTANTS_BUFFER_INDEX];
+            }
+            break;
+        }
+        case COMMAND_TYPE_DRAW: {
+            const DrawCommand &dc = it->as<DrawCommand>();
+
+            if (state->pipeline != nullptr) {
+                // Make non-indexed draw call
+                [encoder drawPrimitives:state->pipeline->primitiveType
+                            vertexStart:dc.firstVertex
+                            vertexCount:dc.vertexCount
+                          instanceCount:dc.instanceCount
+                           baseInstance:dc.firstInstance];
+            }
+            break;
+        }
+        case COMMAND_TYPE_DRAW_INDEXED: {
+            const DrawIndexedCommand &dc = it->as<DrawIndexedCommand>();
+
+            if (state->pipeline != nullptr && state->indexBuffer != nullptr) {
+                // Metal has no first index, start that far into the buffer
+                const FvSize indexSize =
+                    state->indexType == MTLIndexTypeUInt16 ? 2 : 4;
+
+                // Make indexed draw call
+                [encoder
+                    drawIndexedPrimitives:state->pipeline->primitiveType
+                               indexCount:dc.indexCount
+                                indexType:state->indexType
+                              indexBuffer:state->indexBuffer->mtlBuffer
+                        indexBufferOffset:state->indexBufferOffset +
+                                          dc.firstIndex * indexSize
+                            instanceCount:dc.instanceCount
+                               baseVertex:dc.vertexOffset
+                             baseInstance:dc.firstInstance];
+            }
+            break;
+        }
+        case COMMAND_TYPE_DRAW_INDIRECT: {
+            const DrawIndirectCommand &dc      = it->as<DrawIndirectCommand>();
+            const BufferWrapper *bufferWrapper = buffers.get(dc.buffer);
+
+            if (state->pipeline == nullptr || bufferWrapper == nullptr) {
+                break;
+            }
+
+            id<MTLBuffer> mtlBuffer = bufferWrapper->mtlBuffer;
+            const IndirectDrawRecords<FvDrawIndirectCommand> records(
+                nativeIndirectDraws ? nullptr : [mtlBuffer contents],
+                [mtlBuffer length], dc.offset, dc.drawCount, dc.stride);
+
+            for (uint32_t i = 0; i < records.size(); ++i) {
+                if (nativeIndirectDraws) {
+                    [encoder drawPrimitives:state->pipeline->primitiveType
+                             indirectBuffer:mtlBuffer
+                       indirectBufferOffset:records.getOffset(i)];
+                    continue;
+                }
+
+                // Expand the record into a direct draw
+                const FvDrawIndirectCommand record = records[i];
+                [encoder drawPrimitives:state->pipeline->primitiveType
+                            vertexStart:record.firstVertex
+                            vertexCount:record.vertexCount
+                          instanceCount:record.instanceCount
+                           baseInstance:record.firstInstance];
+            }
+            break;
+        }
+        case COMMAND_TYPE_DRAW_INDEXED_INDIRECT: {
+            const DrawIndexedIndirectCommand &dc =
+                it->as<DrawIndexedIndirectCommand>();
+            const BufferWrapper *bufferWrapper = buffers.get(dc.buffer);
+
+            if (state->pipeline == nullptr || state->indexBuffer == nullptr ||
+                bufferWrapper == nullptr) {
+                break;
+            }
+
+            id<MTLBuffer> mtlBuffer = bufferWrapper->mtlBuffer;
+            const IndirectDrawRecords<FvDrawIndexedIndirectCommand> records(
+                nativeIndirectDraws ? nullptr : [mtlBuffer contents],
+                [mtlBuffer length], dc.offset, dc.drawCount, dc.stride);
+
+            const FvSize indexSize =
+                state->indexType == MTLIndexTypeUInt16 ? 2 : 4;
 
-                            if (commandBufferWrapper->drawCall.type ==
-                                DRAW_CALL_TYPE_INDEXED) {
-                                // Get index buffer from command buffer wrapper
-                                const BufferWrapper *indexBuf = buffers.get(
-                                    *((const Handle *)
-                                          commandBufferWrapper->indexBuffer));
-
-                                if (indexBuf != nullptr) {
-                                    // Make indexed draw call
-                                    DrawCallIndexed dc =
-                                        commandBufferWrapper->drawCall.indexed;
-                                    [encoder
-                                        drawIndexedPrimitives:
-                                            pipeline->primitiveType
-                                                   indexCount:dc.indexCount
-                                                    indexType:indexBuf
-                                                                  ->mtlIndexType
-                                                  indexBuffer:indexBuf
-                                                                  ->mtlBuffer
-                                            indexBufferOffset:indexBuf->offset
-                                                instanceCount:dc.instanceCount
-                                                   baseVertex:dc.vertexOffset
-                                                 baseInstance:dc.firstInstance];
-                                }
-                            } else {
-                                // Make non-indexed draw call
-                                DrawCallNonIndexed dc =
-                                    commandBufferWrapper->drawCall.nonIndexed;
-                                [encoder drawPrimitives:pipeline->primitiveType
-                                            vertexStart:dc.firstVertex
-                                            vertexCount:dc.vertexCount
-                                          instanceCount:dc.instanceCount
-                                           baseInstance:dc.firstInstance];
-                            }
-                            // End encoding
-                            [encoder endEncoding];
-                        }
-                    }
+            for (uint32_t i = 0; i < records.size(); ++i) {
+                if (nativeIndirectDraws) {
+                    [encoder
+                        drawIndexedPrimitives:state->pipeline->primitiveType
+                                    indexType:state->indexType
+                                  indexBuffer:state->indexBuffer->mtlBuffer
+                            indexBufferOffset:state->indexBufferOffset
+                               indirectBuffer:mtlBuffer
+                         indirectBufferOffset:records.getOffset(i)];
+                    continue;
                 }
 
-                [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
-                  // Indicate that this task has finished
-                  dispatch_group_leave(group);
-                }];
-
-                // Commit command buffer
-                [commandBuffer commit];
+                // Expand the record into a direct draw
+                const FvDrawIndexedIndirectCommand record = records[i];
+                [encoder
+                    drawIndexedPrimitives:state->pipeline->primitiveType
+                               indexCount:record.indexCount
+                                indexType:state->indexType
+                              indexBuffer:state->indexBuffer->mtlBuffer
+                        indexBufferOffset:state->indexBufferOffset +
+                                          record.firstIndex * indexSize
+                            instanceCount:record.instanceCount
+                               baseVertex:record.vertexOffset
+                             baseInstance:record.firstInstance];
             }
+            break;
         }
+        case COMMAND_TYPE_EXECUTE_COMMANDS: {
+            const CommandBufferWrapper *secondary =
+                getSecondaryCommandBuffer(it->as<ExecuteCommandsCommand>());
 
-        // A copy of the submission object is made here so that we use it,
-        // rather than the submissions pointer to access the submission object
-        // in the block below. If we use the pointer, it may no longer point to
-        // a valid object (the submission info) when the block begins.
-        //
-        // We can access and mutate the 'semaphores' member variable within
-        // block because blocks make a strong, mutable referenc to member
-        // variables used inside blocks. Blocks and Objects reference:
-        // https://developer.apple.com/library/content/documentation/Cocoa/Conceptual/Blocks/Articles/bxVariables.html#//apple_ref/doc/uid/TP40007502-CH6-SW4
+            // Bindings made by the secondary stay bound in the encoder
+            if (secondary != nullptr) {
+                encodeStream(encoder, secondary->commands, state);
+            }
+            break;
+        }
+        case COMMAND_TYPE_COPY_BUFFER:
+        case COMMAND_TYPE_COPY_BUFFER_TO_IMAGE:
+            // Encoded around the render pass by 'encodeCopies'
+            break;
+        }
+    }
+}
 
-        FvSubmitInfo submission = submissions[i];
+void MetalWrapper::encodePipelineState(id<MTLRenderCommandEncoder> encoder,
+                                       const GraphicsPipelineWrapper *pipeline,
+                                       EncoderState *state) {
+    // A new encoder has none of our states set
+    const GraphicsPipelineWrapper *applied = state->appliedPipeline;
+    const bool all                         = applied == nullptr;
+    uint32_t numSet                        = 0;
 
-        // Notify us when all tasks are done
-        dispatch_group_notify(
-            group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0),
-            ^{
-              // Signal semaphores on completion
-              for (uint32_t i = 0; i < submission.signalSemaphoreCount; ++i) {
-                  FvSemaphore semaphore = submission.signalSemaphores[i];
+    if (all || applied->cullMode != pipeline->cullMode) {
+        [encoder setCullMode:pipeline->cullMode];
+        ++numSet;
+    }
+    if (all || applied->depthStencilState != pipeline->depthStencilState) {
+        [encoder setDepthStencilState:pipeline->depthStencilState];
+        ++numSet;
+    }
+    if (all || applied->windingOrder != pipeline->windingOrder) {
+        [encoder setFrontFacingWinding:pipeline->windingOrder];
+        ++numSet;
+    }
+    if (all || applied->renderPipelineState != pipeline->renderPipelineState) {
+        [encoder setRenderPipelineState:pipeline->renderPipelineState];
+        ++numSet;
+    }
+    // Both are plain structs without padding
+    if (all || memcmp(&applied->scissor, &pipeline->scissor,
+                      sizeof(MTLScissorRect)) != 0) {
+        [encoder setScissorRect:pipeline->scissor];
+        ++numSet;
+    }
+    if (all || memcmp(&applied->viewport, &pipeline->viewport,
+                      sizeof(MTLViewport)) != 0) {
+        [encoder setViewport:pipeline->viewport];
+        ++numSet;
+    }
 
-                  // Get internal semaphore
-                  const Handle *handle = (const Handle *)semaphore;
+    // Cull mode, depth-stencil, winding, pipeline, scissor and viewport
+    const uint32_t numStates = 6;
 
-                  if (handle != nullptr) {
-                      SemaphoreWrapper *semaphoreWrapper =
-                          semaphores.get(*handle);
+    state->numElidedStateChanges += numStates - numSet;
 
-                      if (semaphoreWrapper != nullptr) {
-                          semaphoreWrapper->signal();
-                      }
-                  }
-              }
-            });
+    state->appliedPipeline = pipeline;
+}
 
-        // Make sure to release group. We can release here because: "The system
-        // holds a reference to the dispatch group while an asynchronous
-        // notification is pending, therefore it is valid to release the group
-        // after setting a notification block" from:
-        // https://developer.apple.com/library/mac/documentation/Darwin/Reference/ManPages/man3/dispatch_group_notify.3.html
-        dispatch_release(group);
+ObjectHandle MetalWrapper::getRecordedHandle(const void *object) {
+    if (object != nullptr) {
+        return *(const ObjectHandle *)object;
     }
 
-    return FV_RESULT_SUCCESS;
+    // No store comes anywhere near holding the largest index
+    ObjectHandle handle;
+    handle.id = ~(ObjectHandle::IdType)0;
+
+    return handle;
 }
 
-void MetalWrapper::cmdBindGraphicsPipeline(
-    FvCommandBuffer commandBuffer, FvGraphicsPipeline graphicsPipeline) {
-    // Get graphics pipeline wrapper
-    GraphicsPipelineWrapper *pipelineWrapper = nullptr;
+GraphicsPipelineWrapper *
+MetalWrapper::getFirstGraphicsPipeline(const CommandStream &commands) {
+    for (CommandStream::const_iterator it = commands.begin();
+         it != commands.end(); ++it) {
+        if (it->type == COMMAND_TYPE_BIND_GRAPHICS_PIPELINE) {
+            return graphicsPipelines.get(
+                it->as<BindGraphicsPipelineCommand>().graphicsPipeline);
+        }
 
-    const Handle *handle = (const Handle *)graphicsPipeline;
+        if (it->type == COMMAND_TYPE_EXECUTE_COMMANDS) {
+            const CommandBufferWrapper *secondary =
+                getSecondaryCommandBuffer(it->as<ExecuteCommandsCommand>());
 
-    if (handle != nullptr) {
-        pipelineWrapper = graphicsPipelines.get(*handle);
+            if (secondary != nullptr) {
+                GraphicsPipelineWrapper *pipelineWrapper =
+                    getFirstGraphicsPipeline(secondary->commands);
+
+                if (pipelineWrapper != nullptr) {
+                    return pipelineWrapper;
+                }
+            }
+        }
     }
 
-    // Get command buffer
-    CommandBufferWrapper *commandBufferWrapper = nullptr;
+    return nullptr;
+}
 
-    handle = (const Handle *)commandBuffer;
+CommandBufferWrapper *
+MetalWrapper::getPrimaryCommandBuffer(FvCommandBuffer commandBuffer) {
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
-    if (handle != nullptr) {
-        commandBufferWrapper = commandBuffers.get(*handle);
+    if (handle == nullptr) {
+        return nullptr;
     }
 
-    if (pipelineWrapper == nullptr || commandBufferWrapper == nullptr) {
-        return;
+    CommandBufferWrapper *commandBufferWrapper = commandBuffers.get(*handle);
+
+    // Secondaries are only executed from primary command buffers
+    if (commandBufferWrapper == nullptr || commandBufferWrapper->secondary) {
+        return nullptr;
+    }
+
+    return commandBufferWrapper;
+}
+
+const CommandBufferWrapper *MetalWrapper::getSecondaryCommandBuffer(
+    const ExecuteCommandsCommand &command) {
+    const CommandBufferWrapper *commandBufferWrapper =
+        commandBuffers.get(command.commandBuffer);
+
+    // Secondaries never execute other command buffers, so replay can't loop
+    if (commandBufferWrapper == nullptr || !commandBufferWrapper->secondary) {
+        return nullptr;
     }
 
-    if (pipelineWrapper->renderPass == nullptr) {
+    return commandBufferWrapper;
+}
+
+void MetalWrapper::encodeDescriptorSet(id<MTLRenderCommandEncoder> encoder,
+                                       const MetalBindingTable *bindings,
+                                       const uint32_t *dynamicOffsets) {
+    if (bindings == nullptr) {
         return;
     }
 
-    // Fill out render pass color and depthStencil attachment information
-    for (uint32_t i = 0; i < pipelineWrapper->colorAttachments.size(); ++i) {
-        uint32_t attachmentIndex =
-            pipelineWrapper->colorAttachments[i].attachment;
+    // Bind buffers
+    for (const MetalBindingTable::BufferSlot &slot : bindings->getBuffers()) {
+        if (slot.buffer == nil) {
+            continue;
+        }
 
-        // Get clear color
-        float clearColor[4] = {0, 0, 0, 0};
-        for (uint32_t j = 0; j < 4; ++j) {
-            clearColor[j] = commandBufferWrapper->clearValues[attachmentIndex]
-                                .color.float32[j];
+        const FvSize offset =
+            slot.dynamic ? slot.offset + dynamicOffsets[slot.dynamicIndex]
+                         : slot.offset;
+
+        if (slot.stageFlags & FV_SHADER_STAGE_VERTEX) {
+            [encoder setVertexBuffer:slot.buffer
+                              offset:offset
+                             atIndex:slot.binding];
+        }
+        if (slot.stageFlags & FV_SHADER_STAGE_FRAGMENT) {
+            [encoder setFragmentBuffer:slot.buffer
+                                offset:offset
+                               atIndex:slot.binding];
         }
+    }
 
-        pipelineWrapper->renderPass.colorAttachments[i].texture =
-            commandBufferWrapper->attachments[attachmentIndex].texture;
+    // Bind images
+    for (const MetalBindingTable::ImageSlot &slot : bindings->getImages()) {
+        if (slot.texture == nil) {
+            continue;
+        }
 
-        pipelineWrapper->renderPass.colorAttachments[i].clearColor =
-            MTLClearColorMake(clearColor[0], clearColor[1], clearColor[2],
-                              clearColor[3]);
+        if (slot.stageFlags & FV_SHADER_STAGE_VERTEX) {
+            [encoder setVertexTexture:slot.texture atIndex:slot.binding];
+            [encoder setVertexSamplerState:slot.sampler atIndex:slot.binding];
+        }
+        if (slot.stageFlags & FV_SHADER_STAGE_FRAGMENT) {
+            [encoder setFragmentTexture:slot.texture atIndex:slot.binding];
+            [encoder setFragmentSamplerState:slot.sampler
+                                     atIndex:slot.binding];
+        }
     }
+}
 
-    // Should only be one depth stencil attachment per framebuffer
-    if (pipelineWrapper->depthAttachment.size() == 1) {
-        uint32_t attachmentIndex =
-            pipelineWrapper->depthAttachment[0].attachment;
+void MetalWrapper::cmdBindGraphicsPipeline(
+    FvCommandBuffer commandBuffer, FvGraphicsPipeline graphicsPipeline) {
+    // Get command buffer
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
 
-        pipelineWrapper->renderPass.depthAttachment.texture =
-            commandBufferWrapper->attachments[attachmentIndex].texture;
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
-        pipelineWrapper->renderPass.depthAttachment.clearDepth =
-            commandBufferWrapper->clearValues[attachmentIndex]
-                .depthStencil.depth;
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
     }
-    if (pipelineWrapper->stencilAttachment.size() == 1) {
-        uint32_t attachmentIndex =
-            pipelineWrapper->stencilAttachment[0].attachment;
 
-        pipelineWrapper->renderPass.stencilAttachment.texture =
-            commandBufferWrapper->attachments[attachmentIndex].texture;
+    if (graphicsPipeline == nullptr || commandBufferWrapper == nullptr) {
+        return;
+    }
 
-        pipelineWrapper->renderPass.stencilAttachment.clearStencil =
-            commandBufferWrapper->clearValues[attachmentIndex]
-                .depthStencil.stencil;
+    if (!commandBufferWrapper->bindings.bindGraphicsPipeline(
+            graphicsPipeline)) {
+        return;
     }
 
-    // Associate graphics pipeline with command buffer
-    commandBufferWrapper->graphicsPipeline = graphicsPipeline;
+    // Record pipeline bind. The pipeline's render pass is filled out at
+    // submit, as other threads may be recording binds of the same pipeline.
+    BindGraphicsPipelineCommand *command =
+        commandBufferWrapper->commands.record<BindGraphicsPipelineCommand>();
+    command->graphicsPipeline = getRecordedHandle(graphicsPipeline);
 }
 
 void MetalWrapper::cmdBindVertexBuffers(FvCommandBuffer commandBuffer,
@@ -1065,7 +2011,8 @@ void MetalWrapper::cmdBindVertexBuffers(FvCommandBuffer commandBuffer,
     // Get command buffer
     CommandBufferWrapper *commandBufferWrapper = nullptr;
 
-    const Handle *commandBufferHandle = (const Handle *)commandBuffer;
+    const ObjectHandle *commandBufferHandle =
+        (const ObjectHandle *)commandBuffer;
 
     if (commandBufferHandle != nullptr) {
         commandBufferWrapper = commandBuffers.get(*commandBufferHandle);
@@ -1076,29 +2023,18 @@ void MetalWrapper::cmdBindVertexBuffers(FvCommandBuffer commandBuffer,
         return;
     }
 
-    // Loop thru each buffer to bind
+    // Record one bind per buffer that isn't bound already
     for (uint32_t i = 0; i < bindingCount; ++i) {
-        // Get binding point and offset of buffer
-        FvSize bindingPoint = firstBinding + i;
-        FvSize offset       = offsets[i];
-
-        // Get buffer wrapper
-        BufferWrapper *bufferWrapper = nullptr;
-        const Handle *bufferHandle   = (const Handle *)buffers[i];
-        if (bufferHandle != nullptr) {
-            bufferWrapper = this->buffers.get(*bufferHandle);
+        if (!commandBufferWrapper->bindings.bindVertexBuffer(
+                firstBinding + i, buffers[i], offsets[i])) {
+            continue;
         }
 
-        assert(bufferWrapper != nullptr);
-        if (bufferWrapper != nullptr) {
-            // Fill out binding point and offset information
-            bufferWrapper->bindingPoint = bindingPoint;
-            bufferWrapper->offset       = offset;
-
-            // Attach vertex buffer to command buffer
-            commandBufferWrapper->vertexBuffers.push_back(
-                (FvBuffer)bufferHandle);
-        }
+        BindVertexBufferCommand *command =
+            commandBufferWrapper->commands.record<BindVertexBufferCommand>();
+        command->binding = firstBinding + i;
+        command->buffer  = getRecordedHandle(buffers[i]);
+        command->offset  = offsets[i];
     }
 }
 
@@ -1107,38 +2043,102 @@ void MetalWrapper::cmdBindIndexBuffer(FvCommandBuffer commandBuffer,
                                       FvIndexType indexType) {
     // Get command buffer
     CommandBufferWrapper *commandBufferWrapper =
-        commandBuffers.get(*((const Handle *)commandBuffer));
+        commandBuffers.get(*((const ObjectHandle *)commandBuffer));
 
-    // Get index buffer wrapper
-    BufferWrapper *indexBufferWrapper = buffers.get(*((const Handle *)buffer));
-
-    if (commandBufferWrapper == nullptr || indexBufferWrapper == nullptr) {
+    if (commandBufferWrapper == nullptr || buffer == nullptr) {
         return;
     }
 
-    // Setup index buffer
-    indexBufferWrapper->mtlIndexType = toMtlIndexType(indexType);
-    indexBufferWrapper->offset       = offset;
+    if (!commandBufferWrapper->bindings.bindIndexBuffer(buffer, offset,
+                                                        indexType)) {
+        return;
+    }
 
-    // Bind index buffer to command buffer
-    commandBufferWrapper->indexBuffer = buffer;
+    // Record index buffer bind
+    BindIndexBufferCommand *command =
+        commandBufferWrapper->commands.record<BindIndexBufferCommand>();
+    command->indexType = indexType;
+    command->buffer    = getRecordedHandle(buffer);
+    command->offset    = offset;
 }
 
 void MetalWrapper::cmdBindDescriptorSets(
     FvCommandBuffer commandBuffer, FvPipelineLayout layout, uint32_t firstSet,
-    uint32_t descriptorSetCount, const FvDescriptorSet *descriptorSets) {
+    uint32_t descriptorSetCount, const FvDescriptorSet *descriptorSets,
+    uint32_t dynamicOffsetCount, const uint32_t *dynamicOffsets) {
     // Get command buffer
     CommandBufferWrapper *commandBufferWrapper =
-        commandBuffers.get(*((const Handle *)commandBuffer));
+        commandBuffers.get(*((const ObjectHandle *)commandBuffer));
 
     if (commandBufferWrapper == nullptr) {
         return;
     }
 
-    // Add each descriptor set to command buffer
-    for (uint32_t i = 0; i < descriptorSetCount; ++i) {
-        commandBufferWrapper->descriptorSets.push_back(descriptorSets[i]);
+    // Resolve the descriptor sets when recording, replaying only walks their
+    // bindings
+    recordDescriptorSetBinds(
+        commandBufferWrapper->commands, commandBufferWrapper->bindings,
+        firstSet, descriptorSetCount, descriptorSets, dynamicOffsetCount,
+        dynamicOffsets,
+        [this](FvDescriptorSet descriptorSet,
+               ObjectHandle *handle) -> const MetalBindingTable * {
+            *handle = getRecordedHandle(descriptorSet);
+
+            const DescriptorSetWrapper *descriptorSetWrapper =
+                this->descriptorSets.get(*handle);
+
+            return descriptorSetWrapper != nullptr
+                       ? descriptorSetWrapper->bindings.get()
+                       : nullptr;
+        });
+}
+
+void MetalWrapper::cmdPushConstants(FvCommandBuffer commandBuffer,
+                                    FvPipelineLayout layout, int stageFlags,
+                                    uint32_t offset, uint32_t size,
+                                    const void *values) {
+    // Get command buffer and pipeline layout
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+    const PipelineLayoutWrapper *layoutWrapper = nullptr;
+
+    const ObjectHandle *handle       = (const ObjectHandle *)commandBuffer;
+    const ObjectHandle *layoutHandle = (const ObjectHandle *)layout;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+    if (layoutHandle != nullptr) {
+        layoutWrapper = pipelineLayouts.get(*layoutHandle);
+    }
+
+    if (commandBufferWrapper == nullptr || layoutWrapper == nullptr ||
+        values == nullptr || size == 0 || offset % 4 != 0 || size % 4 != 0) {
+        return;
+    }
+
+    // The update must lie within a range visible to all of its stages
+    bool inRange = false;
+    for (const FvPushConstantRange &range : layoutWrapper->pushConstantRanges) {
+        if (offset >= range.offset &&
+            offset + (uint64_t)size <= (uint64_t)range.offset + range.size &&
+            (stageFlags & ~range.stageFlags) == 0) {
+            inRange = true;
+            break;
+        }
+    }
+
+    if (!inRange) {
+        return;
     }
+
+    // Store the values inline, so no buffer is needed to get them to the GPU
+    PushConstantsCommand *command =
+        commandBufferWrapper->commands.record<PushConstantsCommand>(size);
+    command->layout     = getRecordedHandle(layout);
+    command->stageFlags = stageFlags;
+    command->offset     = offset;
+    command->size       = size;
+    memcpy(getPayload(command), values, size);
 }
 
 void MetalWrapper::cmdDraw(FvCommandBuffer commandBuffer, uint32_t vertexCount,
@@ -1148,18 +2148,19 @@ void MetalWrapper::cmdDraw(FvCommandBuffer commandBuffer, uint32_t vertexCount,
     // Get command buffer
     CommandBufferWrapper *commandBufferWrapper = nullptr;
 
-    const Handle *handle = (const Handle *)commandBuffer;
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
     if (handle != nullptr) {
         commandBufferWrapper = commandBuffers.get(*handle);
     }
 
     if (commandBufferWrapper != nullptr) {
-        commandBufferWrapper->drawCall.type = DRAW_CALL_TYPE_NON_INDEXED;
-        commandBufferWrapper->drawCall.nonIndexed.vertexCount   = vertexCount;
-        commandBufferWrapper->drawCall.nonIndexed.instanceCount = instanceCount;
-        commandBufferWrapper->drawCall.nonIndexed.firstVertex   = firstVertex;
-        commandBufferWrapper->drawCall.nonIndexed.firstInstance = firstInstance;
+        DrawCommand *command =
+            commandBufferWrapper->commands.record<DrawCommand>();
+        command->vertexCount   = vertexCount;
+        command->instanceCount = instanceCount;
+        command->firstVertex   = firstVertex;
+        command->firstInstance = firstInstance;
     }
 }
 
@@ -1170,114 +2171,397 @@ void MetalWrapper::cmdDrawIndexed(FvCommandBuffer commandBuffer,
 
     // Get command buffer
     CommandBufferWrapper *commandBufferWrapper =
-        commandBuffers.get(*((const Handle *)commandBuffer));
+        commandBuffers.get(*((const ObjectHandle *)commandBuffer));
+
+    if (commandBufferWrapper != nullptr) {
+        DrawIndexedCommand *command =
+            commandBufferWrapper->commands.record<DrawIndexedCommand>();
+        command->indexCount    = indexCount;
+        command->instanceCount = instanceCount;
+        command->firstIndex    = firstIndex;
+        command->vertexOffset  = vertexOffset;
+        command->firstInstance = firstInstance;
+    }
+}
+
+void MetalWrapper::cmdDrawIndirect(FvCommandBuffer commandBuffer,
+                                   FvBuffer buffer, FvSize offset,
+                                   uint32_t drawCount, uint32_t stride) {
+    // Get command buffer
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+
+    if (commandBufferWrapper == nullptr || buffer == nullptr ||
+        drawCount == 0) {
+        return;
+    }
+
+    // The arguments are only read from the buffer at submit
+    DrawIndirectCommand *command =
+        commandBufferWrapper->commands.record<DrawIndirectCommand>();
+    command->buffer    = getRecordedHandle(buffer);
+    command->offset    = offset;
+    command->drawCount = drawCount;
+    command->stride    = stride;
+}
+
+void MetalWrapper::cmdDrawIndexedIndirect(FvCommandBuffer commandBuffer,
+                                          FvBuffer buffer, FvSize offset,
+                                          uint32_t drawCount, uint32_t stride) {
+    // Get command buffer
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+
+    if (commandBufferWrapper == nullptr || buffer == nullptr ||
+        drawCount == 0) {
+        return;
+    }
+
+    // The arguments are only read from the buffer at submit
+    DrawIndexedIndirectCommand *command =
+        commandBufferWrapper->commands.record<DrawIndexedIndirectCommand>();
+    command->buffer    = getRecordedHandle(buffer);
+    command->offset    = offset;
+    command->drawCount = drawCount;
+    command->stride    = stride;
+}
+
+void MetalWrapper::cmdBeginRenderPass(
+    FvCommandBuffer commandBuffer,
+    const FvRenderPassBeginInfo *renderPassInfo) {
+    // Get command buffer wrapper
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+
+    if (renderPassInfo == nullptr || commandBufferWrapper == nullptr) {
+        return;
+    }
+
+    // Get framebuffer
+    FramebufferWrapper *framebufferWrapper = nullptr;
+    handle = (const ObjectHandle *)renderPassInfo->framebuffer;
+
+    if (handle != nullptr) {
+        framebufferWrapper = framebuffers.get(*handle);
+    }
+
+    if (framebufferWrapper == nullptr) {
+        return;
+    }
+
+    // Store clear values
+    for (uint32_t i = 0; i < renderPassInfo->clearValueCount; ++i) {
+        commandBufferWrapper->clearValues.push_back(
+            renderPassInfo->clearValues[i]);
+    }
+
+    // Store texture attachments
+    commandBufferWrapper->attachments = framebufferWrapper->attachments;
+
+    // Copies recorded so far are encoded ahead of the render pass
+    commandBufferWrapper->inRenderPass = true;
+
+    if (commandBufferWrapper->renderPassBegin ==
+        CommandBufferWrapper::NO_RENDER_PASS) {
+        commandBufferWrapper->renderPassBegin =
+            commandBufferWrapper->commands.size();
+    }
+}
+
+void MetalWrapper::cmdEndRenderPass(FvCommandBuffer commandBuffer) {
+    // Get command buffer wrapper
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+
+        if (commandBufferWrapper != nullptr) {
+            commandBufferWrapper->readyForSubmit = true;
+            commandBufferWrapper->inRenderPass   = false;
+        }
+    }
+}
+
+void MetalWrapper::cmdExecuteCommands(FvCommandBuffer commandBuffer,
+                                      uint32_t commandBufferCount,
+                                      const FvCommandBuffer *secondaries) {
+    // Get command buffer wrapper
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+
+    if (commandBufferWrapper == nullptr || commandBufferWrapper->secondary ||
+        secondaries == nullptr) {
+        return;
+    }
+
+    // Record a reference to each secondary, its commands are replayed in
+    // place at submit, so it may still be recording on another thread
+    for (uint32_t i = 0; i < commandBufferCount; ++i) {
+        ExecuteCommandsCommand *command =
+            commandBufferWrapper->commands.record<ExecuteCommandsCommand>();
+        command->commandBuffer = getRecordedHandle(secondaries[i]);
+    }
+
+    // Whatever the secondaries bind is still bound after them
+    commandBufferWrapper->bindings.invalidate();
+}
+
+void MetalWrapper::cmdCopyBuffer(FvCommandBuffer commandBuffer,
+                                 FvBuffer srcBuffer, FvBuffer dstBuffer,
+                                 uint32_t regionCount,
+                                 const FvBufferCopy *regions) {
+    // Get command buffer and buffers
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+    const BufferWrapper *srcWrapper            = nullptr;
+    const BufferWrapper *dstWrapper            = nullptr;
+
+    const ObjectHandle *handle    = (const ObjectHandle *)commandBuffer;
+    const ObjectHandle *srcHandle = (const ObjectHandle *)srcBuffer;
+    const ObjectHandle *dstHandle = (const ObjectHandle *)dstBuffer;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+    if (srcHandle != nullptr) {
+        srcWrapper = buffers.get(*srcHandle);
+    }
+    if (dstHandle != nullptr) {
+        dstWrapper = buffers.get(*dstHandle);
+    }
+
+    // Metal can't copy in the middle of a render pass
+    if (commandBufferWrapper == nullptr || commandBufferWrapper->secondary ||
+        commandBufferWrapper->inRenderPass || srcWrapper == nullptr ||
+        dstWrapper == nullptr || regions == nullptr) {
+        return;
+    }
+
+    const FvSize srcSize = [srcWrapper->mtlBuffer length];
+    const FvSize dstSize = [dstWrapper->mtlBuffer length];
+
+    // One command per region, dropping those reaching outside the buffers
+    for (uint32_t i = 0; i < regionCount; ++i) {
+        const FvBufferCopy &region = regions[i];
+
+        if (region.srcOffset > srcSize ||
+            region.size > srcSize - region.srcOffset ||
+            region.dstOffset > dstSize ||
+            region.size > dstSize - region.dstOffset) {
+            continue;
+        }
+
+        CopyBufferCommand *command =
+            commandBufferWrapper->commands.record<CopyBufferCommand>();
+        command->srcBuffer = getRecordedHandle(srcBuffer);
+        command->dstBuffer = getRecordedHandle(dstBuffer);
+        command->region    = region;
+    }
+}
+
+void MetalWrapper::cmdCopyBufferToImage(FvCommandBuffer commandBuffer,
+                                        FvBuffer srcBuffer, FvImage dstImage,
+                                        uint32_t regionCount,
+                                        const FvBufferImageCopy *regions) {
+    // Get command buffer, buffer and image
+    CommandBufferWrapper *commandBufferWrapper = nullptr;
+    const BufferWrapper *srcWrapper            = nullptr;
+    const ImageWrapper *dstWrapper             = nullptr;
+
+    const ObjectHandle *handle    = (const ObjectHandle *)commandBuffer;
+    const ObjectHandle *srcHandle = (const ObjectHandle *)srcBuffer;
+    const ObjectHandle *dstHandle = (const ObjectHandle *)dstImage;
+
+    if (handle != nullptr) {
+        commandBufferWrapper = commandBuffers.get(*handle);
+    }
+    if (srcHandle != nullptr) {
+        srcWrapper = buffers.get(*srcHandle);
+    }
+    if (dstHandle != nullptr) {
+        dstWrapper = textures.get(*dstHandle);
+    }
+
+    // Drawables only have a texture while they are being rendered to
+    if (commandBufferWrapper == nullptr || commandBufferWrapper->secondary ||
+        commandBufferWrapper->inRenderPass || srcWrapper == nullptr ||
+        dstWrapper == nullptr || dstWrapper->isDrawable || regions == nullptr) {
+        return;
+    }
+
+    const FvSize srcSize = [srcWrapper->mtlBuffer length];
+
+    for (uint32_t i = 0; i < regionCount; ++i) {
+        const FvBufferImageCopy &region = regions[i];
+
+        if (region.bufferOffset > srcSize) {
+            continue;
+        }
+
+        CopyBufferToImageCommand *command =
+            commandBufferWrapper->commands.record<CopyBufferToImageCommand>();
+        command->srcBuffer = getRecordedHandle(srcBuffer);
+        command->dstImage  = getRecordedHandle(dstImage);
+        command->region    = region;
+    }
+}
+
+FvResult MetalWrapper::commandBufferCreate(FvCommandBuffer *commandBuffer,
+                                           FvCommandPool commandPool,
+                                           bool secondary) {
+    // Get command pool to create command buffer from
+    CommandPoolWrapper *commandPoolWrapper = nullptr;
+    const ObjectHandle *handle             = (const ObjectHandle *)commandPool;
+
+    if (handle != nullptr) {
+        commandPoolWrapper = commandPools.get(*handle);
+    }
 
-    if (commandBufferWrapper != nullptr) {
-        commandBufferWrapper->drawCall.type = DRAW_CALL_TYPE_INDEXED;
-        commandBufferWrapper->drawCall.indexed.indexCount    = indexCount;
-        commandBufferWrapper->drawCall.indexed.instanceCount = instanceCount;
-        commandBufferWrapper->drawCall.indexed.firstIndex    = firstIndex;
-        commandBufferWrapper->drawCall.indexed.vertexOffset  = vertexOffset;
-        commandBufferWrapper->drawCall.indexed.firstInstance = firstInstance;
+    if (commandBuffer == nullptr || commandPoolWrapper == nullptr) {
+        return FV_RESULT_FAILURE;
     }
-}
 
-void MetalWrapper::cmdBeginRenderPass(
-    FvCommandBuffer commandBuffer,
-    const FvRenderPassBeginInfo *renderPassInfo) {
-    // Get command buffer wrapper
-    CommandBufferWrapper *commandBufferWrapper = nullptr;
+    // Record into the memory of the pool
+    CommandBufferWrapper commandBufferWrapper(
+        commandPoolWrapper->blockPool.get(), secondary);
+    commandBufferWrapper.commandQueue = commandPoolWrapper->commandQueue;
+    commandBufferWrapper.queueType    = commandPoolWrapper->queueType;
+    commandBufferWrapper.commandPool  = commandPool;
 
-    const Handle *handle = (const Handle *)commandBuffer;
+    // Store command buffer and return handle
+    handle = addObject(commandBuffers, std::move(commandBufferWrapper));
 
     if (handle != nullptr) {
-        commandBufferWrapper = commandBuffers.get(*handle);
+        *commandBuffer = (FvCommandBuffer)handle;
+        commandPoolWrapper->commandBuffers.push_back(*commandBuffer);
+    } else {
+        return FV_RESULT_FAILURE;
     }
 
-    if (renderPassInfo == nullptr || commandBufferWrapper == nullptr) {
+    return FV_RESULT_SUCCESS;
+}
+
+void MetalWrapper::commandBufferDestroy(FvCommandBuffer commandBuffer) {
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
+
+    if (handle == nullptr) {
         return;
     }
 
-    // Get framebuffer
-    FramebufferWrapper *framebufferWrapper = nullptr;
-    handle = (const Handle *)renderPassInfo->framebuffer;
+    std::lock_guard<std::mutex> lock(objectMutex);
 
-    if (handle != nullptr) {
-        framebufferWrapper = framebuffers.get(*handle);
-    }
+    CommandBufferWrapper *commandBufferWrapper = commandBuffers.get(*handle);
 
-    if (framebufferWrapper == nullptr) {
+    if (commandBufferWrapper == nullptr) {
         return;
     }
 
-    // Store clear values
-    for (uint32_t i = 0; i < renderPassInfo->clearValueCount; ++i) {
-        commandBufferWrapper->clearValues.push_back(
-            renderPassInfo->clearValues[i]);
+    // Forget the command buffer in its pool, order there doesn't matter
+    const ObjectHandle *poolHandle =
+        (const ObjectHandle *)commandBufferWrapper->commandPool;
+    CommandPoolWrapper *commandPoolWrapper = commandPools.get(*poolHandle);
+
+    if (commandPoolWrapper != nullptr) {
+        std::vector<FvCommandBuffer> &poolBuffers =
+            commandPoolWrapper->commandBuffers;
+
+        for (size_t i = 0; i < poolBuffers.size(); ++i) {
+            if (poolBuffers[i] == commandBuffer) {
+                poolBuffers[i] = poolBuffers.back();
+                poolBuffers.pop_back();
+                break;
+            }
+        }
     }
 
-    // Store texture attachments
-    commandBufferWrapper->attachments = framebufferWrapper->attachments;
+    // Recorded memory goes back to the pool with the command stream
+    commandBuffers.remove(*handle);
 }
 
-void MetalWrapper::cmdEndRenderPass(FvCommandBuffer commandBuffer) {
+void MetalWrapper::commandBufferBegin(FvCommandBuffer commandBuffer) {
     // Get command buffer wrapper
     CommandBufferWrapper *commandBufferWrapper = nullptr;
 
-    const Handle *handle = (const Handle *)commandBuffer;
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
     if (handle != nullptr) {
         commandBufferWrapper = commandBuffers.get(*handle);
+    }
 
-        if (commandBufferWrapper != nullptr) {
-            commandBufferWrapper->readyForSubmit = true;
-        }
+    if (commandBufferWrapper == nullptr) {
+        return;
     }
-}
 
-FvResult MetalWrapper::commandBufferCreate(FvCommandBuffer *commandBuffer,
-                                           FvCommandPool commandPool) {
-    // Get command pool to create command buffer from
-    id<MTLCommandQueue> commandQueue = nil;
-    const Handle *handle             = (const Handle *)commandPool;
+    // Clear recorded commands, their memory is reused for the new ones
+    std::lock_guard<std::mutex> lock(objectMutex);
+    commandBufferWrapper->reset();
+}
 
-    if (handle != nullptr) {
-        id<MTLCommandQueue> *tmp = commandQueues.get(*handle);
+void MetalWrapper::commandBufferGetStatistics(
+    FvCommandBuffer commandBuffer, FvCommandBufferStatistics *statistics) {
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
-        if (tmp != nullptr) {
-            commandQueue = *tmp;
-        }
+    if (handle == nullptr || statistics == nullptr) {
+        return;
     }
 
-    if (commandBuffer == nullptr || commandQueue == nil) {
-        return FV_RESULT_FAILURE;
+    const CommandBufferWrapper *commandBufferWrapper =
+        commandBuffers.get(*handle);
+
+    if (commandBufferWrapper == nullptr) {
+        return;
     }
 
-    CommandBufferWrapper commandBufferWrapper;
-    commandBufferWrapper.commandQueue   = commandQueue;
-    commandBufferWrapper.readyForSubmit = false;
+    // Elided state changes are counted as the command buffer is encoded
+    std::lock_guard<std::mutex> lock(objectMutex);
 
-    // Store command buffer and return handle
-    handle = commandBuffers.add(commandBufferWrapper);
+    statistics->bindCount = commandBufferWrapper->bindings.getNumBinds();
+    statistics->elidedBindCount =
+        commandBufferWrapper->bindings.getNumElidedBinds();
+    statistics->elidedStateChangeCount =
+        commandBufferWrapper->numElidedStateChanges;
+}
 
-    if (handle != nullptr) {
-        *commandBuffer = (FvCommandBuffer)handle;
-    } else {
-        return FV_RESULT_FAILURE;
-    }
+void MetalWrapper::commandBufferReset(FvCommandBuffer commandBuffer) {
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
-    return FV_RESULT_SUCCESS;
-}
+    if (handle != nullptr) {
+        CommandBufferWrapper *commandBufferWrapper =
+            commandBuffers.get(*handle);
 
-void MetalWrapper::commandBufferBegin(FvCommandBuffer commandBuffer) {
-    // Clear recorded commands
+        if (commandBufferWrapper != nullptr) {
+            std::lock_guard<std::mutex> lock(objectMutex);
+            commandBufferWrapper->reset();
+        }
+    }
 }
 
 FvResult MetalWrapper::commandBufferEnd(FvCommandBuffer commandBuffer) {
     // Get command buffer wrapper
     CommandBufferWrapper *commandBufferWrapper = nullptr;
 
-    const Handle *handle = (const Handle *)commandBuffer;
+    const ObjectHandle *handle = (const ObjectHandle *)commandBuffer;
 
     if (handle != nullptr) {
         commandBufferWrapper = commandBuffers.get(*handle);
@@ -1287,7 +2571,9 @@ FvResult MetalWrapper::commandBufferEnd(FvCommandBuffer commandBuffer) {
         return FV_RESULT_FAILURE;
     }
 
-    if (commandBufferWrapper->readyForSubmit == false) {
+    // Secondaries record commands for the render pass of a primary
+    if (commandBufferWrapper->secondary == false &&
+        commandBufferWrapper->readyForSubmit == false) {
         // Render pass not ended with 'fvCmdEndRenderPass'
         return FV_RESULT_FAILURE;
     }
@@ -1302,19 +2588,32 @@ MetalWrapper::commandPoolCreate(FvCommandPool *commandPool,
         return FV_RESULT_FAILURE;
     }
 
-    // Create command queue (MTL) / command pool (Fever)
-    id<MTLCommandQueue> commandQueue = [device newCommandQueue];
+    // Submit to the given queue, or the graphics queue
+    const ObjectHandle *queueHandle = (const ObjectHandle *)createInfo->queue;
+
+    if (queueHandle == nullptr) {
+        queueHandle = queueHandles[FV_QUEUE_TYPE_GRAPHICS];
+    }
+
+    const QueueWrapper *queueWrapper =
+        queueHandle != nullptr ? queues.get(*queueHandle) : nullptr;
 
-    if (commandQueue == nil) {
+    if (queueWrapper == nullptr) {
         return FV_RESULT_FAILURE;
     }
 
-    // Store command queue and return handle
-    const Handle *handle = commandQueues.add(commandQueue);
+    CommandPoolWrapper commandPoolWrapper;
+    commandPoolWrapper.commandQueue = [queueWrapper->commandQueue retain];
+    commandPoolWrapper.queueType    = queueWrapper->type;
+
+    // Store command pool and return handle
+    const ObjectHandle *handle =
+        addObject(commandPools, std::move(commandPoolWrapper));
 
     if (handle != nullptr) {
         *commandPool = (FvCommandPool)handle;
     } else {
+        FV_MTL_RELEASE(commandPoolWrapper.commandQueue);
         return FV_RESULT_FAILURE;
     }
 
@@ -1322,17 +2621,54 @@ MetalWrapper::commandPoolCreate(FvCommandPool *commandPool,
 }
 
 void MetalWrapper::commandPoolDestroy(FvCommandPool commandPool) {
-    const Handle *handle = (const Handle *)commandPool;
+    const ObjectHandle *handle = (const ObjectHandle *)commandPool;
 
-    if (handle != nullptr) {
-        id<MTLCommandQueue> *commandQueue = commandQueues.get(*handle);
+    if (handle == nullptr) {
+        return;
+    }
+
+    CommandPoolWrapper *commandPoolWrapper = commandPools.get(*handle);
 
-        // Destroy command queue
-        if (commandQueue != nullptr) {
-            FV_MTL_RELEASE(*commandQueue);
+    if (commandPoolWrapper != nullptr) {
+        std::lock_guard<std::mutex> lock(objectMutex);
+
+        // Command buffers record into the pool, so they go with it
+        for (FvCommandBuffer commandBuffer :
+             commandPoolWrapper->commandBuffers) {
+            commandBuffers.remove(*(const ObjectHandle *)commandBuffer);
         }
+        commandPoolWrapper->commandBuffers.clear();
+
+        // Let go of the queue's command queue
+        FV_MTL_RELEASE(commandPoolWrapper->commandQueue);
+    }
+
+    commandPools.remove(*handle);
+}
+
+void MetalWrapper::commandPoolReset(FvCommandPool commandPool) {
+    const ObjectHandle *handle = (const ObjectHandle *)commandPool;
+
+    if (handle == nullptr) {
+        return;
+    }
 
-        commandQueues.remove(*handle);
+    CommandPoolWrapper *commandPoolWrapper = commandPools.get(*handle);
+
+    if (commandPoolWrapper == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(objectMutex);
+
+    // Every command buffer hands its blocks back, ready for the next frame
+    for (FvCommandBuffer commandBuffer : commandPoolWrapper->commandBuffers) {
+        CommandBufferWrapper *commandBufferWrapper =
+            commandBuffers.get(*(const ObjectHandle *)commandBuffer);
+
+        if (commandBufferWrapper != nullptr) {
+            commandBufferWrapper->reset();
+        }
     }
 }
 
@@ -1347,7 +2683,8 @@ MetalWrapper::framebufferCreate(FvFramebuffer *framebuffer,
     for (uint32_t i = 0; i < createInfo->attachmentCount; ++i) {
         // Get texture of image view attachment and store in the frambuffer
         // wrapper
-        const Handle *handle = (const Handle *)createInfo->attachments[i];
+        const ObjectHandle *handle =
+            (const ObjectHandle *)createInfo->attachments[i];
 
         if (handle != nullptr) {
             ImageWrapper *texture = textures.get(*handle);
@@ -1359,7 +2696,7 @@ MetalWrapper::framebufferCreate(FvFramebuffer *framebuffer,
     }
 
     // Store framebuffer and return handle
-    const Handle *handle = framebuffers.add(framebufferWrapper);
+    const ObjectHandle *handle = addObject(framebuffers, framebufferWrapper);
 
     if (handle != nullptr) {
         *framebuffer = (FvFramebuffer)handle;
@@ -1371,44 +2708,22 @@ MetalWrapper::framebufferCreate(FvFramebuffer *framebuffer,
 }
 
 void MetalWrapper::framebufferDestroy(FvFramebuffer framebuffer) {
-    const Handle *handle = (const Handle *)framebuffer;
+    const ObjectHandle *handle = (const ObjectHandle *)framebuffer;
 
     if (handle != nullptr) {
         framebuffers.remove(*handle);
     }
 }
 
-FvResult MetalWrapper::imageCreate(FvImage *image,
-                                   const FvImageCreateInfo *createInfo) {
-    if (createInfo == nullptr || image == nullptr) {
-        return FV_RESULT_FAILURE;
-    }
-
-    MTLTextureDescriptor *textureDesc;
-
-    // Determine basic dimensionality of image and create descriptor
+id<MTLTexture>
+MetalWrapper::newMtlTexture(const FvImageCreateInfo *createInfo,
+                            MTLTextureDescriptor *textureDesc) {
+    // Determine basic dimensionality of image
     if (createInfo->imageType == FV_IMAGE_TYPE_1D ||
         createInfo->imageType == FV_IMAGE_TYPE_2D) {
-        textureDesc = [MTLTextureDescriptor
-            texture2DDescriptorWithPixelFormat:toMtlPixelFormat(
-                                                   createInfo->format)
-                                         width:createInfo->extent.width
-                                        height:createInfo->extent.height
-                                     mipmapped:createInfo->mipLevels > 1 ? YES
-                                                                         : NO];
-
+        textureDesc.textureType = MTLTextureType2D;
     } else {
-        textureDesc = [MTLTextureDescriptor
-            textureCubeDescriptorWithPixelFormat:toMtlPixelFormat(
-                                                     createInfo->format)
-                                            size:createInfo->extent.width
-                                       mipmapped:createInfo->mipLevels > 1
-                                                     ? YES
-                                                     : NO];
-    }
-
-    if (textureDesc == NULL) {
-        return FV_RESULT_FAILURE;
+        textureDesc.textureType = MTLTextureTypeCube;
     }
 
     // Setup descriptor
@@ -1432,7 +2747,24 @@ FvResult MetalWrapper::imageCreate(FvImage *image,
     }
 
     // Create texture
-    id<MTLTexture> texture = [device newTextureWithDescriptor:textureDesc];
+    return [device newTextureWithDescriptor:textureDesc];
+}
+
+FvResult MetalWrapper::imageCreate(FvImage *image,
+                                   const FvImageCreateInfo *createInfo) {
+    if (createInfo == nullptr || image == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    MTLTextureDescriptor *textureDesc = [MTLTextureDescriptor new];
+
+    if (textureDesc == nil) {
+        return FV_RESULT_FAILURE;
+    }
+
+    id<MTLTexture> texture = newMtlTexture(createInfo, textureDesc);
+
+    FV_MTL_RELEASE(textureDesc); // Done with texture descriptor
 
     if (texture == nil) {
         return FV_RESULT_FAILURE;
@@ -1443,23 +2775,81 @@ FvResult MetalWrapper::imageCreate(FvImage *image,
     imageWrapper.isDrawable = false;
 
     // Store texture and return handle
-    const Handle *handle = textures.add(imageWrapper);
+    const ObjectHandle *handle = addObject(textures, imageWrapper);
 
     if (handle != nullptr) {
         *image = (FvImage)handle;
     } else {
+        FV_MTL_RELEASE(imageWrapper.texture);
         return FV_RESULT_FAILURE;
     }
 
     return FV_RESULT_SUCCESS;
 }
 
+FvResult MetalWrapper::imagesCreate(uint32_t count,
+                                    const FvImageCreateInfo *createInfos,
+                                    FvImage *images) {
+    if (count == 0) {
+        return FV_RESULT_SUCCESS;
+    }
+    if (createInfos == nullptr || images == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    MTLTextureDescriptor *textureDesc = [MTLTextureDescriptor new];
+
+    if (textureDesc == nil) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // One descriptor is filled in for every image, so remember the storage
+    // mode to go back to after a private texture.
+    const MTLStorageMode defaultStorageMode = textureDesc.storageMode;
+
+    {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        textures.reserve(count);
+    }
+
+    FvResult result = FV_RESULT_SUCCESS;
+
+    @autoreleasepool {
+        for (uint32_t i = 0; i < count; ++i) {
+            textureDesc.storageMode = defaultStorageMode;
+
+            ImageWrapper imageWrapper;
+            imageWrapper.texture = newMtlTexture(&createInfos[i], textureDesc);
+            imageWrapper.isDrawable = false;
+
+            const ObjectHandle *handle = nullptr;
+            if (imageWrapper.texture != nil) {
+                handle = addObject(textures, imageWrapper);
+            }
+
+            if (handle == nullptr) {
+                // All or nothing, undo the images created so far
+                FV_MTL_RELEASE(imageWrapper.texture);
+                imagesDestroy(i, images);
+                result = FV_RESULT_FAILURE;
+                break;
+            }
+
+            images[i] = (FvImage)handle;
+        }
+    }
+
+    FV_MTL_RELEASE(textureDesc); // Done with texture descriptor
+
+    return result;
+}
+
 void MetalWrapper::imageReplaceRegion(FvImage image, FvRect3D region,
                                       uint32_t mipLevel, uint32_t layer,
                                       void *data, size_t bytesPerRow,
                                       size_t bytesPerImage) {
     // Get metal image object
-    const Handle *handle = (const Handle *)image;
+    const ObjectHandle *handle = (const ObjectHandle *)image;
 
     if (handle != nullptr) {
         ImageWrapper *imageWrapper = textures.get(*handle);
@@ -1485,56 +2875,77 @@ void MetalWrapper::imageReplaceRegion(FvImage image, FvRect3D region,
 }
 
 void MetalWrapper::imageDestroy(FvImage image) {
-    const Handle *handle = (const Handle *)image;
+    const ObjectHandle *handle = (const ObjectHandle *)image;
 
     if (handle != nullptr) {
-        ImageWrapper *imageWrapper = textures.get(*handle);
+        // Submitted work may still use the texture, so wait for it
+        const ObjectHandle imageHandle = *handle;
 
-        // Destroy texture
-        if (imageWrapper != nullptr) {
-            FV_MTL_RELEASE(imageWrapper->texture);
-        }
+        deferDestroy([this, imageHandle]() {
+            ImageWrapper *imageWrapper = textures.get(imageHandle);
+
+            // Destroy texture
+            if (imageWrapper != nullptr) {
+                FV_MTL_RELEASE(imageWrapper->texture);
+            }
 
-        textures.remove(*handle);
+            textures.remove(imageHandle);
+        });
     }
 }
 
+void MetalWrapper::imagesDestroy(uint32_t count, const FvImage *images) {
+    if (images == nullptr) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        imageDestroy(images[i]);
+    }
+}
+
+id<MTLSamplerState>
+MetalWrapper::newMtlSamplerState(const FvSamplerCreateInfo *createInfo,
+                                 MTLSamplerDescriptor *samplerDescriptor) {
+    // width
+    samplerDescriptor.sAddressMode =
+        toMtlSamplerAddressMode(createInfo->addressModeU);
+    // height
+    samplerDescriptor.tAddressMode =
+        toMtlSamplerAddressMode(createInfo->addressModeV);
+    // depth
+    samplerDescriptor.rAddressMode =
+        toMtlSamplerAddressMode(createInfo->addressModeW);
+    samplerDescriptor.minFilter = toMtlMinMagFilter(createInfo->minFilter);
+    samplerDescriptor.magFilter = toMtlMinMagFilter(createInfo->magFilter);
+    samplerDescriptor.mipFilter = toMtlSamplerMipFilter(createInfo->mipmapMode);
+    samplerDescriptor.lodMinClamp   = createInfo->minLod;
+    samplerDescriptor.lodMaxClamp   = createInfo->maxLod;
+    samplerDescriptor.maxAnisotropy = createInfo->maxAnisotropy;
+    samplerDescriptor.normalizedCoordinates =
+        toObjCBool(createInfo->normalizedCoordinates);
+    samplerDescriptor.compareFunction =
+        toMtlCompareFunction(createInfo->compareFunc);
+    samplerDescriptor.borderColor =
+        toMtlSamplerBorderColor(createInfo->borderColor);
+
+    return [device newSamplerStateWithDescriptor:samplerDescriptor];
+}
+
 FvResult MetalWrapper::samplerCreate(FvSampler *sampler,
                                      const FvSamplerCreateInfo *createInfo) {
     FvResult result = FV_RESULT_FAILURE;
 
     if (sampler != nullptr && createInfo != nullptr) {
         MTLSamplerDescriptor *samplerDescriptor = [MTLSamplerDescriptor new];
-        // width
-        samplerDescriptor.sAddressMode =
-            toMtlSamplerAddressMode(createInfo->addressModeU);
-        // height
-        samplerDescriptor.tAddressMode =
-            toMtlSamplerAddressMode(createInfo->addressModeV);
-        // depth
-        samplerDescriptor.rAddressMode =
-            toMtlSamplerAddressMode(createInfo->addressModeW);
-        samplerDescriptor.minFilter = toMtlMinMagFilter(createInfo->minFilter);
-        samplerDescriptor.magFilter = toMtlMinMagFilter(createInfo->magFilter);
-        samplerDescriptor.mipFilter =
-            toMtlSamplerMipFilter(createInfo->mipmapMode);
-        samplerDescriptor.lodMinClamp   = createInfo->minLod;
-        samplerDescriptor.lodMaxClamp   = createInfo->maxLod;
-        samplerDescriptor.maxAnisotropy = createInfo->maxAnisotropy;
-        samplerDescriptor.normalizedCoordinates =
-            toObjCBool(createInfo->normalizedCoordinates);
-        samplerDescriptor.compareFunction =
-            toMtlCompareFunction(createInfo->compareFunc);
-        samplerDescriptor.borderColor =
-            toMtlSamplerBorderColor(createInfo->borderColor);
 
         id<MTLSamplerState> mtlSampler =
-            [device newSamplerStateWithDescriptor:samplerDescriptor];
+            newMtlSamplerState(createInfo, samplerDescriptor);
 
         FV_MTL_RELEASE(samplerDescriptor); // Done with sampler descriptor
 
         // Store sampler and return handle
-        const Handle *handle = samplers.add(mtlSampler);
+        const ObjectHandle *handle = addObject(samplers, mtlSampler);
 
         if (handle != nullptr) {
             *sampler = (FvSampler)handle;
@@ -1545,32 +2956,190 @@ FvResult MetalWrapper::samplerCreate(FvSampler *sampler,
     return result;
 }
 
+FvResult MetalWrapper::samplersCreate(uint32_t count,
+                                      const FvSamplerCreateInfo *createInfos,
+                                      FvSampler *samplers) {
+    if (count == 0) {
+        return FV_RESULT_SUCCESS;
+    }
+    if (createInfos == nullptr || samplers == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    MTLSamplerDescriptor *samplerDescriptor = [MTLSamplerDescriptor new];
+
+    {
+        std::lock_guard<std::mutex> lock(objectMutex);
+        this->samplers.reserve(count);
+    }
+
+    FvResult result = FV_RESULT_SUCCESS;
+
+    @autoreleasepool {
+        for (uint32_t i = 0; i < count; ++i) {
+            id<MTLSamplerState> mtlSampler =
+                newMtlSamplerState(&createInfos[i], samplerDescriptor);
+
+            const ObjectHandle *handle = nullptr;
+            if (mtlSampler != nil) {
+                handle = addObject(this->samplers, mtlSampler);
+            }
+
+            if (handle == nullptr) {
+                // All or nothing, undo the samplers created so far
+                FV_MTL_RELEASE(mtlSampler);
+                samplersDestroy(i, samplers);
+                result = FV_RESULT_FAILURE;
+                break;
+            }
+
+            samplers[i] = (FvSampler)handle;
+        }
+    }
+
+    FV_MTL_RELEASE(samplerDescriptor); // Done with sampler descriptor
+
+    return result;
+}
+
 void MetalWrapper::samplerDestroy(FvSampler sampler) {
-    const Handle *handle = (const Handle *)sampler;
+    const ObjectHandle *handle = (const ObjectHandle *)sampler;
 
     if (handle != nullptr) {
-        id<MTLSamplerState> *mtlSampler = samplers.get(*handle);
+        // Submitted work may still sample with it, so wait for it
+        const ObjectHandle samplerHandle = *handle;
 
-        if (mtlSampler != nullptr) {
-            // Ensure sampler's memory is freed
-            FV_MTL_RELEASE(*mtlSampler);
-        }
+        deferDestroy([this, samplerHandle]() {
+            id<MTLSamplerState> *mtlSampler = samplers.get(samplerHandle);
+
+            if (mtlSampler != nullptr) {
+                // Ensure sampler's memory is freed
+                FV_MTL_RELEASE(*mtlSampler);
+            }
+
+            // Remove sampler from internal store
+            samplers.remove(samplerHandle);
+        });
+    }
+}
 
-        // Remove sampler from internal store
-        samplers.remove(*handle);
+void MetalWrapper::samplersDestroy(uint32_t count, const FvSampler *samplers) {
+    if (samplers == nullptr) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        samplerDestroy(samplers[i]);
     }
 }
 
 FvResult MetalWrapper::graphicsPipelineCreate(
     FvGraphicsPipeline *graphicsPipeline,
     const FvGraphicsPipelineCreateInfo *createInfo) {
+    if (graphicsPipeline == nullptr || createInfo == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    return graphicsPipelinesCreate(1, createInfo, graphicsPipeline);
+}
+
+FvResult MetalWrapper::graphicsPipelinesCreate(
+    uint32_t count, const FvGraphicsPipelineCreateInfo *createInfos,
+    FvGraphicsPipeline *graphicsPipelines) {
+    if (count == 0) {
+        return FV_RESULT_SUCCESS;
+    }
+    if (createInfos == nullptr || graphicsPipelines == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    // Compiling the shaders into pipeline states is most of the work, spread
+    // it over the workers
+    std::vector<BuiltGraphicsPipeline> built(count);
+    std::vector<FvResult> results(count, FV_RESULT_FAILURE);
+
+    jobs->parallelFor(count, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            results[i] = buildGraphicsPipeline(&createInfos[i], &built[i]);
+        }
+    });
+
+    const bool allBuilt =
+        std::all_of(results.begin(), results.end(), [](FvResult result) {
+            return result == FV_RESULT_SUCCESS;
+        });
+
+    // Add the pipelines on this thread, as the stores aren't thread-safe
+    uint32_t numAdded = 0;
+
+    if (allBuilt) {
+        {
+            std::lock_guard<std::mutex> lock(objectMutex);
+            this->graphicsPipelines.reserve(count);
+        }
+
+        for (; numAdded < count; ++numAdded) {
+            const ObjectHandle *handle =
+                addObject(this->graphicsPipelines, built[numAdded].pipeline);
+
+            if (handle == nullptr) {
+                break;
+            }
+
+            graphicsPipelines[numAdded] = (FvGraphicsPipeline)handle;
+
+            // Provide the shader modules with reflection information
+            const FvGraphicsPipelineCreateInfo &createInfo =
+                createInfos[numAdded];
+
+            for (uint32_t iStage = 0; iStage < createInfo.stageCount;
+                 ++iStage) {
+                ObjectHandle *shaderModuleHandle =
+                    (ObjectHandle *)createInfo.stages[iStage].shaderModule;
+
+                ShaderModuleWrapper *shaderModuleWrapper =
+                    shaderModuleHandle != nullptr
+                        ? libraries.get(*shaderModuleHandle)
+                        : nullptr;
+
+                if (shaderModuleWrapper != nullptr) {
+                    shaderModuleWrapper->vertexArgumentReflection =
+                        built[numAdded].vertexArguments;
+                    shaderModuleWrapper->fragmentArgumentReflection =
+                        built[numAdded].fragmentArguments;
+                }
+            }
+        }
+    }
+
+    if (numAdded < count) {
+        // All or nothing, undo the pipelines added and release the rest
+        for (uint32_t i = 0; i < numAdded; ++i) {
+            graphicsPipelineDestroy(graphicsPipelines[i]);
+        }
+        for (uint32_t i = numAdded; i < count; ++i) {
+            if (results[i] == FV_RESULT_SUCCESS) {
+                FV_MTL_RELEASE(built[i].pipeline.depthStencilState);
+                FV_MTL_RELEASE(built[i].pipeline.renderPipelineState);
+            }
+        }
+
+        return FV_RESULT_FAILURE;
+    }
+
+    return FV_RESULT_SUCCESS;
+}
+
+FvResult MetalWrapper::buildGraphicsPipeline(
+    const FvGraphicsPipelineCreateInfo *createInfo,
+    BuiltGraphicsPipeline *built) {
     // TODO: Clean up, put into separate functions, deal with optional
     // fields
     // early
     @autoreleasepool {
         FvResult result = FV_RESULT_FAILURE;
 
-        if (graphicsPipeline != nullptr && createInfo != nullptr) {
+        if (createInfo != nullptr) {
             // Create GraphicsPipelineWrapper
             GraphicsPipelineWrapper graphicsPipelineWrapper;
             graphicsPipelineWrapper.renderPass          = nullptr;
@@ -1583,7 +3152,8 @@ FvResult MetalWrapper::graphicsPipelineCreate(
                 *createInfo->vertexInputDescription;
 
             // Get subpass to use from render pass and index
-            Handle *renderPassHandle = (Handle *)createInfo->renderPass;
+            ObjectHandle *renderPassHandle =
+                (ObjectHandle *)createInfo->renderPass;
 
             if (renderPassHandle != nullptr) {
                 RenderPassWrapper *renderPassWrapper =
@@ -1610,9 +3180,11 @@ FvResult MetalWrapper::graphicsPipelineCreate(
                         subpassWrapper.mtlRenderPass;
 
                     // Fill out shader functions for Metal pipeline
-                    // descriptor
+                    // descriptor, a copy of the subpass's as pipelines
+                    // of the same subpass may be built at once
                     MTLRenderPipelineDescriptor *mtlPipelineDescriptor =
-                        subpassWrapper.mtlPipelineDescriptor;
+                        [[subpassWrapper.mtlPipelineDescriptor copy]
+                            autorelease];
 
                     if (createInfo->stages != nullptr) {
                         // Loop thru shader stages and assign functions to
@@ -1621,8 +3193,8 @@ FvResult MetalWrapper::graphicsPipelineCreate(
                             FvPipelineShaderStageDescription shaderStage =
                                 createInfo->stages[i];
 
-                            Handle *shaderModuleHandle =
-                                (Handle *)shaderStage.shaderModule;
+                            ObjectHandle *shaderModuleHandle =
+                                (ObjectHandle *)shaderStage.shaderModule;
                             if (shaderModuleHandle != nullptr) {
                                 ShaderModuleWrapper *shaderModuleWrapper =
                                     libraries.get(*shaderModuleHandle);
@@ -1775,26 +3347,10 @@ FvResult MetalWrapper::graphicsPipelineCreate(
                         fragmentArguments.push_back(fragmentArgument);
                     }
 
-                    // Loop through the shader modules, get their intermediate
-                    // Metal objects and provide them with reflection
-                    // information
-                    for (uint32_t iShaderModule = 0;
-                         iShaderModule < createInfo->stageCount;
-                         ++iShaderModule) {
-                        Handle *shaderModuleHandle =
-                            (Handle *)createInfo->stages[iShaderModule]
-                                .shaderModule;
-
-                        ShaderModuleWrapper *shaderModuleWrapper =
-                            libraries.get(*shaderModuleHandle);
-
-                        if (shaderModuleWrapper != nullptr) {
-                            shaderModuleWrapper->vertexArgumentReflection =
-                                vertexArguments;
-                            shaderModuleWrapper->fragmentArgumentReflection =
-                                fragmentArguments;
-                        }
-                    }
+                    // Handed to the shader modules once the pipeline is
+                    // added, as other pipelines may be built meanwhile
+                    built->vertexArguments   = std::move(vertexArguments);
+                    built->fragmentArguments = std::move(fragmentArguments);
 
                     FV_MTL_RELEASE(mtlVertexDescriptor);
 
@@ -1969,17 +3525,11 @@ FvResult MetalWrapper::graphicsPipelineCreate(
             }
 
             if (result == FV_RESULT_SUCCESS) {
-                // Store graphics pipeline wrapper and return handle as
-                // graphics
-                // pipeline
-                const Handle *handle =
-                    graphicsPipelines.add(graphicsPipelineWrapper);
-
-                if (handle != nullptr) {
-                    *graphicsPipeline = (FvGraphicsPipeline)handle;
-                } else {
-                    result = FV_RESULT_FAILURE;
-                }
+                built->pipeline = graphicsPipelineWrapper;
+            } else {
+                // Release whichever states were created
+                FV_MTL_RELEASE(graphicsPipelineWrapper.depthStencilState);
+                FV_MTL_RELEASE(graphicsPipelineWrapper.renderPipelineState);
             }
         }
 
@@ -1989,9 +3539,11 @@ FvResult MetalWrapper::graphicsPipelineCreate(
 
 void MetalWrapper::graphicsPipelineDestroy(
     FvGraphicsPipeline graphicsPipeline) {
-    const Handle *handle = (const Handle *)graphicsPipeline;
+    const ObjectHandle *handle = (const ObjectHandle *)graphicsPipeline;
 
     if (handle != nullptr) {
+        std::lock_guard<std::mutex> lock(objectMutex);
+
         GraphicsPipelineWrapper *pipeline = graphicsPipelines.get(*handle);
 
         // Destroy pipeline
@@ -2124,7 +3676,7 @@ MetalWrapper::renderPassCreate(FvRenderPass *renderPass,
         }
 
         // Store render pass wrapper and return handle as render pass
-        const Handle *handle = renderPasses.add(renderPassWrapper);
+        const ObjectHandle *handle = addObject(renderPasses, renderPassWrapper);
 
         if (handle != nullptr) {
             *renderPass = (FvRenderPass)handle;
@@ -2137,7 +3689,7 @@ MetalWrapper::renderPassCreate(FvRenderPass *renderPass,
 }
 
 void MetalWrapper::renderPassDestroy(FvRenderPass renderPass) {
-    const Handle *handle = (const Handle *)renderPass;
+    const ObjectHandle *handle = (const ObjectHandle *)renderPass;
 
     if (handle != nullptr) {
         // Get render pass
@@ -2163,11 +3715,45 @@ void MetalWrapper::renderPassDestroy(FvRenderPass renderPass) {
 
 FvResult MetalWrapper::pipelineLayoutCreate(
     FvPipelineLayout *layout, const FvPipelineLayoutCreateInfo *createInfo) {
-    // TODO: Unused at this point
+    if (layout == nullptr || createInfo == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    PipelineLayoutWrapper layoutWrapper;
+
+    // Push constants are stored inline in command buffers, so they are
+    // limited in size
+    for (uint32_t i = 0; i < createInfo->pushConstantRangeCount; ++i) {
+        const FvPushConstantRange &range = createInfo->pushConstantRanges[i];
+
+        if (range.size == 0 || range.offset % 4 != 0 || range.size % 4 != 0 ||
+            range.offset > FV_MAX_PUSH_CONSTANTS_SIZE ||
+            range.size > FV_MAX_PUSH_CONSTANTS_SIZE - range.offset) {
+            return FV_RESULT_FAILURE;
+        }
+
+        layoutWrapper.pushConstantRanges.push_back(range);
+    }
+
+    // Store pipeline layout and return handle
+    const ObjectHandle *handle = addObject(pipelineLayouts, layoutWrapper);
+
+    if (handle == nullptr) {
+        return FV_RESULT_FAILURE;
+    }
+
+    *layout = (FvPipelineLayout)handle;
+
     return FV_RESULT_SUCCESS;
 }
 
-void MetalWrapper::pipelineLayoutDestroy(FvPipelineLayout layout) {}
+void MetalWrapper::pipelineLayoutDestroy(FvPipelineLayout layout) {
+    const ObjectHandle *handle = (const ObjectHandle *)layout;
+
+    if (handle != nullptr) {
+        pipelineLayouts.remove(*handle);
+    }
+}
 
 FvResult
 MetalWrapper::shaderModuleCreate(FvShaderModule *shaderModule,
@@ -2187,7 +3773,8 @@ MetalWrapper::shaderModuleCreate(FvShaderModule *shaderModule,
         shaderModuleWrapper.library = library;
 
         if (error == nil) {
-            const Handle *handle = libraries.add(shaderModuleWrapper);
+            const ObjectHandle *handle =
+                addObject(libraries, shaderModuleWrapper);
 
             if (handle != nullptr) {
                 *shaderModule = (FvShaderModule)handle;
@@ -2216,7 +3803,7 @@ FvResult MetalWrapper::shaderModuleGetBindingPoint(
         return FV_RESULT_FAILURE;
     }
 
-    Handle *shaderModuleHandle = (Handle *)request->shaderModule;
+    ObjectHandle *shaderModuleHandle = (ObjectHandle *)request->shaderModule;
 
     if (shaderModuleHandle == nullptr) {
         return FV_RESULT_FAILURE;
@@ -2260,7 +3847,7 @@ FvResult MetalWrapper::shaderModuleGetBindingPoint(
 }
 
 void MetalWrapper::shaderModuleDestroy(FvShaderModule shaderModule) {
-    const Handle *handle = (const Handle *)shaderModule;
+    const ObjectHandle *handle = (const ObjectHandle *)shaderModule;
 
     if (handle != nullptr) {
         // Destroy library
@@ -7,15 +7,8 @@
 #include <Fever/Handle.h>
 
 namespace fv {
-unsigned int Handle::getIndex() const {
-    // Bitwise AND id with index mask to get index bits only
-    return (id & HANDLE_INDEX_MASK);
-}
-
-unsigned int Handle::getGeneration() const {
-    // Bitwise AND id with gen mask to get gen bits only
-    return (id & HANDLE_GENERATION_MASK) >> HANDLE_INDEX_BITS;
-}
-
-bool Handle::operator==(const Handle &other) const { return (id == other.id); }
+// Instantiate the standard layouts so mistakes in them are caught when the
+// library itself is built.
+template class BasicHandle<uint32_t, 24>;
+template class BasicHandle<uint64_t, 32>;
 }
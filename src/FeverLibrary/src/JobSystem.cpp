@@ -0,0 +1,263 @@
+#include <Fever/JobSystem.h>
+
+namespace fv {
+struct Job {
+    JobSystem::Function function;
+    JobCounter *counter;
+};
+
+struct JobSystem::Worker {
+    JobSystem *system;
+    uint32_t index;
+    WorkStealingDeque<Job *> deque;
+    std::thread thread;
+};
+
+namespace {
+// Times an idle worker looks for jobs before going to sleep
+const uint32_t IDLE_SPINS = 64;
+}
+
+thread_local JobSystem::Worker *JobSystem::currentWorker = nullptr;
+
+JobSystem::JobSystem(uint32_t numWorkers)
+    : injectedCount(0), sleepers(0), wakeups(0), stopping(false) {
+    for (uint32_t i = 0; i < numWorkers; ++i) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->system = this;
+        worker->index  = i;
+        workers.push_back(std::move(worker));
+    }
+
+    // Start the threads once every deque exists, as they steal from each other
+    for (const std::unique_ptr<Worker> &worker : workers) {
+        worker->thread =
+            std::thread(&JobSystem::workerMain, this, worker.get());
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (const std::unique_ptr<Worker> &worker : workers) {
+        worker->thread.join();
+    }
+
+    Job *job = nullptr;
+    while ((job = findJob(nullptr)) != nullptr) {
+        delete job;
+    }
+}
+
+uint32_t JobSystem::getDefaultNumWorkers() {
+    const uint32_t numThreads = std::thread::hardware_concurrency();
+
+    return numThreads > 1 ? numThreads - 1 : 0;
+}
+
+void JobSystem::run(Function function, JobCounter *counter) {
+    Job *job = new Job{std::move(function), counter};
+
+    if (counter != nullptr) {
+        counter->count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    schedule(job);
+}
+
+void JobSystem::runAfter(JobCounter &dependency, Function function,
+                         JobCounter *counter) {
+    Job *job = new Job{std::move(function), counter};
+
+    if (counter != nullptr) {
+        counter->count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+
+        if (dependency.count.load(std::memory_order_acquire) != 0) {
+            dependency.waiting.push_back(job);
+            return;
+        }
+    }
+
+    schedule(job);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    Worker *self = getCurrentWorker();
+
+    while (!counter.isDone()) {
+        Job *job = findJob(self);
+
+        if (job != nullptr) {
+            execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // The job that lowered the counter to zero may still be releasing the
+    // jobs waiting for it, let it finish before the counter can go away
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::schedule(Job *job) {
+    Worker *self = getCurrentWorker();
+
+    if (self != nullptr) {
+        self->deque.push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(job);
+        injectedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Pairs with the fence in 'workerMain', so either a worker going to sleep
+    // sees the job or this sees the worker asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleepers.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            ++wakeups;
+        }
+        wakeCondition.notify_one();
+    }
+}
+
+Job *JobSystem::findJob(Worker *self) {
+    Job *job = nullptr;
+
+    if (self != nullptr && self->deque.pop(&job)) {
+        return job;
+    }
+
+    if (injectedCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+
+        if (!injected.empty()) {
+            job = injected.front();
+            injected.pop_front();
+            injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // Start after the worker itself, so thieves spread over the victims
+    const size_t numWorkers = workers.size();
+    const size_t start      = self != nullptr ? self->index + 1 : 0;
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        Worker *victim = workers[(start + i) % numWorkers].get();
+
+        if (victim != self && victim->deque.steal(&job)) {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::hasReadyJobs() const {
+    if (injectedCount.load(std::memory_order_relaxed) > 0) {
+        return true;
+    }
+
+    for (const std::unique_ptr<Worker> &worker : workers) {
+        if (!worker->deque.empty()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job *job) {
+    job->function();
+
+    JobCounter *counter = job->counter;
+    delete job;
+
+    if (counter == nullptr) {
+        return;
+    }
+
+    // Lower the counter without the lock unless it may reach zero
+    uint32_t count = counter->count.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (counter->count.compare_exchange_weak(count, count - 1,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    std::vector<Job *> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+
+        if (counter->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter->waiting);
+        }
+    }
+
+    for (Job *waiter : ready) {
+        schedule(waiter);
+    }
+}
+
+JobSystem::Worker *JobSystem::getCurrentWorker() const {
+    if (currentWorker != nullptr && currentWorker->system == this) {
+        return currentWorker;
+    }
+
+    return nullptr;
+}
+
+void JobSystem::workerMain(Worker *self) {
+    currentWorker = self;
+
+    uint32_t idleSpins = 0;
+
+    for (;;) {
+        Job *job = findJob(self);
+
+        if (job != nullptr) {
+            execute(job);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (++idleSpins < IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleSpins = 0;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+
+        if (stopping) {
+            return;
+        }
+
+        sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!hasReadyJobs()) {
+            wakeCondition.wait(
+                lock, [this]() { return stopping || wakeups > 0; });
+        }
+
+        if (wakeups > 0) {
+            --wakeups;
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include <Fever/RenderQueue.h>
+
+namespace fv {
+namespace {
+/**
+ * Truncate a value to the given number of bits and move it into place.
+ */
+uint64_t keyField(uint64_t value, uint32_t bits, uint32_t shift) {
+    return (value & ((1ull << bits) - 1)) << shift;
+}
+}
+
+uint64_t RenderQueue::makeSortKey(uint32_t pipeline, uint32_t descriptorSet,
+                                  uint32_t vertexBuffer, float depth) {
+    static_assert(PIPELINE_BITS + DESCRIPTOR_SET_BITS + VERTEX_BUFFER_BITS +
+                          DEPTH_BITS ==
+                      64,
+                  "Sort key parts don't add up to 64 bits.");
+
+    const uint32_t depthShift        = 0;
+    const uint32_t vertexBufferShift = depthShift + DEPTH_BITS;
+    const uint32_t descriptorShift   = vertexBufferShift + VERTEX_BUFFER_BITS;
+    const uint32_t pipelineShift     = descriptorShift + DESCRIPTOR_SET_BITS;
+
+    // Written so NaN clamps to 0
+    if (!(depth > 0.0f)) {
+        depth = 0.0f;
+    } else if (depth > 1.0f) {
+        depth = 1.0f;
+    }
+
+    const uint64_t maxDepth = (1ull << DEPTH_BITS) - 1;
+    const uint64_t depthKey = (uint64_t)(depth * maxDepth);
+
+    return keyField(pipeline, PIPELINE_BITS, pipelineShift) |
+           keyField(descriptorSet, DESCRIPTOR_SET_BITS, descriptorShift) |
+           keyField(vertexBuffer, VERTEX_BUFFER_BITS, vertexBufferShift) |
+           keyField(depthKey, DEPTH_BITS, depthShift);
+}
+
+void RenderQueue::reserve(size_t count) {
+    items.reserve(count);
+    entries.reserve(count);
+    scratch.reserve(count);
+}
+
+void RenderQueue::add(uint64_t key, const DrawItem &item) {
+    assert(items.size() < UINT32_MAX && "Too many draws in render queue.");
+
+    SortEntry entry;
+    entry.key  = key;
+    entry.item = (uint32_t)items.size();
+
+    items.push_back(item);
+    entries.push_back(entry);
+}
+
+void RenderQueue::sort() {
+    // 11 bit digits sort 64 bit keys in 6 passes, with histograms small
+    // enough to stay in cache
+    static const uint32_t RADIX_BITS  = 11;
+    static const uint32_t NUM_BUCKETS = 1 << RADIX_BITS;
+    static const uint32_t NUM_PASSES  = (64 + RADIX_BITS - 1) / RADIX_BITS;
+
+    // Below this the histograms cost more than a comparison sort
+    static const size_t MIN_RADIX_SORT_SIZE = 2048;
+
+    const size_t count = entries.size();
+
+    if (count < MIN_RADIX_SORT_SIZE) {
+        // Items are numbered in the order they were added, so breaking ties
+        // by item is as stable as the radix sort, without std::stable_sort's
+        // temporary buffer
+        std::sort(entries.begin(), entries.end(),
+                  [](const SortEntry &a, const SortEntry &b) {
+                      return a.key < b.key ||
+                             (a.key == b.key && a.item < b.item);
+                  });
+        return;
+    }
+
+    scratch.resize(count);
+
+    // Count the digits of every pass in a single walk over the keys
+    histograms.assign(NUM_PASSES * NUM_BUCKETS, 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t key = entries[i].key;
+
+        for (uint32_t pass = 0; pass < NUM_PASSES; ++pass) {
+            const uint32_t digit =
+                (key >> (pass * RADIX_BITS)) & (NUM_BUCKETS - 1);
+            ++histograms[pass * NUM_BUCKETS + digit];
+        }
+    }
+
+    SortEntry *source      = entries.data();
+    SortEntry *destination = scratch.data();
+
+    for (uint32_t pass = 0; pass < NUM_PASSES; ++pass) {
+        const uint32_t shift = pass * RADIX_BITS;
+        uint32_t *histogram  = &histograms[pass * NUM_BUCKETS];
+
+        // All keys share this digit, e.g. the high bits when only a few
+        // pipelines are in use, so the pass wouldn't move anything
+        if (histogram[(source[0].key >> shift) & (NUM_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        // Turn the counts into the position of each bucket's first entry
+        uint32_t position = 0;
+        for (uint32_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+            const uint32_t bucketCount = histogram[bucket];
+            histogram[bucket]          = position;
+            position += bucketCount;
+        }
+
+        // Scatter in order, which keeps equal digits in their previous order
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t digit =
+                (source[i].key >> shift) & (NUM_BUCKETS - 1);
+            destination[histogram[digit]++] = source[i];
+        }
+
+        std::swap(source, destination);
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer
+    if (source != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+void RenderQueue::clear() {
+    items.clear();
+    entries.clear();
+}
+}
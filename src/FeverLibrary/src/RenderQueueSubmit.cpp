@@ -0,0 +1,60 @@
+#include <Fever/RenderQueue.h>
+
+// Kept apart from RenderQueue.cpp as it records through the Fever API, so it
+// is only built along with a backend.
+
+namespace fv {
+void RenderQueue::submit(FvCommandBuffer commandBuffer) const {
+    // Nothing is bound at the start of the render pass
+    FvGraphicsPipeline graphicsPipeline = FV_NULL_HANDLE;
+    FvDescriptorSet descriptorSet       = FV_NULL_HANDLE;
+    FvBuffer vertexBuffer               = FV_NULL_HANDLE;
+    FvSize vertexBufferOffset           = 0;
+    FvBuffer indexBuffer                = FV_NULL_HANDLE;
+    FvSize indexBufferOffset            = 0;
+    FvIndexType indexType               = FV_INDEX_TYPE_UINT16;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const DrawItem &item = getSorted(i);
+
+        if (item.graphicsPipeline != graphicsPipeline) {
+            fvCmdBindGraphicsPipeline(commandBuffer, item.graphicsPipeline);
+            graphicsPipeline = item.graphicsPipeline;
+        }
+
+        if (item.descriptorSet != FV_NULL_HANDLE &&
+            item.descriptorSet != descriptorSet) {
+            fvCmdBindDescriptorSets(commandBuffer, item.pipelineLayout, 0, 1,
+                                    &item.descriptorSet, 0, nullptr);
+            descriptorSet = item.descriptorSet;
+        }
+
+        if (item.vertexBuffer != vertexBuffer ||
+            item.vertexBufferOffset != vertexBufferOffset) {
+            fvCmdBindVertexBuffers(commandBuffer, 0, 1, &item.vertexBuffer,
+                                   &item.vertexBufferOffset);
+            vertexBuffer       = item.vertexBuffer;
+            vertexBufferOffset = item.vertexBufferOffset;
+        }
+
+        if (item.indexBuffer == FV_NULL_HANDLE) {
+            fvCmdDraw(commandBuffer, item.count, item.instanceCount,
+                      item.first, item.firstInstance);
+            continue;
+        }
+
+        if (item.indexBuffer != indexBuffer ||
+            item.indexBufferOffset != indexBufferOffset ||
+            item.indexType != indexType) {
+            fvCmdBindIndexBuffer(commandBuffer, item.indexBuffer,
+                                 item.indexBufferOffset, item.indexType);
+            indexBuffer       = item.indexBuffer;
+            indexBufferOffset = item.indexBufferOffset;
+            indexType         = item.indexType;
+        }
+
+        fvCmdDrawIndexed(commandBuffer, item.count, item.instanceCount,
+                         item.first, item.vertexOffset, item.firstInstance);
+    }
+}
+}
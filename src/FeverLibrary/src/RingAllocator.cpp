@@ -0,0 +1,37 @@
+#include <cassert>
+
+#include <Fever/RingAllocator.h>
+
+namespace fv {
+RingAllocator::RingAllocator(FvSize size, uint32_t numRegions,
+                             FvSize alignment)
+    : numRegions(numRegions), alignment(alignment), regionBegin(0),
+      cursor(0) {
+    assert(numRegions > 0 && "Need at least one region.");
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0 &&
+           "Alignment must be a power of two.");
+
+    // Keep every region starting on an aligned offset
+    regionSize = (size / numRegions) & ~(alignment - 1);
+}
+
+void RingAllocator::beginFrame(uint32_t regionIndex) {
+    regionBegin = (regionIndex % numRegions) * regionSize;
+    cursor      = regionBegin;
+}
+
+bool RingAllocator::allocate(FvSize size, FvSize *offset) {
+    const FvSize regionEnd = regionBegin + regionSize;
+    const FvSize aligned   = (cursor + alignment - 1) & ~(alignment - 1);
+
+    // Compared this way round so huge sizes can't overflow
+    if (aligned > regionEnd || size > regionEnd - aligned) {
+        return false;
+    }
+
+    *offset = aligned;
+    cursor  = aligned + size;
+
+    return true;
+}
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+
+#include <Fever/SerialTracker.h>
+
+namespace fv {
+void SerialTracker::complete(uint64_t serial) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        uint64_t last = completed.load(std::memory_order_relaxed);
+
+        // An earlier submission is still running, wait for it to fill the gap
+        if (serial > last + 1) {
+            pending.insert(
+                std::lower_bound(pending.begin(), pending.end(), serial),
+                serial);
+            return;
+        }
+
+        if (serial <= last) {
+            return;
+        }
+
+        // Move over the serials that completed ahead of this one
+        last = serial;
+
+        std::vector<uint64_t>::iterator it = pending.begin();
+        while (it != pending.end() && *it == last + 1) {
+            ++last;
+            ++it;
+        }
+        pending.erase(pending.begin(), it);
+
+        completed.store(last, std::memory_order_release);
+    }
+
+    condition.notify_all();
+}
+
+void SerialTracker::wait(uint64_t serial) const {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this, serial]() {
+        return completed.load(std::memory_order_relaxed) >= serial;
+    });
+}
+}
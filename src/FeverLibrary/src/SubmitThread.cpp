@@ -0,0 +1,152 @@
+#include <algorithm>
+
+#include <Fever/SubmitThread.h>
+
+namespace fv {
+namespace {
+// Append an array to the storage and return the copy, or nullptr for none
+template <typename T>
+const T *copyArray(std::vector<T> &storage, size_t &used, const T *array,
+                   uint32_t count) {
+    if (array == nullptr) {
+        return nullptr;
+    }
+
+    T *copy = storage.data() + used;
+    std::copy(array, array + count, copy);
+    used += count;
+
+    return copy;
+}
+}
+
+void SubmitBatch::assign(uint32_t submissionsCount,
+                         const FvSubmitInfo *submissions,
+                         std::shared_ptr<Fence> fence, uint64_t firstSerial) {
+    this->submissions.assign(submissions, submissions + submissionsCount);
+    this->fence       = std::move(fence);
+    this->firstSerial = firstSerial;
+
+    // Size the storage first, so the copies don't move as they are made
+    size_t numSemaphores     = 0;
+    size_t numValues         = 0;
+    size_t numCommandBuffers = 0;
+
+    for (const FvSubmitInfo &submission : this->submissions) {
+        numSemaphores +=
+            submission.waitSemaphoreCount + submission.signalSemaphoreCount;
+        numCommandBuffers += submission.commandBufferCount;
+
+        if (submission.waitSemaphoreValues != nullptr) {
+            numValues += submission.waitSemaphoreCount;
+        }
+        if (submission.signalSemaphoreValues != nullptr) {
+            numValues += submission.signalSemaphoreCount;
+        }
+    }
+
+    semaphores.resize(numSemaphores);
+    values.resize(numValues);
+    commandBuffers.resize(numCommandBuffers);
+
+    size_t usedSemaphores     = 0;
+    size_t usedValues         = 0;
+    size_t usedCommandBuffers = 0;
+
+    for (FvSubmitInfo &submission : this->submissions) {
+        submission.waitSemaphores =
+            copyArray(semaphores, usedSemaphores, submission.waitSemaphores,
+                      submission.waitSemaphoreCount);
+        submission.waitSemaphoreValues =
+            copyArray(values, usedValues, submission.waitSemaphoreValues,
+                      submission.waitSemaphoreCount);
+        submission.commandBuffers = copyArray(
+            commandBuffers, usedCommandBuffers, submission.commandBuffers,
+            submission.commandBufferCount);
+        submission.signalSemaphores =
+            copyArray(semaphores, usedSemaphores, submission.signalSemaphores,
+                      submission.signalSemaphoreCount);
+        submission.signalSemaphoreValues =
+            copyArray(values, usedValues, submission.signalSemaphoreValues,
+                      submission.signalSemaphoreCount);
+    }
+}
+
+SubmitThread::SubmitThread(Submit submit, size_t capacity)
+    : ring(capacity), submit(std::move(submit)), pushedCount(0),
+      submittedCount(0), sleeping(false), stopping(false) {
+    thread = std::thread(&SubmitThread::run, this);
+}
+
+SubmitThread::~SubmitThread() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+
+    thread.join();
+}
+
+void SubmitThread::push(uint32_t submissionsCount,
+                        const FvSubmitInfo *submissions,
+                        std::shared_ptr<Fence> fence, uint64_t firstSerial) {
+    // Counted up front so a flush covers it even while the slot is filled
+    pushedCount.fetch_add(1, std::memory_order_relaxed);
+
+    const auto fill = [&](SubmitBatch &batch) {
+        batch.assign(submissionsCount, submissions, fence, firstSerial);
+    };
+
+    while (!ring.tryPush(fill)) {
+        std::this_thread::yield();
+    }
+
+    // Pairs with the fence in 'run', so either the submit thread sees the
+    // batch before sleeping or this sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (sleeping.load(std::memory_order_relaxed)) {
+        // Taking the lock orders the push before the submit thread's check
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wakeCondition.notify_one();
+    }
+}
+
+void SubmitThread::flush() {
+    const uint64_t target = pushedCount.load(std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    flushCondition.wait(lock,
+                        [this, target]() { return submittedCount >= target; });
+}
+
+void SubmitThread::run() {
+    const auto consume = [this](SubmitBatch &batch) { submit(batch); };
+
+    for (;;) {
+        while (ring.tryPop(consume)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++submittedCount;
+            }
+            flushCondition.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        wakeCondition.wait(lock,
+                           [this]() { return stopping || !ring.empty(); });
+        sleeping.store(false, std::memory_order_relaxed);
+
+        if (stopping && ring.empty()) {
+            return;
+        }
+    }
+}
+}
@@ -0,0 +1,85 @@
+#include <chrono>
+#include <utility>
+
+#include <Fever/TimelineSemaphore.h>
+
+namespace fv {
+uint64_t TimelineSemaphore::getValue() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return value;
+}
+
+bool TimelineSemaphore::signal(uint64_t newValue) {
+    std::vector<Callback> ready;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (newValue <= value) {
+            return false;
+        }
+
+        value = newValue;
+
+        // Take out the callbacks this value satisfies, keeping the rest in
+        // the order they were added
+        size_t kept = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (pending[i].value <= value) {
+                ready.push_back(std::move(pending[i].callback));
+            } else {
+                pending[kept++] = std::move(pending[i]);
+            }
+        }
+        pending.resize(kept);
+    }
+
+    condition.notify_all();
+
+    // Outside the lock, callbacks may use the semaphore themselves
+    for (size_t i = 0; i < ready.size(); ++i) {
+        ready[i]();
+    }
+
+    return true;
+}
+
+bool TimelineSemaphore::wait(uint64_t waitValue, uint64_t timeout) const {
+    // Longer than any wait could last, and would overflow the clock
+    static const uint64_t MAX_TIMEOUT = 1ull << 62;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    const auto reached = [this, waitValue]() { return value >= waitValue; };
+
+    if (timeout >= MAX_TIMEOUT) {
+        condition.wait(lock, reached);
+        return true;
+    }
+
+    return condition.wait_for(lock, std::chrono::nanoseconds(timeout),
+                              reached);
+}
+
+void TimelineSemaphore::whenReached(uint64_t waitValue, Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (value < waitValue) {
+            PendingCallback entry;
+            entry.value    = waitValue;
+            entry.callback = std::move(callback);
+
+            pending.push_back(std::move(entry));
+            return;
+        }
+    }
+
+    callback();
+}
+
+size_t TimelineSemaphore::getNumPendingCallbacks() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+}
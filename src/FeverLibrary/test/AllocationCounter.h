@@ -0,0 +1,93 @@
+// Counts heap allocations made through the global operator new, so tests can
+// check that code under test does not touch the heap.
+//
+// Replaces the global allocation functions, include from exactly one
+// translation unit.
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<size_t> numAllocations(0);
+}
+
+// Kept out of line so GCC never pairs an inlined malloc or free with a new or
+// delete expression in the caller and reports a mismatch
+#if defined(__GNUC__)
+#define FV_ALLOCATION_NOINLINE __attribute__((noinline))
+#else
+#define FV_ALLOCATION_NOINLINE
+#endif
+
+FV_ALLOCATION_NOINLINE void *operator new(size_t size) {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+FV_ALLOCATION_NOINLINE void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+// The nothrow forms are counted too, e.g. std::stable_sort's buffer
+FV_ALLOCATION_NOINLINE void *operator new(size_t size,
+                                          const std::nothrow_t &) noexcept {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+FV_ALLOCATION_NOINLINE void *operator new[](size_t size,
+                                            const std::nothrow_t &) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+// Every form of delete is replaced, so none of them reaches a default one
+// that does not match the malloc above
+FV_ALLOCATION_NOINLINE void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+FV_ALLOCATION_NOINLINE void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+FV_ALLOCATION_NOINLINE void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+FV_ALLOCATION_NOINLINE void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+FV_ALLOCATION_NOINLINE void operator delete(void *ptr,
+                                            const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+FV_ALLOCATION_NOINLINE void operator delete[](void *ptr,
+                                              const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+/**
+ * Counts the allocations made between its construction and a call to
+ * 'count'.
+ */
+class AllocationCounter {
+  public:
+    AllocationCounter()
+        : start(numAllocations.load(std::memory_order_relaxed)) {}
+
+    size_t count() const {
+        return numAllocations.load(std::memory_order_relaxed) - start;
+    }
+
+  private:
+    size_t start;
+};
@@ -0,0 +1,102 @@
+#include <Fever/BindingCache.h>
+
+// Test that binding the same pipeline twice in a row is elided
+TEST(BindingCache, GraphicsPipeline) {
+    fv::BindingCache cache;
+
+    EXPECT_TRUE(cache.bindGraphicsPipeline(fakeHandle<FvGraphicsPipeline>(1)));
+    EXPECT_FALSE(cache.bindGraphicsPipeline(fakeHandle<FvGraphicsPipeline>(1)));
+    EXPECT_TRUE(cache.bindGraphicsPipeline(fakeHandle<FvGraphicsPipeline>(2)));
+    EXPECT_TRUE(cache.bindGraphicsPipeline(fakeHandle<FvGraphicsPipeline>(1)));
+
+    EXPECT_EQ(4, cache.getNumBinds());
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+}
+
+// Test that vertex buffers are tracked per binding, with their offsets
+TEST(BindingCache, VertexBuffers) {
+    fv::BindingCache cache;
+    FvBuffer a = fakeHandle<FvBuffer>(1);
+    FvBuffer b = fakeHandle<FvBuffer>(2);
+
+    EXPECT_TRUE(cache.bindVertexBuffer(0, a, 0));
+    EXPECT_TRUE(cache.bindVertexBuffer(1, b, 0));
+    EXPECT_FALSE(cache.bindVertexBuffer(0, a, 0));
+    EXPECT_FALSE(cache.bindVertexBuffer(1, b, 0));
+
+    // Same buffer, different offset or binding
+    EXPECT_TRUE(cache.bindVertexBuffer(0, a, 64));
+    EXPECT_TRUE(cache.bindVertexBuffer(1, a, 64));
+    EXPECT_FALSE(cache.bindVertexBuffer(1, a, 64));
+
+    // Bindings past the tracked ones are always recorded
+    const uint32_t untracked = fv::BindingCache::MAX_VERTEX_BUFFERS;
+    EXPECT_TRUE(cache.bindVertexBuffer(untracked, a, 0));
+    EXPECT_TRUE(cache.bindVertexBuffer(untracked, a, 0));
+
+    EXPECT_EQ(9, cache.getNumBinds());
+    EXPECT_EQ(3, cache.getNumElidedBinds());
+}
+
+// Test that the index buffer, its offset and index type all count
+TEST(BindingCache, IndexBuffer) {
+    fv::BindingCache cache;
+    FvBuffer a = fakeHandle<FvBuffer>(1);
+
+    EXPECT_TRUE(cache.bindIndexBuffer(a, 0, FV_INDEX_TYPE_UINT16));
+    EXPECT_FALSE(cache.bindIndexBuffer(a, 0, FV_INDEX_TYPE_UINT16));
+    EXPECT_TRUE(cache.bindIndexBuffer(a, 0, FV_INDEX_TYPE_UINT32));
+    EXPECT_TRUE(cache.bindIndexBuffer(a, 4, FV_INDEX_TYPE_UINT32));
+    EXPECT_TRUE(cache.bindIndexBuffer(fakeHandle<FvBuffer>(2), 4,
+                                      FV_INDEX_TYPE_UINT32));
+
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+}
+
+// Test that descriptor sets are tracked per set
+TEST(BindingCache, DescriptorSets) {
+    fv::BindingCache cache;
+    FvDescriptorSet a = fakeHandle<FvDescriptorSet>(1);
+    FvDescriptorSet b = fakeHandle<FvDescriptorSet>(2);
+
+    EXPECT_TRUE(cache.bindDescriptorSet(0, a));
+    EXPECT_TRUE(cache.bindDescriptorSet(1, b));
+    EXPECT_FALSE(cache.bindDescriptorSet(0, a));
+    EXPECT_TRUE(cache.bindDescriptorSet(0, b));
+
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+}
+
+// Test that descriptor sets bound with dynamic offsets are never elided, as
+// the offsets may have changed
+TEST(BindingCache, DescriptorSetsWithDynamicOffsets) {
+    fv::BindingCache cache;
+    FvDescriptorSet a = fakeHandle<FvDescriptorSet>(1);
+
+    EXPECT_TRUE(cache.bindDescriptorSet(0, a, true));
+    EXPECT_TRUE(cache.bindDescriptorSet(0, a, true));
+    EXPECT_FALSE(cache.bindDescriptorSet(0, a));
+
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+}
+
+// Test that invalidating forgets the bindings but keeps the counts, and that
+// resetting forgets both
+TEST(BindingCache, InvalidateAndReset) {
+    fv::BindingCache cache;
+    FvGraphicsPipeline pipeline = fakeHandle<FvGraphicsPipeline>(1);
+
+    cache.bindGraphicsPipeline(pipeline);
+    cache.bindGraphicsPipeline(pipeline);
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+
+    cache.invalidate();
+    EXPECT_TRUE(cache.bindGraphicsPipeline(pipeline));
+    EXPECT_EQ(3, cache.getNumBinds());
+    EXPECT_EQ(1, cache.getNumElidedBinds());
+
+    cache.reset();
+    EXPECT_EQ(0, cache.getNumBinds());
+    EXPECT_EQ(0, cache.getNumElidedBinds());
+    EXPECT_TRUE(cache.bindGraphicsPipeline(pipeline));
+}
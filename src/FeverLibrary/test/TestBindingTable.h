@@ -0,0 +1,94 @@
+#include <Fever/BindingTable.h>
+
+namespace {
+// Stand-ins for backend objects, 0 is unbound
+typedef fv::BindingTable<uintptr_t, uintptr_t, uintptr_t> TestBindingTable;
+}
+
+// Test that slots start out unbound and keep their declared binding points
+// and stages
+TEST(BindingTable, SlotsStartUnbound) {
+    TestBindingTable table;
+    table.addBufferSlot(0, FV_SHADER_STAGE_VERTEX);
+    table.addImageSlot(1, FV_SHADER_STAGE_FRAGMENT);
+    table.addBufferSlot(2, FV_SHADER_STAGE_VERTEX | FV_SHADER_STAGE_FRAGMENT);
+
+    ASSERT_EQ(2u, table.getBuffers().size());
+    ASSERT_EQ(1u, table.getImages().size());
+
+    EXPECT_EQ(0u, table.getBuffers()[0].buffer);
+    EXPECT_EQ(0u, table.getBuffers()[0].binding);
+    EXPECT_EQ(FV_SHADER_STAGE_VERTEX, table.getBuffers()[0].stageFlags);
+    EXPECT_EQ(2u, table.getBuffers()[1].binding);
+
+    EXPECT_EQ(0u, table.getImages()[0].texture);
+    EXPECT_EQ(0u, table.getImages()[0].sampler);
+    EXPECT_EQ(1u, table.getImages()[0].binding);
+    EXPECT_EQ(FV_SHADER_STAGE_FRAGMENT, table.getImages()[0].stageFlags);
+}
+
+// Test that updates go to the slot of their binding point and kind
+TEST(BindingTable, SetByBinding) {
+    TestBindingTable table;
+    table.addBufferSlot(4, FV_SHADER_STAGE_VERTEX);
+    table.addBufferSlot(1, FV_SHADER_STAGE_VERTEX);
+    table.addImageSlot(2, FV_SHADER_STAGE_FRAGMENT);
+
+    EXPECT_TRUE(table.setBuffer(1, 10, 256));
+    EXPECT_TRUE(table.setImage(2, 20, 30));
+
+    EXPECT_EQ(0u, table.getBuffers()[0].buffer);
+    EXPECT_EQ(10u, table.getBuffers()[1].buffer);
+    EXPECT_EQ(256u, table.getBuffers()[1].offset);
+    EXPECT_EQ(20u, table.getImages()[0].texture);
+    EXPECT_EQ(30u, table.getImages()[0].sampler);
+
+    // Rebinding replaces, unbinding clears
+    EXPECT_TRUE(table.setBuffer(1, 11, 0));
+    EXPECT_EQ(11u, table.getBuffers()[1].buffer);
+    EXPECT_EQ(0u, table.getBuffers()[1].offset);
+    EXPECT_TRUE(table.setImage(2, 0, 0));
+    EXPECT_EQ(0u, table.getImages()[0].texture);
+}
+
+// Test that updates of binding points without a slot of their kind change
+// nothing
+TEST(BindingTable, SetMissingSlot) {
+    TestBindingTable table;
+    table.addBufferSlot(0, FV_SHADER_STAGE_VERTEX);
+    table.addImageSlot(1, FV_SHADER_STAGE_FRAGMENT);
+
+    EXPECT_FALSE(table.setBuffer(1, 10, 0));
+    EXPECT_FALSE(table.setImage(0, 20, 30));
+    EXPECT_FALSE(table.setBuffer(7, 10, 0));
+
+    EXPECT_EQ(0u, table.getBuffers()[0].buffer);
+    EXPECT_EQ(0u, table.getImages()[0].texture);
+}
+
+// Test that dynamic buffer slots are counted and ranked by binding point,
+// whatever order they were added in
+TEST(BindingTable, DynamicBuffers) {
+    TestBindingTable table;
+    table.addBufferSlot(3, FV_SHADER_STAGE_VERTEX, true);
+    table.addBufferSlot(0, FV_SHADER_STAGE_VERTEX);
+    table.addBufferSlot(5, FV_SHADER_STAGE_FRAGMENT, true);
+    table.addBufferSlot(1, FV_SHADER_STAGE_VERTEX, true);
+
+    EXPECT_EQ(3u, table.getNumDynamicBuffers());
+
+    const std::vector<TestBindingTable::BufferSlot> &buffers =
+        table.getBuffers();
+    ASSERT_EQ(4u, buffers.size());
+    EXPECT_TRUE(buffers[0].dynamic);
+    EXPECT_EQ(1u, buffers[0].dynamicIndex);
+    EXPECT_FALSE(buffers[1].dynamic);
+    EXPECT_TRUE(buffers[2].dynamic);
+    EXPECT_EQ(2u, buffers[2].dynamicIndex);
+    EXPECT_TRUE(buffers[3].dynamic);
+    EXPECT_EQ(0u, buffers[3].dynamicIndex);
+
+    // Dynamic slots are written like any other, the offset being their base
+    EXPECT_TRUE(table.setBuffer(5, 10, 512));
+    EXPECT_EQ(512u, buffers[2].offset);
+}
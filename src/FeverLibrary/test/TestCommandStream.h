@@ -0,0 +1,315 @@
+#include <thread>
+
+#include <Fever/CommandStream.h>
+
+namespace {
+// Fake handles, the stream never looks behind them.
+template <typename HandleType> HandleType fakeHandle(uintptr_t value) {
+    return reinterpret_cast<HandleType>(value);
+}
+
+// Fake handles of recorded objects, the stream never looks them up.
+fv::CommandHandle fakeCommandHandle(uint64_t id) {
+    fv::CommandHandle handle;
+    handle.id = id;
+    return handle;
+}
+
+// Record 'count' draws into the stream, each with its own vertex buffer
+// binding, switching pipeline every 16 draws and alternating between indexed
+// and non-indexed draws.
+void recordDraws(fv::CommandStream &stream, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (i % 16 == 0) {
+            fv::BindGraphicsPipelineCommand *bindPipeline =
+                stream.record<fv::BindGraphicsPipelineCommand>();
+            bindPipeline->graphicsPipeline = fakeCommandHandle(i / 16 + 1);
+        }
+
+        fv::BindVertexBufferCommand *bindVertexBuffer =
+            stream.record<fv::BindVertexBufferCommand>();
+        bindVertexBuffer->binding = 0;
+        bindVertexBuffer->buffer  = fakeCommandHandle(i + 1);
+        bindVertexBuffer->offset  = (FvSize)i * 256;
+
+        if (i % 2 == 0) {
+            fv::DrawCommand *draw = stream.record<fv::DrawCommand>();
+            draw->vertexCount     = 3;
+            draw->instanceCount   = 1;
+            draw->firstVertex     = i;
+            draw->firstInstance   = 0;
+        } else {
+            fv::DrawIndexedCommand *draw =
+                stream.record<fv::DrawIndexedCommand>();
+            draw->indexCount    = 6;
+            draw->instanceCount = 2;
+            draw->firstIndex    = i;
+            draw->vertexOffset  = -(int32_t)i;
+            draw->firstInstance = 1;
+        }
+    }
+}
+
+// Decode a stream recorded by 'recordDraws', checking every command.
+void expectDraws(const fv::CommandStream &stream, uint32_t count) {
+    uint32_t draw         = 0;
+    uint64_t pipeline     = 0;
+    uint64_t vertexBuffer = 0;
+
+    for (fv::CommandStream::const_iterator it = stream.begin();
+         it != stream.end(); ++it) {
+        switch (it->type) {
+        case fv::COMMAND_TYPE_BIND_GRAPHICS_PIPELINE: {
+            const fv::BindGraphicsPipelineCommand &command =
+                it->as<fv::BindGraphicsPipelineCommand>();
+            pipeline = command.graphicsPipeline.id;
+            break;
+        }
+        case fv::COMMAND_TYPE_BIND_VERTEX_BUFFER: {
+            const fv::BindVertexBufferCommand &command =
+                it->as<fv::BindVertexBufferCommand>();
+            vertexBuffer = command.buffer.id;
+            ASSERT_EQ((FvSize)(vertexBuffer - 1) * 256, command.offset);
+            break;
+        }
+        case fv::COMMAND_TYPE_DRAW: {
+            const fv::DrawCommand &command = it->as<fv::DrawCommand>();
+            ASSERT_EQ(0, draw % 2);
+            ASSERT_EQ(draw, command.firstVertex);
+            ASSERT_EQ(3, command.vertexCount);
+            ASSERT_EQ(1, command.instanceCount);
+            ASSERT_EQ(draw / 16 + 1, pipeline);
+            ASSERT_EQ(draw + 1, vertexBuffer);
+            ++draw;
+            break;
+        }
+        case fv::COMMAND_TYPE_DRAW_INDEXED: {
+            const fv::DrawIndexedCommand &command =
+                it->as<fv::DrawIndexedCommand>();
+            ASSERT_EQ(1, draw % 2);
+            ASSERT_EQ(draw, command.firstIndex);
+            ASSERT_EQ(6, command.indexCount);
+            ASSERT_EQ(2, command.instanceCount);
+            ASSERT_EQ(-(int32_t)draw, command.vertexOffset);
+            ASSERT_EQ(1, command.firstInstance);
+            ASSERT_EQ(draw / 16 + 1, pipeline);
+            ASSERT_EQ(draw + 1, vertexBuffer);
+            ++draw;
+            break;
+        }
+        default:
+            FAIL() << "Unexpected command type " << it->type;
+        }
+    }
+
+    EXPECT_EQ(count, draw);
+}
+}
+
+// Test that an empty stream has nothing to iterate
+TEST(CommandStream, Empty) {
+    fv::CommandStream stream;
+
+    EXPECT_TRUE(stream.empty());
+    EXPECT_TRUE(stream.begin() == stream.end());
+
+    stream.reset();
+    EXPECT_TRUE(stream.begin() == stream.end());
+}
+
+// Test that 100k draws, with their binds, come back out in recording order
+TEST(CommandStream, RecordAndDecode100kDraws) {
+    const uint32_t count = 100000;
+    fv::CommandStream stream;
+
+    recordDraws(stream, count);
+
+    EXPECT_EQ(count * 2 + (count + 15) / 16, stream.size());
+    expectDraws(stream, count);
+}
+
+// Test that commands are decoded correctly across many small blocks
+TEST(CommandStream, SmallBlocks) {
+    fv::CommandStream stream(64);
+
+    recordDraws(stream, 1000);
+    expectDraws(stream, 1000);
+}
+
+// Test that re-recording after a reset reuses the memory of the previous
+// recording
+TEST(CommandStream, ResetReusesMemory) {
+    const uint32_t count = 100000;
+    fv::CommandStream stream;
+
+    recordDraws(stream, count);
+    stream.reset();
+
+    EXPECT_TRUE(stream.empty());
+    EXPECT_TRUE(stream.begin() == stream.end());
+
+    AllocationCounter allocations;
+    recordDraws(stream, count);
+    EXPECT_EQ(0, allocations.count());
+
+    expectDraws(stream, count);
+
+    // A shorter recording leaves no commands of the longer one behind
+    stream.reset();
+    recordDraws(stream, 10);
+    expectDraws(stream, 10);
+}
+
+// Test that moving a stream keeps its commands
+TEST(CommandStream, Move) {
+    fv::CommandStream stream;
+    recordDraws(stream, 100);
+
+    fv::CommandStream moved(std::move(stream));
+    expectDraws(moved, 100);
+}
+
+// Test that payloads of every size come back out with their commands, keeping
+// the commands after them aligned, including across small blocks
+TEST(CommandStream, Payloads) {
+    fv::CommandStream stream(64);
+
+    for (uint32_t size = 0; size <= 128; ++size) {
+        fv::PushConstantsCommand *command =
+            stream.record<fv::PushConstantsCommand>(size);
+        command->size = size;
+
+        uint8_t *payload = (uint8_t *)fv::getPayload(command);
+        for (uint32_t i = 0; i < size; ++i) {
+            payload[i] = (uint8_t)(size + i);
+        }
+
+        stream.record<fv::DrawCommand>()->vertexCount = size;
+    }
+
+    uint32_t size = 0;
+    for (fv::CommandStream::const_iterator it = stream.begin();
+         it != stream.end(); ++it, ++size) {
+        ASSERT_EQ(fv::COMMAND_TYPE_PUSH_CONSTANTS, it->type);
+        ASSERT_EQ(0u, it->size % fv::CommandStream::COMMAND_ALIGNMENT);
+
+        const fv::PushConstantsCommand &command =
+            it->as<fv::PushConstantsCommand>();
+        ASSERT_EQ(size, command.size);
+
+        const uint8_t *payload = (const uint8_t *)fv::getPayload(command);
+        for (uint32_t i = 0; i < size; ++i) {
+            ASSERT_EQ((uint8_t)(size + i), payload[i]);
+        }
+
+        ++it;
+        ASSERT_EQ(fv::COMMAND_TYPE_DRAW, it->type);
+        ASSERT_EQ(size, it->as<fv::DrawCommand>().vertexCount);
+    }
+    EXPECT_EQ(129u, size);
+}
+
+// Test that streams sharing a pool give their blocks back on reset, so a pool
+// of streams re-recorded every frame stops allocating
+TEST(CommandBlockPool, ResetRecyclesBlocks) {
+    fv::CommandBlockPool pool(1024);
+    fv::CommandStream first(&pool);
+    fv::CommandStream second(&pool);
+
+    recordDraws(first, 1000);
+    recordDraws(second, 500);
+    expectDraws(first, 1000);
+    expectDraws(second, 500);
+
+    const size_t numBlocks = pool.getNumBlocks();
+    EXPECT_LT(0, numBlocks);
+    EXPECT_EQ(0, pool.getNumFreeBlocks());
+
+    // Reset the whole pool's worth of streams
+    first.reset();
+    second.reset();
+    EXPECT_EQ(numBlocks, pool.getNumFreeBlocks());
+    EXPECT_TRUE(first.begin() == first.end());
+
+    // The blocks can go to either stream, the total stays the same
+    recordDraws(first, 500);
+    recordDraws(second, 1000);
+    EXPECT_EQ(numBlocks, pool.getNumBlocks());
+
+    expectDraws(first, 500);
+    expectDraws(second, 1000);
+
+    // Once every stream has seen its largest frame nothing is allocated
+    first.reset();
+    second.reset();
+
+    AllocationCounter allocations;
+    recordDraws(first, 500);
+    recordDraws(second, 1000);
+    EXPECT_EQ(0, allocations.count());
+}
+
+// Test that destroying a stream gives its blocks back to the pool
+TEST(CommandBlockPool, DestroyReleasesBlocks) {
+    fv::CommandBlockPool pool(256);
+
+    {
+        fv::CommandStream stream(&pool);
+        recordDraws(stream, 100);
+
+        fv::CommandStream moved(&pool);
+        moved = std::move(stream);
+        expectDraws(moved, 100);
+    }
+
+    EXPECT_LT(0, pool.getNumBlocks());
+    EXPECT_EQ(pool.getNumBlocks(), pool.getNumFreeBlocks());
+}
+
+// Test that secondary streams recorded on their own threads, each with its own
+// pool, can be stitched together by a primary stream
+TEST(CommandBlockPool, ParallelSecondaryRecording) {
+    const uint32_t numThreads = 4;
+    const uint32_t numDraws   = 1000;
+
+    std::vector<std::unique_ptr<fv::CommandBlockPool>> pools;
+    std::vector<fv::CommandStream> secondaries;
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        pools.push_back(std::unique_ptr<fv::CommandBlockPool>(
+            new fv::CommandBlockPool(1024)));
+        secondaries.push_back(fv::CommandStream(pools[t].get()));
+    }
+
+    // The primary refers to each secondary by handle, so it may be recorded
+    // while the secondaries are still recording
+    fv::CommandStream primary;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread(
+            [&secondaries, t]() { recordDraws(secondaries[t], numDraws); }));
+
+        fv::ExecuteCommandsCommand *execute =
+            primary.record<fv::ExecuteCommandsCommand>();
+        execute->commandBuffer = fakeCommandHandle(t + 1);
+    }
+
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    // Replay the secondaries in the order the primary executes them
+    uint32_t numExecuted = 0;
+    for (fv::CommandStream::const_iterator it = primary.begin();
+         it != primary.end(); ++it) {
+        ASSERT_EQ(fv::COMMAND_TYPE_EXECUTE_COMMANDS, it->type);
+
+        const uint64_t secondary =
+            it->as<fv::ExecuteCommandsCommand>().commandBuffer.id;
+        ASSERT_EQ(numExecuted + 1, secondary);
+
+        expectDraws(secondaries[secondary - 1], numDraws);
+        ++numExecuted;
+    }
+    EXPECT_EQ(numThreads, numExecuted);
+}
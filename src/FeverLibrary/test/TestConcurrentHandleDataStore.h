@@ -0,0 +1,218 @@
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <Fever/ConcurrentHandleDataStore.h>
+
+// Test that 'isValid' returns false with an invalid handle
+TEST(ConcurrentHandleDataStore, InvalidHandle) {
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(64);
+    fv::Handle handle;
+
+    handle.id = 0;
+
+    EXPECT_FALSE(dataStore.isValid(handle));
+    EXPECT_EQ(nullptr, dataStore.get(handle));
+}
+
+// Test that adding, getting and removing works on a single thread
+TEST(ConcurrentHandleDataStore, AddGetRemove) {
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(64);
+    fv::Handle handle;
+
+    EXPECT_TRUE(dataStore.add(7, &handle));
+    EXPECT_TRUE(dataStore.isValid(handle));
+
+    const uint32_t *object = dataStore.get(handle);
+    EXPECT_FALSE(object == nullptr);
+    EXPECT_EQ(7, *object);
+
+    dataStore.remove(handle);
+    EXPECT_FALSE(dataStore.isValid(handle));
+    EXPECT_EQ(nullptr, dataStore.get(handle));
+}
+
+// Test that a re-used index does not validate the stale handle
+TEST(ConcurrentHandleDataStore, ReusedIndexInvalidatesStaleHandle) {
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(1);
+    fv::Handle first;
+    fv::Handle second;
+
+    EXPECT_TRUE(dataStore.add(1, &first));
+    dataStore.remove(first);
+    EXPECT_TRUE(dataStore.add(2, &second));
+
+    EXPECT_EQ(first.getIndex(), second.getIndex());
+    EXPECT_FALSE(dataStore.isValid(first));
+    EXPECT_TRUE(dataStore.isValid(second));
+
+    // Removing the stale handle must not release the new object
+    dataStore.remove(first);
+    EXPECT_TRUE(dataStore.isValid(second));
+    EXPECT_EQ(2, *dataStore.get(second));
+}
+
+// Test that adding fails once the store is full
+TEST(ConcurrentHandleDataStore, CreateTooManyHandles) {
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(64);
+    fv::Handle handle;
+
+    for (uint32_t i = 0; i < 64; ++i) {
+        EXPECT_TRUE(dataStore.add(i, &handle));
+    }
+
+    EXPECT_FALSE(dataStore.add(0, &handle));
+
+    // Freeing a slot makes room again
+    dataStore.remove(handle);
+    EXPECT_TRUE(dataStore.add(0, &handle));
+}
+
+// Test that the generation wraps within its bits without touching the index
+TEST(ConcurrentHandleDataStore, GenerationWraparound) {
+    typedef fv::BasicHandle<uint32_t, 28> SmallGenerationHandle;
+    fv::ConcurrentHandleDataStore<uint32_t, SmallGenerationHandle> dataStore(
+        1);
+
+    SmallGenerationHandle first;
+    ASSERT_TRUE(dataStore.add(0, &first));
+    SmallGenerationHandle handle = first;
+
+    for (uint32_t i = 1; i <= SmallGenerationHandle::HANDLE_MAX_GENERATION;
+         ++i) {
+        dataStore.remove(handle);
+        ASSERT_TRUE(dataStore.add(i, &handle));
+
+        EXPECT_EQ(first.getIndex(), handle.getIndex());
+        EXPECT_EQ(i, handle.getGeneration());
+        EXPECT_FALSE(dataStore.isValid(first));
+    }
+
+    // One more re-use wraps the generation back to zero
+    dataStore.remove(handle);
+    ASSERT_TRUE(dataStore.add(42, &handle));
+
+    EXPECT_EQ(0, handle.getGeneration());
+    EXPECT_TRUE(handle == first);
+}
+
+// Test that a stale 64-bit handle stays invalid well past the 256 re-uses
+// that wrap a compact handle
+TEST(ConcurrentHandleDataStore, Handle64SurvivesReuse) {
+    const uint32_t numReuses = 100000;
+
+    fv::ConcurrentHandleDataStore<uint32_t, fv::Handle64> dataStore(1);
+
+    fv::Handle64 stale;
+    ASSERT_TRUE(dataStore.add(0, &stale));
+    fv::Handle64 handle = stale;
+
+    for (uint32_t i = 0; i < numReuses; ++i) {
+        dataStore.remove(handle);
+        ASSERT_TRUE(dataStore.add(1, &handle));
+
+        ASSERT_FALSE(dataStore.isValid(stale));
+    }
+
+    EXPECT_EQ(numReuses, handle.getGeneration());
+    EXPECT_EQ(1, *dataStore.get(handle));
+}
+
+// Stress test: many threads adding and removing concurrently must never hand
+// out the same live handle twice or lose track of an object.
+TEST(ConcurrentHandleDataStore, StressAddRemove) {
+    const uint32_t numThreads    = 8;
+    const uint32_t numIterations = 20000;
+    const uint32_t numHeld       = 16;
+
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(numThreads * numHeld);
+    std::vector<uint32_t> failures(numThreads, 0);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            fv::Handle held[numHeld];
+            uint32_t values[numHeld];
+
+            for (uint32_t i = 0; i < numIterations; ++i) {
+                const uint32_t slot = i % numHeld;
+
+                if (i >= numHeld) {
+                    // Object must still be ours before we release it
+                    const uint32_t *object = dataStore.get(held[slot]);
+                    if (object == nullptr || *object != values[slot]) {
+                        ++failures[t];
+                    }
+
+                    dataStore.remove(held[slot]);
+
+                    if (dataStore.isValid(held[slot])) {
+                        ++failures[t];
+                    }
+                }
+
+                values[slot] = (t << 24) | i;
+                if (!dataStore.add(values[slot], &held[slot])) {
+                    ++failures[t];
+                }
+            }
+
+            for (uint32_t i = 0; i < numHeld; ++i) {
+                dataStore.remove(held[i]);
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        EXPECT_EQ(0, failures[t]);
+    }
+
+    // Every slot must have been returned to the free list exactly once
+    std::set<uint32_t> indices;
+    std::vector<fv::Handle> handles(numThreads * numHeld);
+    for (size_t i = 0; i < handles.size(); ++i) {
+        EXPECT_TRUE(dataStore.add(0, &handles[i]));
+        indices.insert(handles[i].getIndex());
+    }
+    EXPECT_EQ(handles.size(), indices.size());
+
+    fv::Handle extra;
+    EXPECT_FALSE(dataStore.add(0, &extra));
+}
+
+// Stress test: concurrent removal of the same handle frees it only once.
+TEST(ConcurrentHandleDataStore, StressRacingRemove) {
+    const uint32_t numThreads = 8;
+    const uint32_t numRounds  = 500;
+
+    fv::ConcurrentHandleDataStore<uint32_t> dataStore(numThreads);
+
+    for (uint32_t round = 0; round < numRounds; ++round) {
+        fv::Handle handle;
+        ASSERT_TRUE(dataStore.add(round, &handle));
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < numThreads; ++t) {
+            threads.push_back(std::thread(
+                [&dataStore, handle]() { dataStore.remove(handle); }));
+        }
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+
+        EXPECT_FALSE(dataStore.isValid(handle));
+    }
+
+    // A double free would leave duplicate indices on the free list
+    std::set<uint32_t> indices;
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        fv::Handle handle;
+        EXPECT_TRUE(dataStore.add(0, &handle));
+        indices.insert(handle.getIndex());
+    }
+    EXPECT_EQ(numThreads, indices.size());
+}
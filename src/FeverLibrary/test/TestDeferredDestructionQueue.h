@@ -0,0 +1,111 @@
+#include <vector>
+
+#include <Fever/DeferredDestructionQueue.h>
+#include <Fever/SerialTracker.h>
+
+// Test that objects are only destroyed once the serial they were enqueued with
+// has completed, using a counter in place of the GPU
+TEST(DeferredDestructionQueue, WaitsForCompletedSerial) {
+    fv::DeferredDestructionQueue queue;
+    std::vector<int> destroyed;
+
+    uint64_t submittedSerial = 0;
+    uint64_t completedSerial = 0;
+
+    // Object 0 is used by submission 1, objects 1 and 2 by submission 2
+    ++submittedSerial;
+    queue.enqueue(submittedSerial, [&destroyed]() { destroyed.push_back(0); });
+    ++submittedSerial;
+    queue.enqueue(submittedSerial, [&destroyed]() { destroyed.push_back(1); });
+    queue.enqueue(submittedSerial, [&destroyed]() { destroyed.push_back(2); });
+
+    // Nothing has completed yet
+    EXPECT_EQ(0, queue.collect(completedSerial));
+    EXPECT_TRUE(destroyed.empty());
+    EXPECT_EQ(3, queue.size());
+
+    // Submission 1 completes
+    ++completedSerial;
+    EXPECT_EQ(1, queue.collect(completedSerial));
+    EXPECT_EQ(std::vector<int>({0}), destroyed);
+
+    // Collecting again at the same serial does nothing
+    EXPECT_EQ(0, queue.collect(completedSerial));
+
+    // Submission 2 completes
+    ++completedSerial;
+    EXPECT_EQ(2, queue.collect(completedSerial));
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), destroyed);
+    EXPECT_EQ(0, queue.size());
+}
+
+// Test that objects destroyed before anything was submitted go at the first
+// collect
+TEST(DeferredDestructionQueue, NothingSubmitted) {
+    fv::DeferredDestructionQueue queue;
+    int destroyed = 0;
+
+    queue.enqueue(0, [&destroyed]() { ++destroyed; });
+
+    EXPECT_EQ(1, queue.collect(0));
+    EXPECT_EQ(1, destroyed);
+}
+
+// Test that flushing and destroying the queue run everything still pending
+TEST(DeferredDestructionQueue, FlushAndDestructor) {
+    int destroyed = 0;
+
+    {
+        fv::DeferredDestructionQueue queue;
+
+        queue.enqueue(5, [&destroyed]() { ++destroyed; });
+        queue.enqueue(6, [&destroyed]() { ++destroyed; });
+
+        EXPECT_EQ(2, queue.flush());
+        EXPECT_EQ(2, destroyed);
+
+        queue.enqueue(7, [&destroyed]() { ++destroyed; });
+    }
+
+    EXPECT_EQ(3, destroyed);
+}
+
+// Test that a destroyer may enqueue further destructions while being collected
+TEST(DeferredDestructionQueue, EnqueueFromDestroyer) {
+    fv::DeferredDestructionQueue queue;
+    int destroyed = 0;
+
+    queue.enqueue(1, [&queue, &destroyed]() {
+        ++destroyed;
+        queue.enqueue(2, [&destroyed]() { ++destroyed; });
+    });
+
+    EXPECT_EQ(1, queue.collect(1));
+    EXPECT_EQ(1, destroyed);
+    EXPECT_EQ(1, queue.size());
+
+    EXPECT_EQ(1, queue.collect(2));
+    EXPECT_EQ(2, destroyed);
+}
+
+// Test that an object used by a submission still running is kept when a later
+// submission, e.g. to another queue, completes first
+TEST(DeferredDestructionQueue, OutOfOrderCompletion) {
+    fv::DeferredDestructionQueue queue;
+    fv::SerialTracker completedSerials;
+    std::vector<int> destroyed;
+
+    // Object 0 is used by the graphics submission 1, object 1 by the
+    // transfer submission 2
+    queue.enqueue(1, [&destroyed]() { destroyed.push_back(0); });
+    queue.enqueue(2, [&destroyed]() { destroyed.push_back(1); });
+
+    // The transfer finishes first
+    completedSerials.complete(2);
+    EXPECT_EQ(0, queue.collect(completedSerials.getCompleted()));
+    EXPECT_TRUE(destroyed.empty());
+
+    completedSerials.complete(1);
+    EXPECT_EQ(2, queue.collect(completedSerials.getCompleted()));
+    EXPECT_EQ(std::vector<int>({0, 1}), destroyed);
+}
@@ -0,0 +1,154 @@
+#include <Fever/BindingTable.h>
+#include <Fever/DescriptorSetBinds.h>
+
+namespace {
+// Stand-ins for backend objects, 0 is unbound
+typedef fv::BindingTable<uintptr_t, uintptr_t, uintptr_t>
+    TestDescriptorSetTable;
+
+// Resolves the fake handles 1..count to their tables, anything else is
+// invalid. The handle recorded for a fake handle is its value.
+struct ResolveTestDescriptorSet {
+    const TestDescriptorSetTable *tables;
+    uintptr_t count;
+
+    const TestDescriptorSetTable *operator()(FvDescriptorSet set,
+                                             fv::CommandHandle *handle) const {
+        const uintptr_t index = (uintptr_t)set;
+        handle->id            = index;
+        return index >= 1 && index <= count ? &tables[index - 1] : nullptr;
+    }
+};
+
+FvDescriptorSet fakeDescriptorSet(uintptr_t value) {
+    return reinterpret_cast<FvDescriptorSet>(value);
+}
+}
+
+// Test that each set is recorded with its resolved table and its slice of the
+// dynamic offsets
+TEST(DescriptorSetBinds, DynamicOffsetSlices) {
+    TestDescriptorSetTable tables[3];
+    tables[0].addBufferSlot(0, FV_SHADER_STAGE_VERTEX, true);
+    tables[0].addBufferSlot(1, FV_SHADER_STAGE_VERTEX, true);
+    tables[1].addImageSlot(0, FV_SHADER_STAGE_FRAGMENT);
+    tables[2].addBufferSlot(0, FV_SHADER_STAGE_FRAGMENT, true);
+    const ResolveTestDescriptorSet resolve = {tables, 3};
+
+    const FvDescriptorSet sets[] = {fakeDescriptorSet(1), fakeDescriptorSet(2),
+                                    fakeDescriptorSet(3)};
+    const uint32_t offsets[] = {0, FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+                                2 * FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT};
+
+    fv::CommandStream stream;
+    fv::BindingCache bindings;
+    ASSERT_TRUE(fv::recordDescriptorSetBinds(stream, bindings, 1, 3, sets, 3,
+                                             offsets, resolve));
+
+    ASSERT_EQ(3u, stream.size());
+    const uint32_t expectedCounts[] = {2, 0, 1};
+    const uint32_t *expectedOffsets = offsets;
+    uint32_t i                      = 0;
+    for (fv::CommandStream::const_iterator it = stream.begin();
+         it != stream.end(); ++it, ++i) {
+        ASSERT_EQ(fv::COMMAND_TYPE_BIND_DESCRIPTOR_SET, it->type);
+        const fv::BindDescriptorSetCommand &command =
+            it->as<fv::BindDescriptorSetCommand>();
+        EXPECT_EQ(1 + i, command.set);
+        EXPECT_EQ((uintptr_t)sets[i], command.descriptorSet.id);
+        EXPECT_EQ(&tables[i], command.resolvedSet);
+        ASSERT_EQ(expectedCounts[i], command.dynamicOffsetCount);
+
+        const uint32_t *payload =
+            reinterpret_cast<const uint32_t *>(fv::getPayload(command));
+        for (uint32_t j = 0; j < command.dynamicOffsetCount; ++j) {
+            EXPECT_EQ(expectedOffsets[j], payload[j]);
+        }
+        expectedOffsets += command.dynamicOffsetCount;
+    }
+}
+
+// Test that offsets that don't match the dynamic slots, or aren't aligned,
+// record nothing
+TEST(DescriptorSetBinds, BadOffsetsRecordNothing) {
+    TestDescriptorSetTable tables[1];
+    tables[0].addBufferSlot(0, FV_SHADER_STAGE_VERTEX, true);
+    const ResolveTestDescriptorSet resolve = {tables, 1};
+
+    const FvDescriptorSet sets[] = {fakeDescriptorSet(1)};
+    const uint32_t offsets[]     = {0, 0};
+    const uint32_t unaligned[]   = {1};
+
+    fv::CommandStream stream;
+    fv::BindingCache bindings;
+    EXPECT_FALSE(fv::recordDescriptorSetBinds(stream, bindings, 0, 1, sets, 0,
+                                              nullptr, resolve));
+    EXPECT_FALSE(fv::recordDescriptorSetBinds(stream, bindings, 0, 1, sets, 2,
+                                              offsets, resolve));
+    EXPECT_FALSE(fv::recordDescriptorSetBinds(stream, bindings, 0, 1, sets, 1,
+                                              nullptr, resolve));
+    EXPECT_FALSE(fv::recordDescriptorSetBinds(stream, bindings, 0, 1, sets, 1,
+                                              unaligned, resolve));
+    EXPECT_TRUE(stream.empty());
+    EXPECT_EQ(0u, bindings.getNumBinds());
+}
+
+// Test that rebinding a set without dynamic offsets is elided, while one with
+// dynamic offsets is always recorded, and invalid handles bind no table
+TEST(DescriptorSetBinds, ElidesRebinds) {
+    TestDescriptorSetTable tables[2];
+    tables[1].addBufferSlot(0, FV_SHADER_STAGE_VERTEX, true);
+    const ResolveTestDescriptorSet resolve = {tables, 2};
+
+    const FvDescriptorSet sets[] = {fakeDescriptorSet(1), fakeDescriptorSet(2),
+                                    fakeDescriptorSet(7)};
+    const uint32_t offsets[]     = {0};
+
+    fv::CommandStream stream;
+    fv::BindingCache bindings;
+    ASSERT_TRUE(fv::recordDescriptorSetBinds(stream, bindings, 0, 3, sets, 1,
+                                             offsets, resolve));
+    EXPECT_EQ(3u, stream.size());
+    ASSERT_TRUE(fv::recordDescriptorSetBinds(stream, bindings, 0, 3, sets, 1,
+                                             offsets, resolve));
+    EXPECT_EQ(4u, stream.size());
+
+    fv::CommandStream::const_iterator it = stream.begin();
+    ++it;
+    ++it;
+    EXPECT_EQ((uintptr_t)sets[2],
+              it->as<fv::BindDescriptorSetCommand>().descriptorSet.id);
+    EXPECT_EQ(nullptr, it->as<fv::BindDescriptorSetCommand>().resolvedSet);
+    ++it;
+    EXPECT_EQ((uintptr_t)sets[1],
+              it->as<fv::BindDescriptorSetCommand>().descriptorSet.id);
+}
+
+// Test that recording binds into a stream that has its blocks allocates
+// nothing
+TEST(DescriptorSetBinds, RecordWithoutAllocating) {
+    const uint32_t numSets = fv::BindingCache::MAX_DESCRIPTOR_SETS;
+
+    TestDescriptorSetTable tables[numSets];
+    FvDescriptorSet sets[numSets];
+    uint32_t offsets[numSets];
+    for (uint32_t i = 0; i < numSets; ++i) {
+        tables[i].addBufferSlot(0, FV_SHADER_STAGE_VERTEX, true);
+        sets[i]    = fakeDescriptorSet(i + 1);
+        offsets[i] = i * FV_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT;
+    }
+    const ResolveTestDescriptorSet resolve = {tables, numSets};
+
+    fv::CommandStream stream;
+    fv::BindingCache bindings;
+    ASSERT_TRUE(fv::recordDescriptorSetBinds(stream, bindings, 0, numSets, sets,
+                                             numSets, offsets, resolve));
+    stream.reset();
+    bindings.reset();
+
+    AllocationCounter allocations;
+    ASSERT_TRUE(fv::recordDescriptorSetBinds(stream, bindings, 0, numSets, sets,
+                                             numSets, offsets, resolve));
+    EXPECT_EQ(0, allocations.count());
+    EXPECT_EQ(numSets, stream.size());
+}
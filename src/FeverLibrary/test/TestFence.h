@@ -0,0 +1,58 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Fever/Fence.h>
+
+// Test that a fence stays signaled until it is reset
+TEST(Fence, SignalAndReset) {
+    fv::Fence fence;
+    EXPECT_FALSE(fence.isSignaled());
+    EXPECT_FALSE(fence.wait(0));
+
+    fence.signal();
+    EXPECT_TRUE(fence.isSignaled());
+    EXPECT_TRUE(fence.wait(0));
+    EXPECT_TRUE(fence.wait());
+
+    fence.reset();
+    EXPECT_FALSE(fence.isSignaled());
+
+    fv::Fence signaled(true);
+    EXPECT_TRUE(signaled.wait(0));
+}
+
+// Test that a wait on an unsignaled fence gives up after its timeout
+TEST(Fence, WaitTimesOut) {
+    fv::Fence fence;
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(fence.wait(10 * 1000 * 1000));
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(10));
+}
+
+// Test that a fence signaled on another thread wakes every waiter
+TEST(Fence, SignalWakesWaiters) {
+    fv::Fence fence;
+    std::atomic<int> woken(0);
+
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back([&]() {
+            if (fence.wait()) {
+                ++woken;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    fence.signal();
+
+    for (std::thread &waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(4, woken.load());
+}
@@ -0,0 +1,118 @@
+#include <memory>
+#include <string>
+
+#include <Fever/FixedHandleDataStore.h>
+
+// Test that 'isValid' returns false with an invalid handle
+TEST(FixedHandleDataStore, InvalidHandle) {
+    fv::FixedHandleDataStore<uint32_t, 16> dataStore;
+    fv::Handle handle;
+
+    handle.id = 0;
+
+    EXPECT_FALSE(dataStore.isValid(handle));
+    EXPECT_EQ(nullptr, dataStore.get(handle));
+
+    // Out of range index
+    handle.id = 16;
+    EXPECT_FALSE(dataStore.isValid(handle));
+}
+
+// Test that adding fails once full and that stale handles stay invalid
+TEST(FixedHandleDataStore, AddRemove) {
+    fv::FixedHandleDataStore<uint32_t, 4> dataStore;
+    fv::Handle handles[4];
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(dataStore.add(i, &handles[i]));
+    }
+    EXPECT_EQ(4, dataStore.size());
+
+    fv::Handle extra;
+    extra.id = 0;
+    EXPECT_FALSE(dataStore.add(4, &extra));
+
+    dataStore.remove(handles[2]);
+    EXPECT_FALSE(dataStore.isValid(handles[2]));
+    EXPECT_EQ(3, dataStore.size());
+
+    // The freed slot is handed out again with a new generation
+    EXPECT_TRUE(dataStore.add(5, &extra));
+    EXPECT_EQ(handles[2].getIndex(), extra.getIndex());
+    EXPECT_FALSE(dataStore.isValid(handles[2]));
+    EXPECT_EQ(5, *dataStore.get(extra));
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i != 2) {
+            EXPECT_EQ(i, *dataStore.get(handles[i]));
+        }
+    }
+}
+
+// Test that objects are destroyed on remove and by the store's destructor
+TEST(FixedHandleDataStore, DestroyOnRemove) {
+    std::shared_ptr<int> tracked(new int(0));
+
+    {
+        fv::FixedHandleDataStore<std::shared_ptr<int>, 8> dataStore;
+        fv::Handle first;
+        fv::Handle second;
+
+        EXPECT_TRUE(dataStore.add(tracked, &first));
+        EXPECT_TRUE(dataStore.emplace(&second, tracked));
+        EXPECT_EQ(3, tracked.use_count());
+
+        dataStore.remove(first);
+        EXPECT_EQ(2, tracked.use_count());
+    }
+
+    EXPECT_EQ(1, tracked.use_count());
+}
+
+// Test that nothing touches the heap once the store is constructed
+TEST(FixedHandleDataStore, NoAllocations) {
+    struct Semaphore {
+        uint64_t signalValue;
+        uint32_t flags;
+    };
+
+    std::unique_ptr<fv::FixedHandleDataStore<Semaphore, 256>> dataStore(
+        new fv::FixedHandleDataStore<Semaphore, 256>());
+    fv::Handle handles[256];
+
+    AllocationCounter allocations;
+
+    // Simulate many frames of creating and destroying transient objects
+    for (uint32_t frame = 0; frame < 100; ++frame) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            Semaphore semaphore = {frame, i};
+            ASSERT_TRUE(dataStore->add(semaphore, &handles[i]));
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            ASSERT_TRUE(dataStore->get(handles[i]) != nullptr);
+        }
+        // Remove out of order so the free list gets shuffled
+        for (uint32_t i = 0; i < 256; ++i) {
+            dataStore->remove(handles[(i * 7) % 256]);
+        }
+    }
+
+    EXPECT_EQ(0, allocations.count());
+    EXPECT_EQ(0, dataStore->size());
+}
+
+// Test that the allocation counter sees the allocations HandleDataStore makes
+TEST(FixedHandleDataStore, AllocationCounterSeesHandleDataStore) {
+    fv::HandleDataStore<uint32_t> dataStore;
+    fv::Handle handle;
+
+    AllocationCounter allocations;
+
+    for (uint32_t i = 0; i < 64; ++i) {
+        handle = dataStore.add(i);
+        dataStore.remove(handle);
+        handle = dataStore.add(i);
+    }
+
+    EXPECT_LT(0, allocations.count());
+}
@@ -0,0 +1,95 @@
+#include <memory>
+
+#include <Fever/Fence.h>
+#include <Fever/FramesInFlight.h>
+
+// The fence calls FramesInFlight makes, backed by fv::Fence in place of a
+// device. Submissions are made by signaling the fences by hand.
+
+FvResult fvFenceCreate(FvFence *fence, const FvFenceCreateInfo *createInfo) {
+    *fence = (FvFence) new fv::Fence(createInfo->signaled != FV_FALSE);
+    return FV_RESULT_SUCCESS;
+}
+
+void fvFenceDestroy(FvFence fence) { delete (fv::Fence *)fence; }
+
+void fvFenceReset(FvFence fence) { ((fv::Fence *)fence)->reset(); }
+
+FvResult fvFenceWait(FvFence fence, uint64_t timeout) {
+    return ((fv::Fence *)fence)->wait(timeout) ? FV_RESULT_SUCCESS
+                                               : FV_RESULT_TIMEOUT;
+}
+
+namespace {
+struct TestFrame {
+    TestFrame() : uniforms(0) {}
+
+    uint32_t uniforms;
+};
+
+void completeSubmission(FvFence fence) { ((fv::Fence *)fence)->signal(); }
+}
+
+// Test that frames cycle through their slots and the first round never
+// waits
+TEST(FramesInFlight, CyclesSlots) {
+    fv::FramesInFlight<TestFrame> frames(3);
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.init());
+    ASSERT_EQ(3u, frames.size());
+
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        ASSERT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(0));
+        EXPECT_EQ(frame, frames.getFrameIndex());
+
+        frames.getFrame().uniforms = frame + 1;
+        frames.getSubmitFence();
+    }
+
+    for (uint32_t slot = 0; slot < 3; ++slot) {
+        EXPECT_EQ(slot + 1, frames.getFrame(slot).uniforms);
+    }
+}
+
+// Test that a slot is only reused once the GPU has finished the frame that
+// used it last, while the other slots stay free
+TEST(FramesInFlight, WaitsForGpu) {
+    fv::FramesInFlight<TestFrame> frames(2);
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.init());
+
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(0));
+    const FvFence first = frames.getSubmitFence();
+
+    // The CPU runs one frame ahead
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(0));
+    EXPECT_EQ(1u, frames.getFrameIndex());
+    const FvFence second = frames.getSubmitFence();
+
+    // But not two
+    EXPECT_EQ(FV_RESULT_TIMEOUT, frames.beginFrame(0));
+    EXPECT_EQ(1u, frames.getFrameIndex());
+
+    std::thread gpu([first]() { completeSubmission(first); });
+    EXPECT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(FV_WAIT_FOREVER));
+    EXPECT_EQ(0u, frames.getFrameIndex());
+    gpu.join();
+    const FvFence third = frames.getSubmitFence();
+
+    // Idle once both frames in flight have finished
+    EXPECT_EQ(FV_RESULT_TIMEOUT, frames.waitIdle(0));
+    completeSubmission(second);
+    EXPECT_EQ(FV_RESULT_TIMEOUT, frames.waitIdle(0));
+    completeSubmission(third);
+    EXPECT_EQ(FV_RESULT_SUCCESS, frames.waitIdle(0));
+}
+
+// Test that a frame which never submitted doesn't hold up its slot
+TEST(FramesInFlight, UnsubmittedFrame) {
+    fv::FramesInFlight<TestFrame> frames(1);
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.init());
+
+    ASSERT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(0));
+    EXPECT_EQ(FV_RESULT_SUCCESS, frames.beginFrame(0));
+
+    frames.getSubmitFence();
+    EXPECT_EQ(FV_RESULT_TIMEOUT, frames.beginFrame(0));
+}
@@ -1,4 +1,7 @@
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <Fever/Handle.h>
 #include <Fever/HandleDataStore.h>
@@ -131,6 +134,190 @@ TEST(HandleDataStore, CreateLargeNumHandles) {
     }
 }
 
+namespace {
+// Counts how many instances are alive.
+struct LifetimeCounter {
+    static int numAlive;
+
+    LifetimeCounter() { ++numAlive; }
+    LifetimeCounter(const LifetimeCounter &) { ++numAlive; }
+    ~LifetimeCounter() { --numAlive; }
+};
+int LifetimeCounter::numAlive = 0;
+}
+
+// Test that objects are destroyed on remove and when the store goes away
+TEST(HandleDataStore, DestroyOnRemove) {
+    {
+        fv::HandleDataStore<LifetimeCounter> dataStore;
+        std::vector<fv::Handle> handles;
+
+        // Enough objects to grow the store a few times
+        for (uint32_t i = 0; i < 100; ++i) {
+            handles.push_back(dataStore.emplace());
+        }
+        EXPECT_EQ(100, LifetimeCounter::numAlive);
+
+        for (uint32_t i = 0; i < 50; ++i) {
+            dataStore.remove(handles[i]);
+        }
+        EXPECT_EQ(50, LifetimeCounter::numAlive);
+
+        // Removing twice destroys nothing more
+        dataStore.remove(handles[0]);
+        EXPECT_EQ(50, LifetimeCounter::numAlive);
+    }
+
+    EXPECT_EQ(0, LifetimeCounter::numAlive);
+}
+
+// Test that move-only objects can be added and survive the store growing
+TEST(HandleDataStore, AddMoveOnly) {
+    fv::HandleDataStore<std::unique_ptr<uint32_t>> dataStore;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        std::unique_ptr<uint32_t> object(new uint32_t(i));
+        handles.push_back(dataStore.add(std::move(object)));
+        EXPECT_TRUE(object == nullptr);
+    }
+
+    handles.push_back(dataStore.emplace(new uint32_t(100)));
+
+    for (uint32_t i = 0; i <= 100; ++i) {
+        EXPECT_EQ(i, **dataStore.get(handles[i]));
+    }
+}
+
+// Test that adding a copy of an object already in the store works while the
+// store grows
+TEST(HandleDataStore, AddCopyOfStoredObject) {
+    fv::HandleDataStore<std::string> dataStore;
+    fv::Handle handle = dataStore.add(std::string(64, 'x'));
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        handle = dataStore.add(*dataStore.get(handle));
+    }
+
+    EXPECT_EQ(std::string(64, 'x'), *dataStore.get(handle));
+}
+
+// Create and destroy objects in two stores one after the other, the way a
+// scene swaps out its textures for new buffers. Removed objects must be
+// destroyed right away, so only one set is ever alive. FeverBench measures
+// the peak memory this leaves.
+TEST(HandleDataStore, ChurnDestroysRemoved) {
+    const int numObjects = 64;
+
+    fv::HandleDataStore<LifetimeCounter> textures;
+    fv::HandleDataStore<LifetimeCounter> buffers;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t round = 0; round < 4; ++round) {
+        fv::HandleDataStore<LifetimeCounter> &dataStore =
+            (round % 2 == 0) ? textures : buffers;
+
+        handles.clear();
+        for (int i = 0; i < numObjects; ++i) {
+            handles.push_back(dataStore.emplace());
+        }
+        EXPECT_EQ(numObjects, LifetimeCounter::numAlive);
+
+        for (int i = 0; i < numObjects; ++i) {
+            dataStore.remove(handles[i]);
+        }
+        EXPECT_EQ(0, LifetimeCounter::numAlive);
+    }
+}
+
+// Test that the 64-bit layout splits the id into two 32-bit halves
+TEST(Handle64, GetComposite) {
+    fv::Handle64 handle;
+    handle.id = ((uint64_t)0xFFFFFFFF << fv::Handle64::HANDLE_INDEX_BITS) + 3;
+
+    EXPECT_EQ(3, handle.getIndex());
+    EXPECT_EQ(0xFFFFFFFF, handle.getGeneration());
+    EXPECT_EQ(32, fv::Handle64::HANDLE_GENERATION_BITS);
+    EXPECT_EQ(0xFFFFFFFF, fv::Handle64::HANDLE_MAX_GENERATION);
+}
+
+// Test that the generation wraps within its bits without touching the index
+TEST(HandleDataStore, GenerationWraparound) {
+    typedef fv::BasicHandle<uint32_t, 28> SmallGenerationHandle;
+    fv::HandleDataStore<uint32_t, SmallGenerationHandle> dataStore;
+
+    const SmallGenerationHandle first = dataStore.add(0);
+    SmallGenerationHandle handle      = first;
+
+    for (uint32_t i = 1; i <= SmallGenerationHandle::HANDLE_MAX_GENERATION;
+         ++i) {
+        dataStore.remove(handle);
+        handle = dataStore.add(i);
+
+        EXPECT_EQ(first.getIndex(), handle.getIndex());
+        EXPECT_EQ(i, handle.getGeneration());
+        EXPECT_FALSE(dataStore.isValid(first));
+    }
+
+    // One more re-use wraps the generation back to zero
+    dataStore.remove(handle);
+    handle = dataStore.add(42);
+
+    EXPECT_EQ(first.getIndex(), handle.getIndex());
+    EXPECT_EQ(0, handle.getGeneration());
+    EXPECT_TRUE(handle == first);
+}
+
+// Test that a stale compact handle aliases a new object after 256 re-uses
+TEST(HandleDataStore, CompactHandleAliasesAfterWraparound) {
+    fv::HandleDataStore<uint32_t> dataStore;
+
+    const fv::Handle stale = dataStore.add(0);
+    fv::Handle handle      = stale;
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        dataStore.remove(handle);
+        handle = dataStore.add(1);
+    }
+
+    EXPECT_TRUE(dataStore.isValid(stale));
+}
+
+// Test that a stale 64-bit handle stays invalid across many re-uses
+TEST(HandleDataStore, Handle64SurvivesReuse) {
+    const uint32_t numReuses = 100000;
+
+    fv::HandleDataStore<uint32_t, fv::Handle64> dataStore;
+
+    const fv::Handle64 stale = dataStore.add(0);
+    fv::Handle64 handle      = stale;
+
+    for (uint32_t i = 0; i < numReuses; ++i) {
+        dataStore.remove(handle);
+        handle = dataStore.add(1);
+
+        ASSERT_FALSE(dataStore.isValid(stale));
+    }
+
+    EXPECT_EQ(stale.getIndex(), handle.getIndex());
+    EXPECT_EQ(numReuses, handle.getGeneration());
+    EXPECT_EQ(1, *dataStore.get(handle));
+}
+
+// Test that the persistent stores accept the 64-bit layout
+TEST(PersistentHandleDataStore, Handle64) {
+    fv::PersistentHandleDataStore<uint32_t, fv::Handle64> dataStore(4);
+
+    const fv::Handle64 stale = *dataStore.add(1);
+    dataStore.remove(stale);
+
+    const fv::Handle64 *handle = dataStore.add(2);
+    EXPECT_TRUE(handle != nullptr);
+    EXPECT_FALSE(dataStore.isValid(stale));
+    EXPECT_TRUE(dataStore.isValid(*handle));
+    EXPECT_EQ(2, *dataStore.get(*handle));
+}
+
 // Test that 'isValid' returns false with an invalid handle
 TEST(PersistentHandleDataStore, InvalidHandle) {
     fv::PersistentHandleDataStore<uint32_t> dataStore(64);
@@ -237,3 +424,59 @@ TEST(PersistentHandleDataStore, CreateTooManyHandles) {
     // Expect adding one more to fail
     EXPECT_EQ(nullptr, dataStore.add(0));
 }
+
+// Test that removing a stale handle does not free the slot of the handle that
+// re-used its index
+TEST(PersistentHandleDataStore, RemoveStaleHandle) {
+    fv::PersistentHandleDataStore<uint32_t> dataStore(64);
+
+    const fv::Handle *handle = dataStore.add(1);
+    EXPECT_TRUE(handle != nullptr);
+    fv::Handle staleHandle = *handle;
+    dataStore.remove(*handle);
+
+    const fv::Handle *newHandle = dataStore.add(2);
+    EXPECT_TRUE(newHandle != nullptr);
+    EXPECT_EQ(staleHandle.getIndex(), newHandle->getIndex());
+
+    dataStore.remove(staleHandle);
+    EXPECT_FALSE(dataStore.isValid(staleHandle));
+    EXPECT_TRUE(dataStore.isValid(*newHandle));
+    EXPECT_EQ(2, *dataStore.get(*newHandle));
+
+    // The slot is still taken, so the next add must use a different one
+    const fv::Handle *otherHandle = dataStore.add(3);
+    EXPECT_TRUE(otherHandle != nullptr);
+    EXPECT_TRUE(otherHandle != newHandle);
+    EXPECT_TRUE(dataStore.isValid(*newHandle));
+}
+
+// Test that removing handles in arbitrary order frees exactly their slots
+TEST(PersistentHandleDataStore, RemoveOutOfOrder) {
+    fv::PersistentHandleDataStore<uint32_t> dataStore(8);
+    const fv::Handle *handles[8];
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+
+    // Remove odd entries
+    for (uint32_t i = 1; i < 8; i += 2) {
+        dataStore.remove(*handles[i]);
+    }
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        if (i % 2 == 0) {
+            EXPECT_TRUE(dataStore.isValid(*handles[i]));
+            EXPECT_EQ(i, *dataStore.get(*handles[i]));
+        } else {
+            EXPECT_FALSE(dataStore.isValid(*handles[i]));
+        }
+    }
+
+    // Refill the freed slots, store must be full again afterwards
+    for (uint32_t i = 1; i < 8; i += 2) {
+        EXPECT_TRUE(dataStore.add(i * 10) != nullptr);
+    }
+    EXPECT_EQ(nullptr, dataStore.add(0));
+}
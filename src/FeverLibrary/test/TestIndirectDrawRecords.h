@@ -0,0 +1,101 @@
+#include <vector>
+
+#include <Fever/IndirectDrawRecords.h>
+
+namespace {
+FvDrawIndirectCommand makeDrawIndirectCommand(uint32_t id) {
+    FvDrawIndirectCommand command;
+    command.vertexCount   = id * 3;
+    command.instanceCount = 1;
+    command.firstVertex   = id;
+    command.firstInstance = id + 1;
+    return command;
+}
+}
+
+// Test that a stride of 0 reads tightly packed records
+TEST(IndirectDrawRecords, PackedRecords) {
+    std::vector<FvDrawIndirectCommand> commands;
+    for (uint32_t i = 0; i < 4; ++i) {
+        commands.push_back(makeDrawIndirectCommand(i));
+    }
+
+    const fv::IndirectDrawRecords<FvDrawIndirectCommand> records(
+        commands.data(), commands.size() * sizeof(FvDrawIndirectCommand), 0, 4,
+        0);
+
+    ASSERT_EQ(4u, records.size());
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(i * sizeof(FvDrawIndirectCommand), records.getOffset(i));
+        EXPECT_EQ(i * 3, records[i].vertexCount);
+        EXPECT_EQ(i, records[i].firstVertex);
+        EXPECT_EQ(i + 1, records[i].firstInstance);
+    }
+}
+
+// Test that records interleaved with other data are read at their stride,
+// from an offset that isn't aligned for them
+TEST(IndirectDrawRecords, StridedUnalignedRecords) {
+    const FvSize offset   = 3;
+    const uint32_t stride = sizeof(FvDrawIndirectCommand) + 8;
+
+    std::vector<uint8_t> data(offset + stride * 3, 0xff);
+    for (uint32_t i = 0; i < 3; ++i) {
+        const FvDrawIndirectCommand command = makeDrawIndirectCommand(i);
+        memcpy(&data[offset + i * stride], &command, sizeof(command));
+    }
+
+    const fv::IndirectDrawRecords<FvDrawIndirectCommand> records(
+        data.data(), data.size(), offset, 3, stride);
+
+    ASSERT_EQ(3u, records.size());
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(offset + i * stride, records.getOffset(i));
+        EXPECT_EQ(i * 3, records[i].vertexCount);
+        EXPECT_EQ(i + 1, records[i].firstInstance);
+    }
+}
+
+// Test that records running past the end of the buffer are dropped
+TEST(IndirectDrawRecords, ClampsToBuffer) {
+    const FvSize size = sizeof(FvDrawIndirectCommand);
+
+    typedef fv::IndirectDrawRecords<FvDrawIndirectCommand> Records;
+
+    // Only whole records count, a partial last one is dropped
+    EXPECT_EQ(3u, Records(nullptr, size * 3, 0, 10, 0).size());
+    EXPECT_EQ(2u, Records(nullptr, size * 3 - 1, 0, 10, 0).size());
+    EXPECT_EQ(2u, Records(nullptr, size * 3, 4, 10, 0).size());
+
+    // The last record needs no padding after it to reach the stride
+    EXPECT_EQ(2u, Records(nullptr, size * 3, 0, 10, size * 2).size());
+
+    // Offsets at or past the end of the buffer have no records
+    EXPECT_EQ(0u, Records(nullptr, size, size, 1, 0).size());
+    EXPECT_EQ(0u, Records(nullptr, size, UINT64_MAX, 1, 0).size());
+    EXPECT_EQ(0u, Records(nullptr, 0, 0, 1, 0).size());
+
+    // The draw count still limits the records
+    EXPECT_EQ(1u, Records(nullptr, size * 3, 0, 1, 0).size());
+}
+
+// Test that indexed records keep their signed vertex offset
+TEST(IndirectDrawRecords, IndexedRecords) {
+    FvDrawIndexedIndirectCommand commands[2];
+    commands[0].indexCount    = 36;
+    commands[0].instanceCount = 2;
+    commands[0].firstIndex    = 6;
+    commands[0].vertexOffset  = -4;
+    commands[0].firstInstance = 0;
+    commands[1]               = commands[0];
+    commands[1].vertexOffset  = 100;
+
+    const fv::IndirectDrawRecords<FvDrawIndexedIndirectCommand> records(
+        commands, sizeof(commands), 0, 2, 0);
+
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(36u, records[0].indexCount);
+    EXPECT_EQ(6u, records[0].firstIndex);
+    EXPECT_EQ(-4, records[0].vertexOffset);
+    EXPECT_EQ(100, records[1].vertexOffset);
+}
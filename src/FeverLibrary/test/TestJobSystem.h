@@ -0,0 +1,117 @@
+#include <atomic>
+#include <vector>
+
+#include <Fever/JobSystem.h>
+
+// Test that jobs run against a counter have all run once waiting for it
+// returns
+TEST(JobSystem, WaitForCounter) {
+    fv::JobSystem jobs(3);
+    fv::JobCounter counter;
+    std::atomic<int> numRun(0);
+
+    EXPECT_TRUE(counter.isDone());
+
+    for (int i = 0; i < 1000; ++i) {
+        jobs.run([&numRun]() { ++numRun; }, &counter);
+    }
+    jobs.wait(counter);
+
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(1000, numRun.load());
+
+    // Counters can be reused
+    jobs.run([&numRun]() { ++numRun; }, &counter);
+    jobs.wait(counter);
+    EXPECT_EQ(1001, numRun.load());
+}
+
+// Test that a job run after a counter only starts once the jobs run against
+// it have finished
+TEST(JobSystem, RunAfterDependency) {
+    fv::JobSystem jobs(2);
+    fv::JobCounter first;
+    fv::JobCounter second;
+    std::atomic<int> numFirstRun(0);
+    int numFirstRunBefore = -1;
+
+    for (int i = 0; i < 100; ++i) {
+        jobs.run([&numFirstRun]() { ++numFirstRun; }, &first);
+    }
+    jobs.runAfter(first,
+                  [&]() { numFirstRunBefore = numFirstRun.load(); }, &second);
+    jobs.wait(second);
+
+    EXPECT_EQ(100, numFirstRunBefore);
+
+    // Runs straight away once the dependency is done
+    bool ran = false;
+    jobs.runAfter(first, [&ran]() { ran = true; }, &second);
+    jobs.wait(second);
+    EXPECT_TRUE(ran);
+}
+
+// Test that a parallel for calls the function over every index exactly once,
+// in chunks no bigger than the grain size
+TEST(JobSystem, ParallelForCoversRange) {
+    fv::JobSystem jobs(3);
+
+    const uint32_t COUNT = 10007;
+    std::vector<std::atomic<int>> visits(COUNT);
+    for (std::atomic<int> &count : visits) {
+        count.store(0);
+    }
+    std::atomic<uint32_t> largestChunk(0);
+
+    jobs.parallelFor(COUNT, 64, [&](uint32_t begin, uint32_t end) {
+        uint32_t largest = largestChunk.load();
+        while (end - begin > largest &&
+               !largestChunk.compare_exchange_weak(largest, end - begin)) {
+        }
+
+        for (uint32_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+
+    EXPECT_GE(64u, largestChunk.load());
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(1, visits[i].load()) << "index " << i;
+    }
+}
+
+// Test that jobs can wait on parallel fors of their own
+TEST(JobSystem, NestedParallelFor) {
+    fv::JobSystem jobs(2);
+    std::atomic<uint32_t> sum(0);
+
+    jobs.parallelFor(16, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            jobs.parallelFor(100, 10, [&](uint32_t begin, uint32_t end) {
+                sum += end - begin;
+            });
+        }
+    });
+
+    EXPECT_EQ(1600u, sum.load());
+}
+
+// Test that without workers, jobs run on the thread waiting for them
+TEST(JobSystem, NoWorkers) {
+    fv::JobSystem jobs(0);
+    EXPECT_EQ(0u, jobs.getNumWorkers());
+
+    fv::JobCounter counter;
+    bool ran = false;
+
+    jobs.run([&ran]() { ran = true; }, &counter);
+    EXPECT_FALSE(ran);
+
+    jobs.wait(counter);
+    EXPECT_TRUE(ran);
+
+    uint32_t covered = 0;
+    jobs.parallelFor(
+        50, 8, [&](uint32_t begin, uint32_t end) { covered += end - begin; });
+    EXPECT_EQ(50u, covered);
+}
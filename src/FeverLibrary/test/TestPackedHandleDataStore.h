@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <vector>
+
+#include <Fever/PackedHandleDataStore.h>
+
+// Test that 'isValid' returns false with an invalid handle
+TEST(PackedHandleDataStore, InvalidHandle) {
+    fv::PackedHandleDataStore<uint32_t> dataStore;
+    fv::Handle handle;
+
+    handle.id = 0;
+
+    EXPECT_FALSE(dataStore.isValid(handle));
+    EXPECT_EQ(nullptr, dataStore.get(handle));
+    EXPECT_EQ(0, dataStore.size());
+}
+
+// Test that removing keeps the remaining objects reachable through their
+// handles after they have been moved
+TEST(PackedHandleDataStore, SwapRemove) {
+    fv::PackedHandleDataStore<uint32_t> dataStore;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        handles.push_back(dataStore.add(i));
+    }
+
+    // Remove the first object, the last one moves into its place
+    dataStore.remove(handles[0]);
+    EXPECT_FALSE(dataStore.isValid(handles[0]));
+    EXPECT_EQ(7, dataStore.size());
+    EXPECT_EQ(7, *dataStore.begin());
+
+    for (uint32_t i = 1; i < 8; ++i) {
+        EXPECT_TRUE(dataStore.isValid(handles[i]));
+        EXPECT_EQ(i, *dataStore.get(handles[i]));
+    }
+
+    // Removing a stale handle does nothing
+    dataStore.remove(handles[0]);
+    EXPECT_EQ(7, dataStore.size());
+
+    // Re-used index gets a new generation
+    const fv::Handle reused = dataStore.add(100);
+    EXPECT_EQ(handles[0].getIndex(), reused.getIndex());
+    EXPECT_FALSE(dataStore.isValid(handles[0]));
+    EXPECT_EQ(100, *dataStore.get(reused));
+}
+
+// Test that iteration visits every live object exactly once and that
+// 'getHandle' maps iteration positions back to handles
+TEST(PackedHandleDataStore, IterateLiveObjects) {
+    fv::PackedHandleDataStore<uint32_t> dataStore;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t i = 0; i < 64; ++i) {
+        handles.push_back(dataStore.add(i));
+    }
+
+    // Remove every third object
+    for (uint32_t i = 0; i < 64; i += 3) {
+        dataStore.remove(handles[i]);
+    }
+
+    std::vector<uint32_t> visited(dataStore.begin(), dataStore.end());
+    std::sort(visited.begin(), visited.end());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 64; ++i) {
+        if (i % 3 != 0) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(expected, visited);
+
+    for (size_t i = 0; i < dataStore.size(); ++i) {
+        const fv::Handle handle = dataStore.getHandle(i);
+
+        EXPECT_TRUE(dataStore.isValid(handle));
+        EXPECT_EQ(&*(dataStore.begin() + i), dataStore.get(handle));
+        EXPECT_TRUE(handles[*dataStore.get(handle)] == handle);
+    }
+
+    // Removing everything leaves nothing to iterate
+    for (uint32_t i = 0; i < 64; ++i) {
+        dataStore.remove(handles[i]);
+    }
+    EXPECT_EQ(0, dataStore.size());
+    EXPECT_TRUE(dataStore.begin() == dataStore.end());
+}
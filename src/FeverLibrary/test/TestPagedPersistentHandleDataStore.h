@@ -0,0 +1,148 @@
+#include <vector>
+
+#include <Fever/PagedPersistentHandleDataStore.h>
+
+// Test that 'isValid' returns false with an invalid handle
+TEST(PagedPersistentHandleDataStore, InvalidHandle) {
+    fv::PagedPersistentHandleDataStore<uint32_t> dataStore;
+    fv::Handle handle;
+
+    handle.id = 0;
+
+    EXPECT_FALSE(dataStore.isValid(handle));
+    EXPECT_EQ(nullptr, dataStore.get(handle));
+
+    // Removing an invalid handle is a no-op
+    dataStore.remove(handle);
+    EXPECT_EQ(0, dataStore.getNumPages());
+}
+
+// Test that the store grows past many pages without moving handles
+TEST(PagedPersistentHandleDataStore, GrowsWithStableAddresses) {
+    const uint32_t numHandles = 10000;
+
+    fv::PagedPersistentHandleDataStore<uint32_t, fv::Handle, 16> dataStore;
+    std::vector<const fv::Handle *> handlePtrs;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t i = 0; i < numHandles; ++i) {
+        const fv::Handle *handlePtr = dataStore.add(i);
+        ASSERT_FALSE(handlePtr == nullptr);
+
+        handlePtrs.push_back(handlePtr);
+        handles.push_back(*handlePtr);
+    }
+
+    EXPECT_EQ(numHandles / 16, dataStore.getNumPages());
+
+    for (uint32_t i = 0; i < numHandles; ++i) {
+        EXPECT_EQ(handles[i], *handlePtrs[i]);
+        EXPECT_TRUE(dataStore.isValid(*handlePtrs[i]));
+        EXPECT_EQ(i, *dataStore.get(*handlePtrs[i]));
+    }
+}
+
+// Test that a stale handle cannot remove the object that re-used its slot
+TEST(PagedPersistentHandleDataStore, RemoveStaleHandle) {
+    fv::PagedPersistentHandleDataStore<uint32_t> dataStore;
+
+    const fv::Handle stale = *dataStore.add(1);
+    dataStore.remove(stale);
+
+    const fv::Handle *live = dataStore.add(2);
+    EXPECT_FALSE(dataStore.isValid(stale));
+    EXPECT_TRUE(dataStore.isValid(*live));
+
+    dataStore.remove(stale);
+    EXPECT_TRUE(dataStore.isValid(*live));
+    EXPECT_EQ(2, *dataStore.get(*live));
+}
+
+// Test that emptied pages are released and that their slots are re-used
+TEST(PagedPersistentHandleDataStore, ReleasesEmptyPages) {
+    const uint32_t handlesPerPage = 8;
+    const uint32_t numPages       = 4;
+
+    fv::PagedPersistentHandleDataStore<uint32_t, fv::Handle, handlesPerPage>
+        dataStore;
+    std::vector<fv::Handle> handles;
+
+    for (uint32_t i = 0; i < handlesPerPage * numPages; ++i) {
+        handles.push_back(*dataStore.add(i));
+    }
+    EXPECT_EQ(numPages, dataStore.getNumPages());
+
+    // Empty every page but the first, keeping one page with room
+    for (size_t i = handlesPerPage; i < handles.size(); ++i) {
+        dataStore.remove(handles[i]);
+    }
+    EXPECT_EQ(2, dataStore.getNumPages());
+
+    for (uint32_t i = 0; i < handlesPerPage; ++i) {
+        EXPECT_TRUE(dataStore.isValid(handles[i]));
+        EXPECT_EQ(i, *dataStore.get(handles[i]));
+    }
+    for (size_t i = handlesPerPage; i < handles.size(); ++i) {
+        EXPECT_FALSE(dataStore.isValid(handles[i]));
+    }
+
+    // Churning around the page boundary must not allocate new pages
+    for (uint32_t i = 0; i < 100; ++i) {
+        dataStore.remove(*dataStore.add(i));
+    }
+    EXPECT_EQ(2, dataStore.getNumPages());
+
+    // Emptying the store keeps a single page around
+    for (uint32_t i = 0; i < handlesPerPage; ++i) {
+        dataStore.remove(handles[i]);
+    }
+    EXPECT_EQ(1, dataStore.getNumPages());
+
+    // Growing again re-uses released page entries
+    for (uint32_t i = 0; i < handlesPerPage * numPages; ++i) {
+        EXPECT_TRUE(dataStore.isValid(*dataStore.add(i)));
+    }
+    EXPECT_EQ(numPages, dataStore.getNumPages());
+}
+
+// Test that the paged store works with the 64-bit handle layout
+TEST(PagedPersistentHandleDataStore, Handle64) {
+    fv::PagedPersistentHandleDataStore<uint32_t, fv::Handle64, 4> dataStore;
+    std::vector<const fv::Handle64 *> handles;
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        handles.push_back(dataStore.add(i));
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        EXPECT_TRUE(dataStore.isValid(*handles[i]));
+        EXPECT_EQ(i, *dataStore.get(*handles[i]));
+    }
+}
+
+// Test that adding after 'reserve' does not touch the heap
+TEST(PagedPersistentHandleDataStore, ReserveThenAddDoesNotAllocate) {
+    const uint32_t count = 1000;
+
+    fv::PagedPersistentHandleDataStore<uint32_t> dataStore;
+
+    // Leave some free slots behind so reserve has to account for them
+    for (uint32_t i = 0; i < 100; ++i) {
+        dataStore.add(i);
+    }
+
+    dataStore.reserve(count);
+
+    AllocationCounter allocations;
+    std::vector<const fv::Handle *> handles(count);
+
+    const size_t allocationsBefore = allocations.count();
+    for (uint32_t i = 0; i < count; ++i) {
+        handles[i] = dataStore.add(i);
+    }
+    EXPECT_EQ(allocationsBefore, allocations.count());
+
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(i, *dataStore.get(*handles[i]));
+    }
+}
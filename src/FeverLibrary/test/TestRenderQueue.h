@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <random>
+
+#include <Fever/RenderQueue.h>
+
+namespace {
+// Draw whose vertex buffer identifies it
+fv::DrawItem makeDrawItem(uint32_t id) {
+    fv::DrawItem item = {};
+    item.vertexBuffer = fakeHandle<FvBuffer>(id + 1);
+    item.count        = 3;
+    return item;
+}
+
+// Sort random keys using all 64 bits and check they come out in order
+void expectSortsFullKeys(uint32_t numItems) {
+    fv::RenderQueue queue;
+    std::mt19937_64 random(11);
+
+    for (uint32_t i = 0; i < numItems; ++i) {
+        queue.add(random(), makeDrawItem(i));
+    }
+    queue.sort();
+
+    for (size_t i = 1; i < queue.size(); ++i) {
+        ASSERT_LE(queue.getSortedKey(i - 1), queue.getSortedKey(i));
+    }
+}
+}
+
+// Test that sort keys order by pipeline, then descriptor set, then vertex
+// buffer, then depth
+TEST(RenderQueue, SortKeyOrder) {
+    typedef fv::RenderQueue RQ;
+
+    EXPECT_LT(RQ::makeSortKey(0, 9, 9, 1.0f), RQ::makeSortKey(1, 0, 0, 0.0f));
+    EXPECT_LT(RQ::makeSortKey(1, 0, 9, 1.0f), RQ::makeSortKey(1, 1, 0, 0.0f));
+    EXPECT_LT(RQ::makeSortKey(1, 1, 0, 1.0f), RQ::makeSortKey(1, 1, 1, 0.0f));
+    EXPECT_LT(RQ::makeSortKey(1, 1, 1, 0.25f), RQ::makeSortKey(1, 1, 1, 0.5f));
+
+    // Depth is clamped, ids are truncated to their bits
+    EXPECT_EQ(RQ::makeSortKey(1, 1, 1, 0.0f), RQ::makeSortKey(1, 1, 1, -1.0f));
+    EXPECT_EQ(RQ::makeSortKey(1, 1, 1, 1.0f), RQ::makeSortKey(1, 1, 1, 2.0f));
+    EXPECT_EQ(RQ::makeSortKey(0, 0, 0, 0.0f),
+              RQ::makeSortKey(1 << RQ::PIPELINE_BITS, 0, 0, 0.0f));
+}
+
+// Test that sorting matches a stable sort of the keys, keeping draws with
+// equal keys in the order they were added
+TEST(RenderQueue, SortMatchesStableSort) {
+    const uint32_t numItems = 10000;
+    std::mt19937 random(7);
+
+    fv::RenderQueue queue;
+    std::vector<std::pair<uint64_t, uint32_t>> expected;
+
+    for (uint32_t i = 0; i < numItems; ++i) {
+        // Few distinct states, so many keys are equal
+        const uint64_t key = fv::RenderQueue::makeSortKey(
+            random() % 4, random() % 16, random() % 64, (random() % 8) / 8.0f);
+
+        queue.add(key, makeDrawItem(i));
+        expected.push_back(std::make_pair(key, i));
+    }
+
+    queue.sort();
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::pair<uint64_t, uint32_t> &a,
+                        const std::pair<uint64_t, uint32_t> &b) {
+                         return a.first < b.first;
+                     });
+
+    ASSERT_EQ(numItems, queue.size());
+    for (uint32_t i = 0; i < numItems; ++i) {
+        ASSERT_EQ(expected[i].first, queue.getSortedKey(i));
+        ASSERT_EQ(fakeHandle<FvBuffer>(expected[i].second + 1),
+                  queue.getSorted(i).vertexBuffer);
+    }
+}
+
+// Test that keys using every bit sort, both in queues small enough for the
+// comparison sort and in queues large enough for every radix pass to run
+TEST(RenderQueue, SortFullKeys) {
+    for (uint32_t numItems = 100; numItems <= 10000; numItems *= 10) {
+        SCOPED_TRACE(numItems);
+        expectSortsFullKeys(numItems);
+    }
+}
+
+// Test that a cleared queue can be refilled and sorted without allocating once
+// it has seen its largest frame, with either sort
+TEST(RenderQueue, ClearReusesMemory) {
+    for (uint32_t numItems = 100; numItems <= 10000; numItems *= 10) {
+        SCOPED_TRACE(numItems);
+        fv::RenderQueue queue;
+
+        for (uint32_t frame = 0; frame < 2; ++frame) {
+            AllocationCounter allocations;
+
+            queue.clear();
+            for (uint32_t i = 0; i < numItems; ++i) {
+                queue.add(numItems - i, makeDrawItem(i));
+            }
+            queue.sort();
+
+            if (frame > 0) {
+                EXPECT_EQ(0, allocations.count());
+            }
+            EXPECT_EQ(1, queue.getSortedKey(0));
+            EXPECT_EQ(fakeHandle<FvBuffer>(numItems),
+                      queue.getSorted(0).vertexBuffer);
+        }
+    }
+}
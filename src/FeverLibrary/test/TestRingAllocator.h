@@ -0,0 +1,54 @@
+#include <Fever/RingAllocator.h>
+
+// Test that the buffer is split into aligned regions and that allocations are
+// aligned within the region of the current frame
+TEST(RingAllocator, AlignedAllocations) {
+    fv::RingAllocator ring(1000, 3, 64);
+
+    // 1000 / 3 = 333, rounded down to 320 so each region starts aligned
+    EXPECT_EQ(320u, ring.getRegionSize());
+    EXPECT_EQ(3u, ring.getNumRegions());
+    EXPECT_EQ(64u, ring.getAlignment());
+
+    ring.beginFrame(1);
+
+    FvSize offset = 0;
+    ASSERT_TRUE(ring.allocate(10, &offset));
+    EXPECT_EQ(320u, offset);
+    ASSERT_TRUE(ring.allocate(64, &offset));
+    EXPECT_EQ(384u, offset);
+    EXPECT_EQ(128u, ring.getUsed());
+
+    // Zero-sized allocations are still aligned
+    ASSERT_TRUE(ring.allocate(0, &offset));
+    EXPECT_EQ(448u, offset);
+}
+
+// Test that allocations fail once the region is full, without spilling into
+// the next region, and that starting the frame again frees the region
+TEST(RingAllocator, RegionFull) {
+    fv::RingAllocator ring(512, 2, 64);
+    ring.beginFrame(0);
+
+    FvSize offset = 7;
+    EXPECT_FALSE(ring.allocate(257, &offset));
+    EXPECT_EQ(7u, offset);
+
+    ASSERT_TRUE(ring.allocate(100, &offset));
+    EXPECT_EQ(0u, offset);
+    ASSERT_TRUE(ring.allocate(128, &offset));
+    EXPECT_EQ(128u, offset);
+    EXPECT_EQ(256u, ring.getUsed());
+    EXPECT_FALSE(ring.allocate(1, &offset));
+    EXPECT_FALSE(ring.allocate(~(FvSize)0, &offset));
+
+    // Frames wrap around the regions
+    ring.beginFrame(3);
+    EXPECT_EQ(0u, ring.getUsed());
+    ASSERT_TRUE(ring.allocate(1, &offset));
+    EXPECT_EQ(256u, offset);
+
+    ring.beginFrame(0);
+    ASSERT_TRUE(ring.allocate(256, &offset));
+    EXPECT_EQ(0u, offset);
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <Fever/SerialTracker.h>
+
+// Test that serials completed in order move the completed serial along
+TEST(SerialTracker, InOrder) {
+    fv::SerialTracker tracker;
+    EXPECT_EQ(0, tracker.getCompleted());
+
+    tracker.complete(1);
+    EXPECT_EQ(1, tracker.getCompleted());
+
+    tracker.complete(2);
+    tracker.complete(3);
+    EXPECT_EQ(3, tracker.getCompleted());
+}
+
+// Test that a serial completed ahead of an earlier one is held back until the
+// earlier one completes, as with submissions to two queues
+TEST(SerialTracker, OutOfOrder) {
+    fv::SerialTracker tracker;
+
+    tracker.complete(3);
+    tracker.complete(2);
+    EXPECT_EQ(0, tracker.getCompleted());
+
+    tracker.complete(5);
+    tracker.complete(1);
+    EXPECT_EQ(3, tracker.getCompleted());
+
+    tracker.complete(4);
+    EXPECT_EQ(5, tracker.getCompleted());
+
+    tracker.complete(6);
+    EXPECT_EQ(6, tracker.getCompleted());
+}
+
+// Test that a wait only returns once every serial up to its own has completed
+TEST(SerialTracker, WaitForPrefix) {
+    fv::SerialTracker tracker;
+    std::atomic<bool> woken(false);
+
+    std::thread waiter([&]() {
+        tracker.wait(2);
+        woken = true;
+    });
+
+    tracker.complete(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(woken);
+
+    tracker.complete(1);
+    waiter.join();
+    EXPECT_TRUE(woken);
+
+    // Already completed, returns at once
+    tracker.wait(1);
+}
+
+// Test that serials completed from several threads in any order all count
+TEST(SerialTracker, CompleteFromThreads) {
+    static const uint64_t NUM_SERIALS = 10000;
+    static const uint64_t NUM_THREADS = 4;
+
+    fv::SerialTracker tracker;
+
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&tracker, t]() {
+            // Every thread completes a strided share, from the back
+            for (uint64_t serial = NUM_SERIALS - t; serial > 0;
+                 serial -= std::min(serial, NUM_THREADS)) {
+                tracker.complete(serial);
+            }
+        });
+    }
+
+    tracker.wait(NUM_SERIALS);
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(NUM_SERIALS, tracker.getCompleted());
+}
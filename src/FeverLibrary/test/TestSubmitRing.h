@@ -0,0 +1,94 @@
+#include <thread>
+#include <vector>
+
+#include <Fever/SubmitRing.h>
+
+// Test that elements come out in the order they went in, and pushes fail
+// once every slot is filled
+TEST(SubmitRing, FifoAndFull) {
+    fv::SubmitRing<int> ring(3);
+    EXPECT_EQ(4u, ring.capacity());
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush([i](int &element) { element = i; }));
+    }
+    EXPECT_FALSE(ring.tryPush([](int &element) { element = -1; }));
+
+    // Go round the ring a few times
+    for (int i = 0; i < 12; ++i) {
+        int popped = -1;
+        EXPECT_TRUE(ring.tryPop([&](int &element) { popped = element; }));
+        EXPECT_EQ(i, popped);
+
+        EXPECT_TRUE(ring.tryPush([i](int &element) { element = i + 4; }));
+    }
+
+    int popped = 0;
+    while (ring.tryPop([&](int &) { ++popped; })) {
+    }
+    EXPECT_EQ(4, popped);
+    EXPECT_TRUE(ring.empty());
+}
+
+// Test that elements keep their storage from one use of a slot to the next
+TEST(SubmitRing, ReusesElements) {
+    fv::SubmitRing<std::vector<int>> ring(1);
+
+    ASSERT_TRUE(ring.tryPush([](std::vector<int> &element) {
+        element.assign(100, 1);
+    }));
+    ASSERT_TRUE(ring.tryPop([](std::vector<int> &) {}));
+
+    size_t capacity = 0;
+    ASSERT_TRUE(ring.tryPush([&](std::vector<int> &element) {
+        capacity = element.capacity();
+        element.assign(10, 2);
+    }));
+    EXPECT_GE(capacity, 100u);
+}
+
+// Test that every element pushed by several producers arrives once, in the
+// order each producer pushed them
+TEST(SubmitRing, MultipleProducers) {
+    const uint32_t numProducers = 4;
+    const uint32_t numPushes    = 20000;
+
+    fv::SubmitRing<uint32_t> ring(16);
+
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < numProducers; ++producer) {
+        producers.emplace_back([&ring, producer]() {
+            for (uint32_t i = 0; i < numPushes; ++i) {
+                const uint32_t value = producer * numPushes + i;
+
+                while (!ring.tryPush(
+                    [value](uint32_t &element) { element = value; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(numProducers, 0);
+    uint32_t numPopped = 0;
+
+    while (numPopped < numProducers * numPushes) {
+        uint32_t value = 0;
+
+        if (!ring.tryPop([&](uint32_t &element) { value = element; })) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint32_t producer = value / numPushes;
+        ASSERT_EQ(next[producer], value % numPushes);
+        ++next[producer];
+        ++numPopped;
+    }
+
+    for (std::thread &producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
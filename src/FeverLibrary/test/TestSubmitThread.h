@@ -0,0 +1,105 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Fever/SubmitThread.h>
+
+// Test that a batch owns copies of every array the submissions point to
+TEST(SubmitThread, BatchCopiesArrays) {
+    std::vector<FvSemaphore> waits;
+    waits.push_back(fakeHandle<FvSemaphore>(1));
+    waits.push_back(fakeHandle<FvSemaphore>(2));
+    std::vector<uint64_t> waitValues(1, 10);
+    waitValues.push_back(20);
+    std::vector<FvCommandBuffer> commandBuffers(
+        1, fakeHandle<FvCommandBuffer>(3));
+    std::vector<FvSemaphore> signals(1, fakeHandle<FvSemaphore>(4));
+
+    FvSubmitInfo submissions[2]         = {};
+    submissions[0].waitSemaphoreCount   = 2;
+    submissions[0].waitSemaphores       = waits.data();
+    submissions[0].waitSemaphoreValues  = waitValues.data();
+    submissions[0].commandBufferCount   = 1;
+    submissions[0].commandBuffers       = commandBuffers.data();
+    submissions[1].signalSemaphoreCount = 1;
+    submissions[1].signalSemaphores     = signals.data();
+
+    std::shared_ptr<fv::Fence> fence = std::make_shared<fv::Fence>();
+
+    fv::SubmitBatch batch;
+    batch.assign(2, submissions, fence, 7);
+
+    // Scribble over the originals
+    waits.assign(2, FV_NULL_HANDLE);
+    waitValues.assign(2, 0);
+    commandBuffers.assign(1, FV_NULL_HANDLE);
+    signals.assign(1, FV_NULL_HANDLE);
+
+    ASSERT_EQ(2u, batch.getSubmissionsCount());
+    EXPECT_EQ(fence, batch.getFence());
+    EXPECT_EQ(7u, batch.getFirstSerial());
+
+    const FvSubmitInfo *copies = batch.getSubmissions();
+    ASSERT_EQ(2u, copies[0].waitSemaphoreCount);
+    EXPECT_EQ(fakeHandle<FvSemaphore>(1), copies[0].waitSemaphores[0]);
+    EXPECT_EQ(fakeHandle<FvSemaphore>(2), copies[0].waitSemaphores[1]);
+    EXPECT_EQ(10u, copies[0].waitSemaphoreValues[0]);
+    EXPECT_EQ(20u, copies[0].waitSemaphoreValues[1]);
+    EXPECT_EQ(fakeHandle<FvCommandBuffer>(3), copies[0].commandBuffers[0]);
+    EXPECT_EQ(nullptr, copies[0].signalSemaphores);
+    EXPECT_EQ(fakeHandle<FvSemaphore>(4), copies[1].signalSemaphores[0]);
+    EXPECT_EQ(nullptr, copies[1].signalSemaphoreValues);
+}
+
+// Test that submits are made in order on the submit thread, and flush waits
+// for them
+TEST(SubmitThread, SubmitsInOrder) {
+    std::vector<uint64_t> serials;
+    std::thread::id submitThreadId;
+
+    {
+        fv::SubmitThread thread(
+            [&](const fv::SubmitBatch &batch) {
+                submitThreadId = std::this_thread::get_id();
+                serials.push_back(batch.getFirstSerial());
+            },
+            4);
+
+        for (uint64_t serial = 1; serial <= 100; ++serial) {
+            thread.push(0, nullptr, nullptr, serial);
+        }
+        thread.flush();
+
+        ASSERT_EQ(100u, serials.size());
+        EXPECT_NE(std::this_thread::get_id(), submitThreadId);
+
+        // Pushes after a flush are made before the thread stops
+        thread.push(0, nullptr, nullptr, 101);
+    }
+
+    ASSERT_EQ(101u, serials.size());
+    for (uint64_t i = 0; i < serials.size(); ++i) {
+        EXPECT_EQ(i + 1, serials[i]);
+    }
+}
+
+// Test that a push returns without waiting for the submit function
+TEST(SubmitThread, PushDoesNotWait) {
+    fv::Fence release;
+    std::atomic<int> submitted(0);
+
+    fv::SubmitThread thread([&](const fv::SubmitBatch &) {
+        release.wait();
+        ++submitted;
+    });
+
+    for (int i = 0; i < 8; ++i) {
+        thread.push(0, nullptr, nullptr, i);
+    }
+    EXPECT_EQ(0, submitted.load());
+
+    release.signal();
+    thread.flush();
+    EXPECT_EQ(8, submitted.load());
+}
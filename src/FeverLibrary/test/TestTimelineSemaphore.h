@@ -0,0 +1,149 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Fever/TimelineSemaphore.h>
+
+// Test that the value only ever goes up
+TEST(TimelineSemaphore, SignalIncreases) {
+    fv::TimelineSemaphore semaphore(5);
+    EXPECT_EQ(5u, semaphore.getValue());
+
+    EXPECT_TRUE(semaphore.signal(6));
+    EXPECT_TRUE(semaphore.signal(100));
+    EXPECT_EQ(100u, semaphore.getValue());
+
+    EXPECT_FALSE(semaphore.signal(100));
+    EXPECT_FALSE(semaphore.signal(7));
+    EXPECT_EQ(100u, semaphore.getValue());
+
+    EXPECT_TRUE(semaphore.signal(UINT64_MAX));
+    EXPECT_EQ(UINT64_MAX, semaphore.getValue());
+}
+
+// Test that waits for reached values return at once, any number of times,
+// and waits for later values time out
+TEST(TimelineSemaphore, WaitForValue) {
+    fv::TimelineSemaphore semaphore(3);
+
+    EXPECT_TRUE(semaphore.wait(0, 0));
+    EXPECT_TRUE(semaphore.wait(3, 0));
+    EXPECT_TRUE(semaphore.wait(3, 0));
+    EXPECT_FALSE(semaphore.wait(4, 0));
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(semaphore.wait(4, 10 * 1000 * 1000));
+    EXPECT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(10));
+}
+
+// Test that waiters on other threads wake once their own value is reached,
+// and not before
+TEST(TimelineSemaphore, SignalWakesWaiters) {
+    fv::TimelineSemaphore semaphore;
+    std::atomic<uint64_t> woken(0);
+
+    std::vector<std::thread> waiters;
+    for (uint64_t value = 1; value <= 4; ++value) {
+        waiters.emplace_back([&semaphore, &woken, value]() {
+            semaphore.wait(value);
+            EXPECT_GE(semaphore.getValue(), value);
+            ++woken;
+        });
+    }
+
+    semaphore.signal(2);
+    while (woken.load() < 2) {
+        std::this_thread::yield();
+    }
+
+    // Waiters for 3 and 4 are still blocked
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(2u, woken.load());
+
+    semaphore.signal(4);
+    for (std::thread &waiter : waiters) {
+        waiter.join();
+    }
+    EXPECT_EQ(4u, woken.load());
+}
+
+// Test that callbacks run once their value is reached, in the order they were
+// added, and right away for values already reached
+TEST(TimelineSemaphore, WhenReached) {
+    fv::TimelineSemaphore semaphore(1);
+    std::vector<int> order;
+
+    semaphore.whenReached(1, [&]() { order.push_back(0); });
+    ASSERT_EQ(1u, order.size());
+
+    semaphore.whenReached(3, [&]() { order.push_back(3); });
+    semaphore.whenReached(2, [&]() { order.push_back(2); });
+    semaphore.whenReached(3, [&]() { order.push_back(4); });
+    EXPECT_EQ(3u, semaphore.getNumPendingCallbacks());
+
+    semaphore.signal(2);
+    ASSERT_EQ(2u, order.size());
+    EXPECT_EQ(2, order[1]);
+
+    semaphore.signal(10);
+    ASSERT_EQ(4u, order.size());
+    EXPECT_EQ(3, order[2]);
+    EXPECT_EQ(4, order[3]);
+    EXPECT_EQ(0u, semaphore.getNumPendingCallbacks());
+}
+
+// Test that a callback may signal the semaphore that ran it, chaining values
+TEST(TimelineSemaphore, CallbackSignals) {
+    fv::TimelineSemaphore semaphore;
+
+    for (uint64_t value = 1; value < 100; ++value) {
+        semaphore.whenReached(value, [&semaphore, value]() {
+            semaphore.signal(value + 1);
+        });
+    }
+
+    semaphore.signal(1);
+    EXPECT_EQ(100u, semaphore.getValue());
+}
+
+// Test a pipeline of stages on their own threads, each waiting for the
+// previous stage's value of a frame before signaling its own, with one
+// semaphore per stage rather than per frame
+TEST(TimelineSemaphore, ParallelPipeline) {
+    const uint64_t numFrames = 1000;
+    const int numStages      = 4;
+
+    std::vector<std::unique_ptr<fv::TimelineSemaphore>> stages;
+    for (int i = 0; i < numStages; ++i) {
+        stages.emplace_back(new fv::TimelineSemaphore());
+    }
+
+    std::vector<uint64_t> frames(numFrames, 0);
+
+    std::vector<std::thread> threads;
+    for (int stage = 1; stage < numStages; ++stage) {
+        threads.emplace_back([&, stage]() {
+            for (uint64_t frame = 1; frame <= numFrames; ++frame) {
+                stages[stage - 1]->wait(frame);
+                frames[frame - 1] += stage;
+                stages[stage]->signal(frame);
+            }
+        });
+    }
+
+    for (uint64_t frame = 1; frame <= numFrames; ++frame) {
+        stages[0]->signal(frame);
+    }
+
+    EXPECT_TRUE(stages[numStages - 1]->wait(numFrames));
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (uint64_t frame = 0; frame < numFrames; ++frame) {
+        ASSERT_EQ((uint64_t)(1 + 2 + 3), frames[frame]);
+    }
+}
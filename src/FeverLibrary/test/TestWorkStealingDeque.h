@@ -0,0 +1,103 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <Fever/WorkStealingDeque.h>
+
+// Test that the owner pops the newest element and thieves steal the oldest
+TEST(WorkStealingDeque, PopNewestStealOldest) {
+    fv::WorkStealingDeque<int> deque(4);
+    EXPECT_TRUE(deque.empty());
+
+    for (int i = 1; i <= 3; ++i) {
+        deque.push(i);
+    }
+    EXPECT_FALSE(deque.empty());
+
+    int element = 0;
+    ASSERT_TRUE(deque.pop(&element));
+    EXPECT_EQ(3, element);
+    ASSERT_TRUE(deque.steal(&element));
+    EXPECT_EQ(1, element);
+    ASSERT_TRUE(deque.pop(&element));
+    EXPECT_EQ(2, element);
+
+    EXPECT_FALSE(deque.pop(&element));
+    EXPECT_FALSE(deque.steal(&element));
+    EXPECT_TRUE(deque.empty());
+}
+
+// Test that the deque grows past its capacity, keeping the order of elements
+// that wrapped around the ring
+TEST(WorkStealingDeque, Grows) {
+    fv::WorkStealingDeque<int> deque(2);
+
+    // Move the top along so the elements wrap before growing
+    int element = 0;
+    deque.push(-1);
+    ASSERT_TRUE(deque.steal(&element));
+
+    for (int i = 0; i < 100; ++i) {
+        deque.push(i);
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(deque.steal(&element));
+        EXPECT_EQ(i, element);
+    }
+    for (int i = 99; i >= 50; --i) {
+        ASSERT_TRUE(deque.pop(&element));
+        EXPECT_EQ(i, element);
+    }
+    EXPECT_TRUE(deque.empty());
+}
+
+// Test that with thieves racing the owner, every element is taken exactly once
+TEST(WorkStealingDeque, ConcurrentStealsTakeEachElementOnce) {
+    const int NUM_ELEMENTS = 100000;
+    const int NUM_THIEVES  = 3;
+
+    fv::WorkStealingDeque<int> deque(16);
+    std::vector<std::atomic<int>> taken(NUM_ELEMENTS);
+    for (std::atomic<int> &count : taken) {
+        count.store(0);
+    }
+    std::atomic<int> numTaken(0);
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < NUM_THIEVES; ++i) {
+        thieves.emplace_back([&]() {
+            int element = 0;
+            while (numTaken.load() < NUM_ELEMENTS) {
+                if (deque.steal(&element)) {
+                    ++taken[element];
+                    ++numTaken;
+                }
+            }
+        });
+    }
+
+    // Pop now and again, so the owner also races for the last element
+    int element = 0;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        deque.push(i);
+
+        if (i % 3 == 0 && deque.pop(&element)) {
+            ++taken[element];
+            ++numTaken;
+        }
+    }
+    while (deque.pop(&element)) {
+        ++taken[element];
+        ++numTaken;
+    }
+
+    for (std::thread &thief : thieves) {
+        thief.join();
+    }
+
+    EXPECT_EQ(NUM_ELEMENTS, numTaken.load());
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        EXPECT_EQ(1, taken[i].load()) << "element " << i;
+    }
+}
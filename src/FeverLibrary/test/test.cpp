@@ -1,8 +1,30 @@
 #include <gtest/gtest.h>
 
+#include "AllocationCounter.h"
+
 TEST(Test, One) { EXPECT_EQ(1, 1); }
 
 #include "TestHandle.h"
+#include "TestCommandStream.h"
+#include "TestBindingCache.h"
+#include "TestBindingTable.h"
+#include "TestConcurrentHandleDataStore.h"
+#include "TestDeferredDestructionQueue.h"
+#include "TestSerialTracker.h"
+#include "TestFence.h"
+#include "TestPagedPersistentHandleDataStore.h"
+#include "TestPackedHandleDataStore.h"
+#include "TestRenderQueue.h"
+#include "TestRingAllocator.h"
+#include "TestTimelineSemaphore.h"
+#include "TestSubmitRing.h"
+#include "TestSubmitThread.h"
+#include "TestWorkStealingDeque.h"
+#include "TestJobSystem.h"
+#include "TestIndirectDrawRecords.h"
+#include "TestDescriptorSetBinds.h"
+#include "TestFixedHandleDataStore.h"
+#include "TestFramesInFlight.h"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
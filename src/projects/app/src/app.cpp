@@ -13,6 +13,7 @@
  *===----------------------------------------------------------------------===*/
 #include <array>
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -39,6 +40,8 @@
 #include <Fever/Fever.h>
 #include <Fever/FeverPlatform.h>
 #include <Fever/FeverSurfaceAcquisition.h>
+#include <Fever/FramesInFlight.h>
+#include <Fever/RingAllocator.h>
 
 struct Vertex {
     glm::vec3 pos;
@@ -152,7 +155,8 @@ class HelloTriangleApplication {
   public:
     HelloTriangleApplication(SDL_Window *windowPtr)
         : window(windowPtr), outputWidth(0), outputHeight(0),
-          commandBuffer(FV_NULL_HANDLE) {}
+          uniformRing(UNIFORM_RING_SIZE, frames.size()),
+          uniformData(nullptr) {}
 
     ~HelloTriangleApplication() {
         // Clean up window if it hasn't already been cleaned up
@@ -184,8 +188,9 @@ class HelloTriangleApplication {
         createIndexBuffer();
         createUniformBuffer();
         writeDescriptorSet();
-        createCommandBuffer();
+        createCommandBuffers();
         createSemaphores();
+        createFrames();
     }
 
     void createRenderPass() {
@@ -271,7 +276,6 @@ class HelloTriangleApplication {
         createRenderPass();
         createGraphicsPipeline();
         createFramebuffer();
-        createCommandBuffer();
     }
 
     void loadModel() {
@@ -285,30 +289,60 @@ class HelloTriangleApplication {
             throw std::runtime_error(err);
         }
 
-        std::unordered_map<Vertex, uint32_t> uniqueVertices = {};
-
+        std::vector<tinyobj::index_t> meshIndices;
         for (const auto &shape : shapes) {
-            for (const auto &index : shape.mesh.indices) {
-                Vertex vertex = {};
+            meshIndices.insert(meshIndices.end(), shape.mesh.indices.begin(),
+                               shape.mesh.indices.end());
+        }
+
+        // Build a vertex per index on Fever's job system, then weld the
+        // duplicates
+        struct VertexBuild {
+            const tinyobj::attrib_t *attrib;
+            const tinyobj::index_t *indices;
+            Vertex *vertices;
+        };
 
-                vertex.pos = {attrib.vertices[3 * index.vertex_index + 0],
-                              attrib.vertices[3 * index.vertex_index + 1],
-                              attrib.vertices[3 * index.vertex_index + 2]};
+        std::vector<Vertex> meshVertices(meshIndices.size());
+        VertexBuild vertexBuild = {&attrib, meshIndices.data(),
+                                   meshVertices.data()};
+
+        const FvParallelForFunction buildVertices = [](void *userData,
+                                                       uint32_t begin,
+                                                       uint32_t end) {
+            const VertexBuild &build        = *(const VertexBuild *)userData;
+            const tinyobj::attrib_t &source = *build.attrib;
+
+            for (uint32_t i = begin; i < end; ++i) {
+                const tinyobj::index_t &index = build.indices[i];
+                Vertex &vertex                = build.vertices[i];
+
+                vertex.pos = {source.vertices[3 * index.vertex_index + 0],
+                              source.vertices[3 * index.vertex_index + 1],
+                              source.vertices[3 * index.vertex_index + 2]};
 
                 vertex.texCoord = {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+                    source.texcoords[2 * index.texcoord_index + 0],
+                    1.0f - source.texcoords[2 * index.texcoord_index + 1]};
 
                 vertex.color = {1.0f, 1.0f, 1.0f};
+            }
+        };
 
-                if (uniqueVertices.count(vertex) == 0) {
-                    uniqueVertices[vertex] =
-                        static_cast<uint32_t>(vertices.size());
-                    vertices.push_back(vertex);
-                }
+        if (fvParallelFor(static_cast<uint32_t>(meshIndices.size()), 4096,
+                          buildVertices, &vertexBuild) != FV_RESULT_SUCCESS) {
+            throw std::runtime_error("Failed to build model vertices!");
+        }
+
+        std::unordered_map<Vertex, uint32_t> uniqueVertices = {};
 
-                indices.push_back(uniqueVertices[vertex]);
+        for (const Vertex &vertex : meshVertices) {
+            if (uniqueVertices.count(vertex) == 0) {
+                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(vertex);
             }
+
+            indices.push_back(uniqueVertices[vertex]);
         }
     }
 
@@ -337,8 +371,10 @@ class HelloTriangleApplication {
     }
 
     void createUniformBuffer() {
+        // One buffer holding the uniforms of every frame in flight, each frame
+        // writes its own region of it, see updateUniformBuffer
         FvBufferCreateInfo bufferInfo = {};
-        bufferInfo.size               = sizeof(UniformBufferObject);
+        bufferInfo.size               = UNIFORM_RING_SIZE;
         bufferInfo.usage              = FV_BUFFER_USAGE_INDEX_BUFFER;
         bufferInfo.data = nullptr; // Add data in updateUniformBuffer
 
@@ -346,6 +382,11 @@ class HelloTriangleApplication {
             FV_RESULT_SUCCESS) {
             throw std::runtime_error("Failed to create vertex buffer!");
         }
+
+        if (fvBufferMap(uniformBuffer, (void **)&uniformData) !=
+            FV_RESULT_SUCCESS) {
+            throw std::runtime_error("Failed to map uniform buffer!");
+        }
     }
 
     void writeDescriptorSet() {
@@ -392,7 +433,8 @@ class HelloTriangleApplication {
         descriptorWrites[0].dstSet          = descriptorSet;
         descriptorWrites[0].dstBinding      = uniformBufferBindingPoint;
         descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType  = FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptorWrites[0].descriptorType =
+            FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         descriptorWrites[0].descriptorCount = 1;
         descriptorWrites[0].bufferInfo      = &bufferInfo;
 
@@ -408,7 +450,12 @@ class HelloTriangleApplication {
                                descriptorWrites.data());
     }
 
-    void updateUniformBuffer() {
+    /**
+     * Write this frame's uniforms to its region of the uniform buffer.
+     *
+     * \return Offset of the uniforms in the buffer.
+     */
+    uint32_t updateUniformBuffer() {
         static auto startTime = std::chrono::high_resolution_clock::now();
 
         auto currentTime = std::chrono::high_resolution_clock::now();
@@ -427,7 +474,21 @@ class HelloTriangleApplication {
             glm::perspective(glm::radians(45.0f),
                              outputWidth / (float)outputHeight, 0.1f, 10.0f);
 
-        fvBufferReplaceData(uniformBuffer, &ubo, sizeof(ubo));
+        // The GPU may still be reading the uniforms of earlier frames, write
+        // to a region no frame in flight uses rather than over them
+        FvSize offset = 0;
+        if (!uniformRing.allocate(sizeof(ubo), &offset)) {
+            throw std::runtime_error("Out of uniform buffer space!");
+        }
+
+        memcpy(uniformData + offset, &ubo, sizeof(ubo));
+
+        FvBufferRange range = {};
+        range.offset        = offset;
+        range.size          = sizeof(ubo);
+        fvBufferFlushRanges(uniformBuffer, 1, &range);
+
+        return (uint32_t)offset;
     }
 
     void createFramebuffer() {
@@ -516,17 +577,27 @@ class HelloTriangleApplication {
         }
     }
 
-    void createCommandBuffer() {
-        // If a command buffer already exists, free it
-        if (commandBuffer != FV_NULL_HANDLE) {
-            fvCommandBufferDestroy(commandBuffer, commandPool);
+    void createCommandBuffers() {
+        for (uint32_t i = 0; i < frames.size(); ++i) {
+            if (fvCommandBufferCreate(&frames.getFrame(i), commandPool) !=
+                FV_RESULT_SUCCESS) {
+                throw std::runtime_error("Failed to create command buffer!");
+            }
         }
+    }
 
-        if (fvCommandBufferCreate(&commandBuffer, commandPool) !=
-            FV_RESULT_SUCCESS) {
-            throw std::runtime_error("Failed to create command buffer!");
+    void createFrames() {
+        if (frames.init() != FV_RESULT_SUCCESS) {
+            throw std::runtime_error("Failed to create frame fences!");
         }
+    }
 
+    /**
+     * Record the frame's command buffer, reading the uniforms at the given
+     * offset in the uniform buffer.
+     */
+    void recordCommandBuffer(FvCommandBuffer commandBuffer,
+                             uint32_t uniformOffset) {
         fvCommandBufferBegin(commandBuffer);
 
         FvRenderPassBeginInfo renderPassInfo = {};
@@ -553,7 +624,7 @@ class HelloTriangleApplication {
                                  FV_INDEX_TYPE_UINT32);
 
             fvCmdBindDescriptorSets(commandBuffer, pipelineLayout, 0, 1,
-                                    &descriptorSet);
+                                    &descriptorSet, 1, &uniformOffset);
 
             // fvCmdDraw(commandBuffer, vertices.size(), 1, 0, 0);
             fvCmdDrawIndexed(commandBuffer, indices.size(), 1, 0, 0, 0);
@@ -569,9 +640,10 @@ class HelloTriangleApplication {
     void createDescriptorSet() {
         FvDescriptorInfo uboLayoutBinding = {};
         uboLayoutBinding.binding          = 1;
-        uboLayoutBinding.descriptorType   = FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        uboLayoutBinding.descriptorCount  = 1;
-        uboLayoutBinding.stageFlags       = FV_SHADER_STAGE_VERTEX;
+        uboLayoutBinding.descriptorType =
+            FV_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        uboLayoutBinding.descriptorCount = 1;
+        uboLayoutBinding.stageFlags      = FV_SHADER_STAGE_VERTEX;
 
         FvDescriptorInfo samplerLayoutBinding = {};
         samplerLayoutBinding.binding          = 0;
@@ -734,12 +806,22 @@ class HelloTriangleApplication {
     }
 
     void drawFrame() {
+        // Wait until the GPU has finished with this frame slot's command
+        // buffer and uniforms
+        if (frames.beginFrame(FV_WAIT_FOREVER) != FV_RESULT_SUCCESS) {
+            throw std::runtime_error("Failed to begin frame!");
+        }
+        uniformRing.beginFrame(frames.getFrameIndex());
+
+        FvCommandBuffer commandBuffer = frames.getFrame();
+        recordCommandBuffer(commandBuffer, updateUniformBuffer());
+
         if (fvAcquireNextImage(swapchain, imageAvailableSemaphore) !=
             FV_RESULT_SUCCESS) {
             throw std::runtime_error("Failed to acquire image!");
         }
 
-        FvSubmitInfo submitInfo;
+        FvSubmitInfo submitInfo = {};
 
         FvSemaphore waitSemaphores[]  = {imageAvailableSemaphore};
         submitInfo.waitSemaphoreCount = 1;
@@ -752,7 +834,8 @@ class HelloTriangleApplication {
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.signalSemaphores     = signalSemaphores;
 
-        if (fvQueueSubmit(1, &submitInfo) != FV_RESULT_SUCCESS) {
+        if (fvQueueSubmit(1, &submitInfo, frames.getSubmitFence()) !=
+            FV_RESULT_SUCCESS) {
             throw std::runtime_error("Failed to submit draw command buffer!");
         }
 
@@ -795,13 +878,13 @@ class HelloTriangleApplication {
                 }
             }
 
-            updateUniformBuffer();
             drawFrame();
         }
 
         window = nullptr;
 
         fvDeviceWaitIdle();
+        fvBufferUnmap(uniformBuffer);
     }
 
     static std::vector<char> readFile(const std::string &filename) {
@@ -835,8 +918,8 @@ class HelloTriangleApplication {
     FDeleter<FvGraphicsPipeline> graphicsPipeline{fvGraphicsPipelineDestroy};
     FDeleter<FvFramebuffer> framebuffer{fvFramebufferDestroy};
     FDeleter<FvCommandPool> commandPool{fvCommandPoolDestroy};
-    // Resources of command buffer automatically freed
-    FvCommandBuffer commandBuffer;
+    // One command buffer per frame in flight, freed with the command pool
+    fv::FramesInFlight<FvCommandBuffer> frames;
     FDeleter<FvSwapchain> swapchain{fvDestroySwapchain};
     FvImage swapchainImage; // TODO: wrap in FDeleter?
     FDeleter<FvSemaphore> imageAvailableSemaphore{fvSemaphoreDestroy};
@@ -847,7 +930,12 @@ class HelloTriangleApplication {
     FDeleter<FvBuffer> vertexBuffer{fvBufferDestroy};
     FDeleter<FvBuffer> indexBuffer{fvBufferDestroy};
 
+    /** Bytes of uniforms all the frames in flight can write between them. */
+    static const FvSize UNIFORM_RING_SIZE = 64 * 1024;
+
     FDeleter<FvBuffer> uniformBuffer{fvBufferDestroy};
+    fv::RingAllocator uniformRing;
+    uint8_t *uniformData;
     FDeleter<FvDescriptorSet> descriptorSet{fvDescriptorSetDestroy};
     FDeleter<FvImage> textureImage{fvImageDestroy};
     FDeleter<FvSampler> textureSampler{fvSamplerDestroy};
@@ -895,7 +983,7 @@ int main(void) {
 #endif
 
         // Initialize Fever
-        FvInitInfo initInfo;
+        FvInitInfo initInfo = {};
         initInfo.surface = surface;
 
         if (fvInit(&initInfo) != FV_RESULT_SUCCESS) {
@@ -404,7 +404,7 @@ class HelloTriangleApplication {
                                  FV_INDEX_TYPE_UINT32);
 
             fvCmdBindDescriptorSets(commandBuffer, pipelineLayout, 0, 1,
-                                    &descriptorSet);
+                                    &descriptorSet, 0, nullptr);
 
             // fvCmdDraw(commandBuffer, vertices.size(), 1, 0, 0);
             fvCmdDrawIndexed(commandBuffer, indices.size(), 1, 0, 0, 0);
@@ -582,7 +582,7 @@ class HelloTriangleApplication {
             throw std::runtime_error("Failed to acquire image!");
         }
 
-        FvSubmitInfo submitInfo;
+        FvSubmitInfo submitInfo = {};
 
         FvSemaphore waitSemaphores[]  = {imageAvailableSemaphore};
         submitInfo.waitSemaphoreCount = 1;
@@ -595,7 +595,8 @@ class HelloTriangleApplication {
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.signalSemaphores     = signalSemaphores;
 
-        if (fvQueueSubmit(1, &submitInfo) != FV_RESULT_SUCCESS) {
+        if (fvQueueSubmit(1, &submitInfo, FV_NULL_HANDLE) !=
+            FV_RESULT_SUCCESS) {
             throw std::runtime_error("Failed to submit draw command buffer!");
         }
 
@@ -733,7 +734,7 @@ int main(void) {
 #endif
 
         // Initialize Fever
-        FvInitInfo initInfo;
+        FvInitInfo initInfo = {};
         initInfo.surface = surface;
 
         if (fvInit(&initInfo) != FV_RESULT_SUCCESS) {